@@ -1,10 +1,16 @@
 TEMPLATE = app
-CONFIG += console c++11
+CONFIG += console c++11 thread
 CONFIG -= app_bundle
 CONFIG -= qt
 
 SOURCES += main.cpp \
-    fbullcowgame.cpp
+    fbullcowgame.cpp \
+    fbullcowsolver.cpp \
+    fcandidateset.cpp \
+    fwordstore.cpp
 
 HEADERS += \
-    fbullcowgame.h
+    fbullcowgame.h \
+    fbullcowsolver.h \
+    fcandidateset.h \
+    fwordstore.h
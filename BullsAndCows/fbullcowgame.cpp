@@ -1,18 +1,39 @@
 #include "fbullcowgame.h"
-#include <map>
+#include "fwordstore.h"
+#include <algorithm>
+#include <bitset>
+#include <iterator>
 
 // to make syntax Unreal friendly
-#define TMap std::map
 using int32 = int;
 
+namespace {
+/**
+ * @brief LetterBit
+ * @param Letter
+ * @return bit of the letter (case insensitive) in a 32-bit letter mask,
+ * 0 for characters which are not latin letters
+ */
+inline uint32 LetterBit(char Letter) {
+  const char Lower = Letter | 0x20; // ASCII upper to lower case
+  return ('a' <= Lower && Lower <= 'z') ? (uint32(1) << (Lower - 'a')) : 0;
+}
+
+// max tries indexed by hidden word length, 0 for unsupported lengths
+constexpr int32 WORD_LENGTH_TO_MAX_TRIES[] = {0, 0, 0, 4, 6, 9, 13, 16, 20};
+constexpr int32 MAX_TRIES_TABLE_SIZE =
+    sizeof(WORD_LENGTH_TO_MAX_TRIES) / sizeof(WORD_LENGTH_TO_MAX_TRIES[0]);
+} // namespace
+
 /**
  * @brief FBullCowGame::GetMaxTries
  * @return
  */
 int32 FBullCowGame::GetMaxTries() const {
-  TMap<int32, int32> WordLengthToMaxTries{{3, 4},  {4, 6},  {5, 9},
-                                          {6, 13}, {7, 16}, {8, 20}};
-  return WordLengthToMaxTries[MyHiddenWord.length()];
+  const size_t WordLength = MyHiddenWord.length();
+  return (WordLength < MAX_TRIES_TABLE_SIZE)
+             ? WORD_LENGTH_TO_MAX_TRIES[WordLength]
+             : 0;
 }
 
 /**
@@ -38,7 +59,10 @@ bool FBullCowGame::IsGameWon() const { return bIsGameWon; }
 /**
  * @brief FBullCowGame::FBullCowGame
  */
-FBullCowGame::FBullCowGame() { Reset(); }
+FBullCowGame::FBullCowGame()
+    : MyWordStore(nullptr), MyWordLength(0), MyRandom(std::random_device()()) {
+  Reset();
+}
 
 /**
  * @brief FBullCowGame::~FBullCowGame
@@ -52,10 +76,39 @@ FBullCowGame::~FBullCowGame() {
  * @brief FBullCowGame::Reset
  */
 void FBullCowGame::Reset() {
-  bIsGameWon = false;
+  const int32 WordCount =
+      MyWordStore ? MyWordStore->GetWordCount(MyWordLength) : 0;
+  if (WordCount > 0) {
+    // O(1) pick, store words are already validated isograms
+    std::uniform_int_distribution<int32> Pick(0, WordCount - 1);
+    Reset(MyWordStore->GetWord(MyWordLength, Pick(MyRandom)));
+    return;
+  }
+
   const FString HIDDEN_WORD = "planet"; // this must be an isogram (otherwise
                                         // the game will be very hard)
-  MyHiddenWord = HIDDEN_WORD;
+  Reset(HIDDEN_WORD);
+}
+
+/**
+ * @brief FBullCowGame::SetWordStore
+ * @param WordStore must outlive the game, nullptr restores default word
+ * @param WordLength
+ */
+void FBullCowGame::SetWordStore(const FWordStore *WordStore,
+                                int32 WordLength) {
+  MyWordStore = WordStore;
+  MyWordLength = WordLength;
+}
+
+/**
+ * @brief FBullCowGame::Reset
+ * @param HiddenWord word to guess in the next game
+ */
+void FBullCowGame::Reset(const FString &HiddenWord) {
+  bIsGameWon = false;
+  MyHiddenWord = HiddenWord;
+  BuildLetterPositions();
 
   MyCurrentTry = 1;
 
@@ -67,7 +120,7 @@ void FBullCowGame::Reset() {
  * @param Guess
  * @return EGuessStatus
  */
-EGuessStatus FBullCowGame::CheckGuessValidity(FString Guess) const {
+EGuessStatus FBullCowGame::CheckGuessValidity(const FString &Guess) const {
   // guess has wrong length
   if (Guess.length() != MyHiddenWord.length())
     return EGuessStatus::Wrong_Length;
@@ -87,26 +140,11 @@ EGuessStatus FBullCowGame::CheckGuessValidity(FString Guess) const {
  * @param Guess
  * @return? counts # of Tries  and compares the letters
  */
-FBullCowCount FBullCowGame::SubbmitValidGuees(FString Guess) {
+FBullCowCount FBullCowGame::SubbmitValidGuees(const FString &Guess) {
   MyCurrentTry++;
-  FBullCowCount BullCowCount;
-  int32 WordLength = MyHiddenWord.length();
-  int32 GuessLength = Guess.length();
+  FBullCowCount BullCowCount = ScoreGuess(Guess);
 
-  // loop through all letters in the hidden word
-  for (int32 MHWChar = 0; MHWChar < WordLength; ++MHWChar) {
-    // compare against the guess
-    for (int32 GChar = 0; GChar < GuessLength; ++GChar) {
-      // if the match
-      if (MyHiddenWord[MHWChar] == Guess[GChar]) {
-        if (MHWChar == GChar)   // if they are in the same place
-          BullCowCount.Bulls++; // increment bulls
-        else
-          BullCowCount.Cows++; // must be cows
-      }
-    }
-  }
-  if (WordLength == BullCowCount.Bulls) {
+  if (GetMyHiddenWordLength() == BullCowCount.Bulls) {
     bIsGameWon = true;
   } else {
     bIsGameWon = false;
@@ -114,30 +152,85 @@ FBullCowCount FBullCowGame::SubbmitValidGuees(FString Guess) {
   return BullCowCount;
 }
 
+/**
+ * @brief FBullCowGame::ScoreGuess
+ * @param Guess
+ * @return bulls and cows of the guess, single pass over the guess
+ */
+FBullCowCount FBullCowGame::ScoreGuess(const FString &Guess) const {
+  FBullCowCount BullCowCount;
+  int32 GuessLength = Guess.length();
+
+  // look up every guess letter in hidden word letter positions
+  for (int32 GChar = 0; GChar < GuessLength; ++GChar) {
+    const int32 Letter = Guess[GChar] - 'a';
+    if (Letter < 0 || 26 <= Letter)
+      continue; // not in hidden word
+    const int32 MHWChar = MyLetterPosition[Letter];
+    if (MHWChar == GChar)   // if they are in the same place
+      BullCowCount.Bulls++; // increment bulls
+    else if (MHWChar >= 0)
+      BullCowCount.Cows++; // must be cows
+  }
+  return BullCowCount;
+}
+
+/**
+ * @brief FBullCowGame::ScoreMany
+ * @param Guesses
+ * @param Count
+ * @param OutCounts bulls and cows of every guess
+ */
+void FBullCowGame::ScoreMany(const FString Guesses[], int32 Count,
+                             FBullCowCount OutCounts[]) const {
+  for (int32 Idx = 0; Idx < Count; ++Idx) {
+    OutCounts[Idx] = ScoreGuess(Guesses[Idx]);
+  }
+}
+
+/**
+ * @brief FBullCowGame::BuildLetterPositions
+ * hidden word is an isogram, so every letter has at most one position
+ */
+void FBullCowGame::BuildLetterPositions() {
+  std::fill(std::begin(MyLetterPosition), std::end(MyLetterPosition), -1);
+
+  int32 WordLength = MyHiddenWord.length();
+  for (int32 MHWChar = 0; MHWChar < WordLength; ++MHWChar) {
+    const int32 Letter = MyHiddenWord[MHWChar] - 'a';
+    if (0 <= Letter && Letter < 26)
+      MyLetterPosition[Letter] = MHWChar;
+  }
+}
+
 /**
  * @brief FBullCowGame::IsIsogram
  * @param Word
  * @return bool
  */
-bool FBullCowGame::IsIsogram(FString Word) const {
-  // treat 0 and 1 letter strings as isograms
-  if (Word.length() <= 1) {
-    return true;
-  }
-  // setup our map
-  TMap<char, bool> LetterSeen;
+bool FBullCowGame::IsIsogram(const FString &Word) {
+  // letters seen so far, one bit per letter (no allocation)
+  uint32 LetterSeen = 0;
+  // other characters (digits, spaces, ...) seen so far, repeating them is
+  // not an isogram either
+  std::bitset<256> OtherSeen;
 
-  // loop through all the letters of the word
+  // loop through all the letters of the word, mixed case is handled by
+  // LetterBit
   for (auto Letter : Word) {
-    Letter = tolower(Letter); // handle mixed case
-    // if the letter is in the map
-    if (LetterSeen[Letter]) {
-      return false;
-    }    // we do NOT have an isogram
-    else // otherwise
-    {
-      LetterSeen[Letter] = true; // add the letter to the map as seen
+    const uint32 Bit = LetterBit(Letter);
+    if (Bit == 0) {
+      const unsigned char Other = static_cast<unsigned char>(Letter);
+      if (OtherSeen[Other]) {
+        return false; // we do NOT have an isogram
+      }
+      OtherSeen[Other] = true;
+      continue;
+    }
+    if (LetterSeen & Bit) {
+      return false; // we do NOT have an isogram
     }
+    LetterSeen |= Bit;
   }
 
   return true;
@@ -148,11 +241,24 @@ bool FBullCowGame::IsIsogram(FString Word) const {
  * @param Word
  * @return
  */
-bool FBullCowGame::IsLowerCase(FString Word) const {
+bool FBullCowGame::IsLowerCase(const FString &Word) {
   for (auto Letter : Word) {
-    if (!islower(Letter)) { // if not lowercase letter
+    if (Letter < 'a' || 'z' < Letter) { // if not lowercase letter
       return false;
     }
   }
   return true;
 }
+
+/**
+ * @brief FBullCowGame::LetterMask
+ * @param Word
+ * @return letters of the word as 32-bit letter mask
+ */
+uint32 FBullCowGame::LetterMask(const FString &Word) {
+  uint32 Mask = 0;
+  for (auto Letter : Word) {
+    Mask |= LetterBit(Letter);
+  }
+  return Mask;
+}
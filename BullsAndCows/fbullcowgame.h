@@ -4,11 +4,16 @@
 
 #ifndef FBULLCOWGAME_H
 #define FBULLCOWGAME_H
+#include <cstdint>
+#include <random>
 #include <string>
 
 // to make syntax Unreal friendly
 using FString = std::string;
 using int32 = int;
+using uint32 = std::uint32_t;
+using int8 = std::int8_t;
+using uint8 = std::uint8_t;
 
 struct FBullCowCount
 {
@@ -16,6 +21,8 @@ struct FBullCowCount
     int32 Cows = 0;
 };
 
+class FWordStore;
+
 enum class EGuessStatus
 {
     Not_Valid,
@@ -31,20 +38,37 @@ public:
     FBullCowGame(); // c-tor
     ~FBullCowGame(); // d-tor
     void Reset();
+    void Reset(const FString &HiddenWord); // HiddenWord must be an isogram
+    // Reset() picks a random WordLength letter word from the store
+    void SetWordStore(const FWordStore *WordStore, int32 WordLength);
     int32 GetMaxTries() const;
     int32 GetCurrentTry() const;
     bool IsGameWon() const;
-    EGuessStatus CheckGuessValidity(FString) const;
+    EGuessStatus CheckGuessValidity(const FString &) const;
     int32 GetMyHiddenWordLength() const;
-    FBullCowCount SubbmitValidGuees(FString);
+    FBullCowCount SubbmitValidGuees(const FString &);
+
+    // scoring without changing game state (no try is counted)
+    FBullCowCount ScoreGuess(const FString &) const;
+    void ScoreMany(const FString Guesses[], int32 Count,
+                   FBullCowCount OutCounts[]) const;
+
+    static bool IsIsogram(const FString &);
+    static bool IsLowerCase(const FString &);
+    // one bit per letter 'a'..'z' of the word, letters 'A'..'Z' included
+    static uint32 LetterMask(const FString &);
 
 private:
     // see constructor for initialization
     int32 MyCurrentTry;
     int32 MyMaxTries;
     FString MyHiddenWord;
-    bool IsIsogram(FString) const;
-    bool IsLowerCase(FString) const;
+    // position of each letter 'a'..'z' in hidden word, -1 if absent
+    int8 MyLetterPosition[26];
+    void BuildLetterPositions();
+    const FWordStore *MyWordStore;
+    int32 MyWordLength;
+    std::minstd_rand MyRandom;
     bool bIsGameWon;
 };
 
@@ -0,0 +1,201 @@
+#include "fbullcowsolver.h"
+#include "fwordstore.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+/**
+ * @brief FBullCowSolver::FBullCowSolver
+ * @param Dictionary
+ * @param Strategy
+ */
+FBullCowSolver::FBullCowSolver(const std::vector<FString> &Dictionary,
+                               ESolverStrategy Strategy)
+    : MyDictionary(&Dictionary), MyStrategy(Strategy) {
+  MyCandidates.Assign(Dictionary);
+  MyFirstGuess = BestGuess();
+}
+
+/**
+ * @brief FBullCowSolver::Reset
+ * every dictionary word is a candidate again
+ */
+void FBullCowSolver::Reset() { MyCandidates.Reset(); }
+
+/**
+ * @brief FBullCowSolver::GetNextGuess
+ * @return candidate word splitting remaining candidates best
+ */
+FString FBullCowSolver::GetNextGuess() {
+  if (!MyFirstGuess.empty() &&
+      size_t(MyCandidates.GetCount()) == MyDictionary->size()) {
+    return MyFirstGuess;
+  }
+  return BestGuess();
+}
+
+/**
+ * @brief FBullCowSolver::ApplyFeedback
+ * @param Guess
+ * @param BullCowCount answer for the guess
+ * keeps only candidates which would give the same answer
+ */
+void FBullCowSolver::ApplyFeedback(const FString &Guess,
+                                   FBullCowCount BullCowCount) {
+  MyCandidates.Filter(Guess, BullCowCount);
+}
+
+/**
+ * @brief FBullCowSolver::GetCandidateCount
+ * @return
+ */
+int32 FBullCowSolver::GetCandidateCount() const {
+  return MyCandidates.GetCount();
+}
+
+/**
+ * @brief FBullCowSolver::LoadDictionary
+ * @param Path word store or plain word list
+ * @param WordLength
+ * @return words which are valid guesses, sorted, duplicates removed
+ */
+std::vector<FString> FBullCowSolver::LoadDictionary(const FString &Path,
+                                                    int32 WordLength) {
+  FWordStore Store;
+  std::vector<FString> Words;
+
+  if (Store.Open(Path)) {
+    const int32 WordCount = Store.GetWordCount(WordLength);
+    Words.reserve(WordCount);
+    for (int32 Index = 0; Index < WordCount; ++Index) {
+      Words.push_back(Store.GetWord(WordLength, Index));
+    }
+  }
+  return Words;
+}
+
+/**
+ * @brief FBullCowSolver::SelfPlay
+ * @param Dictionary
+ * @param Strategy
+ * @param Threads
+ * @return summary of all games
+ */
+FSelfPlayResult FBullCowSolver::SelfPlay(const std::vector<FString> &Dictionary,
+                                         ESolverStrategy Strategy,
+                                         int32 Threads) {
+  FSelfPlayResult Result;
+  Result.Threads = std::max(Threads, 1);
+  const auto Start = std::chrono::steady_clock::now();
+
+  // first guess is shared, every thread gets its own copy of the solver
+  const FBullCowSolver Prototype(Dictionary, Strategy);
+  std::atomic<size_t> NextWord(0);
+  std::vector<FSelfPlayResult> Partial(Result.Threads);
+
+  auto Worker = [&](FSelfPlayResult &Out) {
+    FBullCowSolver Solver(Prototype);
+    FBullCowGame Game;
+
+    for (size_t Idx = NextWord++; Idx < Dictionary.size(); Idx = NextWord++) {
+      Game.Reset(Dictionary[Idx]);
+      Solver.Reset();
+      while (!Game.IsGameWon()) {
+        const FString Guess = Solver.GetNextGuess();
+        if (Guess.empty())
+          break; // hidden word is not in the dictionary
+        Solver.ApplyFeedback(Guess, Game.SubbmitValidGuees(Guess));
+      }
+
+      const int32 Tries = Game.GetCurrentTry() - 1;
+      Out.Games++;
+      Out.TotalTries += Tries;
+      Out.WorstTries = std::max(Out.WorstTries, Tries);
+      if (Tries > Game.GetMaxTries())
+        Out.Lost++;
+    }
+  };
+
+  std::vector<std::thread> Pool;
+  for (int32 Thread = 1; Thread < Result.Threads; ++Thread) {
+    Pool.emplace_back(Worker, std::ref(Partial[Thread]));
+  }
+  Worker(Partial[0]);
+  for (auto &Thread : Pool) {
+    Thread.join();
+  }
+
+  for (const auto &Out : Partial) {
+    Result.Games += Out.Games;
+    Result.TotalTries += Out.TotalTries;
+    Result.WorstTries = std::max(Result.WorstTries, Out.WorstTries);
+    Result.Lost += Out.Lost;
+  }
+  const std::chrono::duration<double> Elapsed =
+      std::chrono::steady_clock::now() - Start;
+  Result.Seconds = Elapsed.count();
+  return Result;
+}
+
+/**
+ * @brief FBullCowSolver::FeedbackIndex
+ * @param BullCowCount
+ * @return unique index of the answer
+ */
+int32 FBullCowSolver::FeedbackIndex(FBullCowCount BullCowCount) const {
+  const int32 WordLength = MyCandidates.GetWordLength();
+  return BullCowCount.Bulls * (WordLength + 1) + BullCowCount.Cows;
+}
+
+/**
+ * @brief FBullCowSolver::ScoreCandidates
+ * @param Guess
+ * bulls and cows are symmetric for isograms, so scoring every candidate
+ * against the guess as hidden word gives answers for the guess
+ */
+void FBullCowSolver::ScoreCandidates(const FString &Guess) {
+  MyScores.resize(MyCandidates.GetCount());
+  MyCandidates.Score(Guess, MyScores.data());
+}
+
+/**
+ * @brief FBullCowSolver::BestGuess
+ * @return candidate with the best split of candidates by answer
+ */
+FString FBullCowSolver::BestGuess() {
+  if (MyCandidates.GetCount() <= 2) {
+    return MyCandidates.GetCount() == 0 ? FString() : MyCandidates.GetWord(0);
+  }
+
+  // only candidates are tried, so every guess may still win
+  FString Best;
+  double BestCost = 0.0;
+
+  for (int32 Idx = 0; Idx < MyCandidates.GetCount(); ++Idx) {
+    const FString &Guess = MyCandidates.GetWord(Idx);
+    ScoreCandidates(Guess);
+
+    const int32 WordLength = Guess.length();
+    MyFeedbackGroups.assign((WordLength + 1) * (WordLength + 1), 0);
+    for (const FBullCowCount &Score : MyScores) {
+      MyFeedbackGroups[FeedbackIndex(Score)]++;
+    }
+
+    // lower is better for both strategies
+    double Cost = 0.0;
+    for (const int32 Group : MyFeedbackGroups) {
+      if (MyStrategy == ESolverStrategy::Minimax)
+        Cost = std::max(Cost, double(Group));
+      else if (Group > 0)
+        Cost += Group * std::log2(double(Group)); // entropy = log2 N - Cost/N
+    }
+
+    if (Best.empty() || Cost < BestCost) {
+      Best = Guess;
+      BestCost = Cost;
+    }
+  }
+  return Best;
+}
@@ -0,0 +1,60 @@
+/* Automated player of the game (no view code or user interaction)
+ * The solver keeps the dictionary words which are consistent with all
+ * bulls/cows answers so far and picks the guess splitting them best.
+*/
+
+#ifndef FBULLCOWSOLVER_H
+#define FBULLCOWSOLVER_H
+#include <vector>
+#include "fcandidateset.h"
+
+enum class ESolverStrategy
+{
+    Entropy, // maximize expected information of the answer
+    Minimax  // minimize the largest group of remaining candidates
+};
+
+struct FSelfPlayResult
+{
+    int32 Games = 0;
+    int32 Threads = 0;
+    int32 TotalTries = 0;
+    int32 WorstTries = 0;
+    int32 Lost = 0; // games needing more than GetMaxTries() tries
+    double Seconds = 0.0;
+};
+
+class FBullCowSolver
+{
+public:
+    // Dictionary must outlive the solver, all words of the same length
+    FBullCowSolver(const std::vector<FString> &Dictionary,
+                   ESolverStrategy Strategy);
+    void Reset();
+    FString GetNextGuess();
+    void ApplyFeedback(const FString &Guess, FBullCowCount BullCowCount);
+    int32 GetCandidateCount() const;
+
+    // lowercase isograms of WordLength letters from the word store (FWordStore)
+    static std::vector<FString> LoadDictionary(const FString &Path,
+                                               int32 WordLength);
+
+    // plays one game against every dictionary word, Threads in parallel
+    static FSelfPlayResult SelfPlay(const std::vector<FString> &Dictionary,
+                                    ESolverStrategy Strategy, int32 Threads);
+
+private:
+    int32 FeedbackIndex(FBullCowCount BullCowCount) const;
+    // score of the guess against every candidate (as hidden word)
+    void ScoreCandidates(const FString &Guess);
+    FString BestGuess();
+
+    const std::vector<FString> *MyDictionary;
+    ESolverStrategy MyStrategy;
+    FString MyFirstGuess; // depends only on dictionary, computed once
+    FCandidateSet MyCandidates;
+    std::vector<FBullCowCount> MyScores;
+    std::vector<int32> MyFeedbackGroups;
+};
+
+#endif // FBULLCOWSOLVER_H
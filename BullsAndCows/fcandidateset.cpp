@@ -0,0 +1,235 @@
+#include "fcandidateset.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+// candidates scored together, one byte lane each
+constexpr int32 BLOCK_SIZE = 16;
+constexpr int32 MAX_WORD_LENGTH = 26; // longest isogram
+
+/**
+ * @brief PaddedSize
+ * @param Count
+ * @return Count rounded up to whole blocks
+ */
+inline size_t PaddedSize(size_t Count) {
+  return (Count + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+}
+
+/**
+ * @brief BitCount
+ * @param Mask
+ * @return number of set bits
+ */
+inline uint32 BitCount(uint32 Mask) {
+  Mask = Mask - ((Mask >> 1) & 0x55555555);
+  Mask = (Mask & 0x33333333) + ((Mask >> 2) & 0x33333333);
+  Mask = (Mask + (Mask >> 4)) & 0x0f0f0f0f;
+  return (Mask * 0x01010101) >> 24;
+}
+
+#if defined(__SSE2__)
+/**
+ * @brief BitCount
+ * @param Masks
+ * @return number of set bits in every 32-bit lane (SWAR, SSE2 only)
+ */
+inline __m128i BitCount(__m128i Masks) {
+  const __m128i M1 = _mm_set1_epi32(0x55555555);
+  const __m128i M2 = _mm_set1_epi32(0x33333333);
+  const __m128i M4 = _mm_set1_epi32(0x0f0f0f0f);
+
+  Masks = _mm_sub_epi32(Masks, _mm_and_si128(_mm_srli_epi32(Masks, 1), M1));
+  Masks = _mm_add_epi32(_mm_and_si128(Masks, M2),
+                        _mm_and_si128(_mm_srli_epi32(Masks, 2), M2));
+  Masks = _mm_and_si128(_mm_add_epi32(Masks, _mm_srli_epi32(Masks, 4)), M4);
+  Masks = _mm_add_epi32(Masks, _mm_srli_epi32(Masks, 8));
+  Masks = _mm_add_epi32(Masks, _mm_srli_epi32(Masks, 16));
+  return _mm_and_si128(Masks, _mm_set1_epi32(0x3f));
+}
+#endif
+} // namespace
+
+/**
+ * @brief FCandidateSet::FCandidateSet
+ */
+FCandidateSet::FCandidateSet()
+    : MyWords(nullptr), MyWordLength(0), MyCount(0) {}
+
+/**
+ * @brief FCandidateSet::Assign
+ * @param Words
+ */
+void FCandidateSet::Assign(const std::vector<FString> &Words) {
+  MyWords = &Words;
+  MyWordLength = Words.empty() ? 0 : Words.front().length();
+
+  const size_t Padded = PaddedSize(Words.size());
+  MyAllMasks.assign(Padded, 0);
+  MyAllLetters.assign(MyWordLength, std::vector<uint8>(Padded, 0));
+  for (size_t Idx = 0; Idx < Words.size(); ++Idx) {
+    MyAllMasks[Idx] = FBullCowGame::LetterMask(Words[Idx]);
+    for (int32 Pos = 0; Pos < MyWordLength; ++Pos) {
+      MyAllLetters[Pos][Idx] = Words[Idx][Pos];
+    }
+  }
+  MyBulls.assign(Padded, 0);
+  MyCommon.assign(Padded, 0);
+  MyKept.assign(Padded + BLOCK_SIZE, 0);
+  Reset();
+}
+
+/**
+ * @brief FCandidateSet::Reset
+ */
+void FCandidateSet::Reset() {
+  MyCount = MyWords ? MyWords->size() : 0;
+  MyMasks = MyAllMasks;
+  MyLetters = MyAllLetters;
+  MyIndex.resize(MyCount);
+  for (int32 Idx = 0; Idx < MyCount; ++Idx) {
+    MyIndex[Idx] = Idx;
+  }
+}
+
+/**
+ * @brief FCandidateSet::GetCount
+ * @return
+ */
+int32 FCandidateSet::GetCount() const { return MyCount; }
+
+/**
+ * @brief FCandidateSet::GetWordLength
+ * @return
+ */
+int32 FCandidateSet::GetWordLength() const { return MyWordLength; }
+
+/**
+ * @brief FCandidateSet::GetWord
+ * @param Index from range [0, GetCount())
+ * @return
+ */
+const FString &FCandidateSet::GetWord(int32 Index) const {
+  return (*MyWords)[MyIndex[Index]];
+}
+
+/**
+ * @brief FCandidateSet::Score
+ * @param Guess isogram of GetWordLength() letters
+ * @param OutCounts
+ */
+void FCandidateSet::Score(const FString &Guess, FBullCowCount OutCounts[]) {
+  Count(Guess);
+  for (int32 Idx = 0; Idx < MyCount; ++Idx) {
+    OutCounts[Idx].Bulls = MyBulls[Idx];
+    OutCounts[Idx].Cows = MyCommon[Idx] - MyBulls[Idx];
+  }
+}
+
+/**
+ * @brief FCandidateSet::Filter
+ * @param Guess isogram of GetWordLength() letters
+ * @param BullCowCount answer for the guess
+ */
+void FCandidateSet::Filter(const FString &Guess, FBullCowCount BullCowCount) {
+  Count(Guess);
+
+  const uint8 Bulls = BullCowCount.Bulls;
+  const uint8 Common = BullCowCount.Bulls + BullCowCount.Cows;
+  int32 Kept = 0;
+  int32 Idx = 0;
+#if defined(__SSE2__)
+  const __m128i WantBulls = _mm_set1_epi8(Bulls);
+  const __m128i WantCommon = _mm_set1_epi8(Common);
+  for (; Idx + BLOCK_SIZE <= MyCount; Idx += BLOCK_SIZE) {
+    const __m128i Match = _mm_and_si128(
+        _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)&MyBulls[Idx]),
+                       WantBulls),
+        _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)&MyCommon[Idx]),
+                       WantCommon));
+    // branchless, every lane is written and kept ones advance the end
+    const uint32 Bits = _mm_movemask_epi8(Match);
+    for (int32 Bit = 0; Bit < BLOCK_SIZE; ++Bit) {
+      MyKept[Kept] = Idx + Bit;
+      Kept += (Bits >> Bit) & 1;
+    }
+  }
+#endif
+  for (; Idx < MyCount; ++Idx) {
+    MyKept[Kept] = Idx;
+    Kept += MyBulls[Idx] == Bulls && MyCommon[Idx] == Common;
+  }
+
+  // column by column, kept candidates only move to lower indices
+  Compact(MyMasks, Kept);
+  for (auto &Letters : MyLetters) {
+    Compact(Letters, Kept);
+  }
+  Compact(MyIndex, Kept);
+  MyCount = Kept;
+}
+
+/**
+ * @brief FCandidateSet::Count
+ * @param Guess
+ * for isograms common letters are bulls + cows, so no per letter search
+ * is needed
+ */
+void FCandidateSet::Count(const FString &Guess) {
+  const uint32 GuessMask = FBullCowGame::LetterMask(Guess);
+  int32 Idx = 0;
+#if defined(__SSE2__)
+  // columns are padded, the last block may score stale entries
+  const __m128i GuessMasks = _mm_set1_epi32(GuessMask);
+  const uint8 *Columns[MAX_WORD_LENGTH];
+  __m128i GuessLetters[MAX_WORD_LENGTH];
+  for (int32 Pos = 0; Pos < MyWordLength; ++Pos) {
+    Columns[Pos] = MyLetters[Pos].data();
+    GuessLetters[Pos] = _mm_set1_epi8(Guess[Pos]);
+  }
+  for (; Idx < MyCount; Idx += BLOCK_SIZE) {
+    __m128i Bulls = _mm_setzero_si128();
+    for (int32 Pos = 0; Pos < MyWordLength; ++Pos) {
+      const __m128i Letters =
+          _mm_loadu_si128((const __m128i *)(Columns[Pos] + Idx));
+      // equal letter is -1, subtracting counts it
+      Bulls = _mm_sub_epi8(Bulls, _mm_cmpeq_epi8(Letters, GuessLetters[Pos]));
+    }
+    _mm_storeu_si128((__m128i *)&MyBulls[Idx], Bulls);
+
+    __m128i Common[4];
+    for (int32 Part = 0; Part < 4; ++Part) {
+      const __m128i Masks =
+          _mm_loadu_si128((const __m128i *)&MyMasks[Idx + 4 * Part]);
+      Common[Part] = BitCount(_mm_and_si128(Masks, GuessMasks));
+    }
+    _mm_storeu_si128(
+        (__m128i *)&MyCommon[Idx],
+        _mm_packus_epi16(_mm_packs_epi32(Common[0], Common[1]),
+                         _mm_packs_epi32(Common[2], Common[3])));
+  }
+#else
+  for (; Idx < MyCount; ++Idx) {
+    uint8 Bulls = 0;
+    for (int32 Pos = 0; Pos < MyWordLength; ++Pos) {
+      Bulls += MyLetters[Pos][Idx] == uint8(Guess[Pos]);
+    }
+    MyBulls[Idx] = Bulls;
+    MyCommon[Idx] = BitCount(MyMasks[Idx] & GuessMask);
+  }
+#endif
+}
+
+/**
+ * @brief FCandidateSet::Compact
+ * @param Column
+ * @param Kept number of kept candidates listed in MyKept
+ */
+template <typename T>
+void FCandidateSet::Compact(std::vector<T> &Column, int32 Kept) const {
+  for (int32 Idx = 0; Idx < Kept; ++Idx) {
+    Column[Idx] = Column[MyKept[Idx]];
+  }
+}
@@ -0,0 +1,52 @@
+/* Words still consistent with bulls/cows answers (no view code or user interaction)
+ * Every word is kept as a 26-bit letter mask and one letter byte per position,
+ * stored column-wise so that whole blocks of candidates are scored with SIMD
+ * compares (bulls) and a bit count of common letters (bulls + cows).
+*/
+
+#ifndef FCANDIDATESET_H
+#define FCANDIDATESET_H
+#include <vector>
+#include "fbullcowgame.h"
+
+class FCandidateSet
+{
+public:
+    FCandidateSet(); // c-tor
+
+    // Words must outlive the set, all isograms of the same length
+    void Assign(const std::vector<FString> &Words);
+    void Reset(); // every assigned word is a candidate again
+
+    int32 GetCount() const;
+    int32 GetWordLength() const;
+    const FString &GetWord(int32 Index) const;
+
+    // bulls and cows of the guess against every candidate (as hidden word),
+    // OutCounts must have room for GetCount() answers
+    void Score(const FString &Guess, FBullCowCount OutCounts[]);
+    // keeps only candidates which give the same answer for the guess
+    void Filter(const FString &Guess, FBullCowCount BullCowCount);
+
+private:
+    // per candidate bulls and common letters into MyBulls and MyCommon
+    void Count(const FString &Guess);
+    template <typename T>
+    void Compact(std::vector<T> &Column, int32 Kept) const;
+
+    const std::vector<FString> *MyWords;
+    int32 MyWordLength;
+    int32 MyCount;
+    // assigned words, candidates are compacted copy of them; all columns
+    // are padded to a whole SIMD block
+    std::vector<uint32> MyAllMasks;
+    std::vector<std::vector<uint8>> MyAllLetters; // [position][word]
+    std::vector<uint32> MyMasks;
+    std::vector<std::vector<uint8>> MyLetters;
+    std::vector<int32> MyIndex; // candidate to word index
+    std::vector<uint8> MyBulls;
+    std::vector<uint8> MyCommon;
+    std::vector<int32> MyKept; // indices of candidates passing the filter
+};
+
+#endif // FCANDIDATESET_H
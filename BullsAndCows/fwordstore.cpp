@@ -0,0 +1,209 @@
+#include "fwordstore.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define WORDSTORE_MMAP 1
+#endif
+
+namespace {
+const char STORE_MAGIC[4] = {'B', 'C', 'W', 'S'};
+const uint32 STORE_VERSION = 1;
+} // namespace
+
+constexpr int32 FWordStoreHeader::MAX_WORD_LENGTH;
+
+/**
+ * @brief FWordStore::FWordStore
+ */
+FWordStore::FWordStore() : MyData(nullptr), MySize(0), bIsMapped(false) {}
+
+/**
+ * @brief FWordStore::~FWordStore
+ */
+FWordStore::~FWordStore() { Close(); }
+
+/**
+ * @brief FWordStore::Open
+ * @param Path store file or plain word list
+ * @return true if words are available
+ */
+bool FWordStore::Open(const FString &Path) {
+  Close();
+
+  if (Map(Path)) {
+    return true;
+  }
+
+  // not a store file, convert word list in memory
+  MyImage = BuildImage(Path);
+  if (MyImage.empty()) {
+    return false;
+  }
+  MyData = MyImage.data();
+  MySize = MyImage.size();
+  return true;
+}
+
+/**
+ * @brief FWordStore::Close
+ */
+void FWordStore::Close() {
+#ifdef WORDSTORE_MMAP
+  if (bIsMapped) {
+    munmap(const_cast<char *>(MyData), MySize);
+  }
+#endif
+  MyData = nullptr;
+  MySize = 0;
+  bIsMapped = false;
+  MyImage.clear();
+}
+
+/**
+ * @brief FWordStore::GetWordCount
+ * @param WordLength
+ * @return number of words of given length
+ */
+int32 FWordStore::GetWordCount(int32 WordLength) const {
+  if (MyData == nullptr || WordLength < 0 ||
+      WordLength > FWordStoreHeader::MAX_WORD_LENGTH) {
+    return 0;
+  }
+  return Header().Buckets[WordLength].Count;
+}
+
+/**
+ * @brief FWordStore::GetWord
+ * @param WordLength
+ * @param Index from range [0, GetWordCount(WordLength))
+ * @return word, located without any search
+ */
+FString FWordStore::GetWord(int32 WordLength, int32 Index) const {
+  const auto &Bucket = Header().Buckets[WordLength];
+  return FString(MyData + Bucket.Offset + size_t(Index) * WordLength,
+                 WordLength);
+}
+
+/**
+ * @brief FWordStore::Build
+ * @param WordListPath
+ * @param StorePath
+ * @return true if store file was written
+ */
+bool FWordStore::Build(const FString &WordListPath, const FString &StorePath) {
+  const std::vector<char> Image = BuildImage(WordListPath);
+  if (Image.empty()) {
+    return false;
+  }
+  std::ofstream File(StorePath, std::ios::binary | std::ios::trunc);
+  File.write(Image.data(), Image.size());
+  return bool(File);
+}
+
+/**
+ * @brief FWordStore::Map
+ * @param Path
+ * @return true if file is a valid store and it was mapped
+ */
+bool FWordStore::Map(const FString &Path) {
+#ifdef WORDSTORE_MMAP
+  const int Fd = open(Path.c_str(), O_RDONLY);
+  if (Fd < 0) {
+    return false;
+  }
+  struct stat Stat;
+  if (fstat(Fd, &Stat) != 0 || size_t(Stat.st_size) < sizeof(FWordStoreHeader)) {
+    close(Fd);
+    return false;
+  }
+  void *Data = mmap(nullptr, Stat.st_size, PROT_READ, MAP_PRIVATE, Fd, 0);
+  close(Fd);
+  if (Data == MAP_FAILED) {
+    return false;
+  }
+  MyData = static_cast<const char *>(Data);
+  MySize = Stat.st_size;
+  bIsMapped = true;
+#else
+  std::ifstream File(Path, std::ios::binary);
+  MyImage.assign(std::istreambuf_iterator<char>(File),
+                 std::istreambuf_iterator<char>());
+  if (MyImage.size() < sizeof(FWordStoreHeader)) {
+    MyImage.clear();
+    return false;
+  }
+  MyData = MyImage.data();
+  MySize = MyImage.size();
+#endif
+
+  // every bucket must fit in the file
+  bool bIsValid = std::memcmp(Header().Magic, STORE_MAGIC, sizeof(STORE_MAGIC)) == 0 &&
+                  Header().Version == STORE_VERSION;
+  for (int32 Length = 0; bIsValid && Length <= FWordStoreHeader::MAX_WORD_LENGTH;
+       ++Length) {
+    const auto &Bucket = Header().Buckets[Length];
+    bIsValid = Bucket.Offset <= MySize &&
+               size_t(Bucket.Count) * Length <= MySize - Bucket.Offset;
+  }
+  if (!bIsValid) {
+    Close();
+  }
+  return bIsValid;
+}
+
+/**
+ * @brief FWordStore::BuildImage
+ * @param WordListPath
+ * @return store image with sorted lowercase isograms, empty on error
+ */
+std::vector<char> FWordStore::BuildImage(const FString &WordListPath) {
+  std::ifstream File(WordListPath);
+  if (!File) {
+    return std::vector<char>();
+  }
+
+  std::vector<FString> Buckets[FWordStoreHeader::MAX_WORD_LENGTH + 1];
+  FString Word;
+  while (std::getline(File, Word)) {
+    if (!Word.empty() && Word.back() == '\r')
+      Word.pop_back();
+    if (!Word.empty() && FBullCowGame::IsLowerCase(Word) &&
+        FBullCowGame::IsIsogram(Word)) {
+      Buckets[Word.length()].push_back(Word);
+    }
+  }
+
+  FWordStoreHeader Header = {};
+  std::memcpy(Header.Magic, STORE_MAGIC, sizeof(STORE_MAGIC));
+  Header.Version = STORE_VERSION;
+
+  std::vector<char> Image(sizeof(Header));
+  for (int32 Length = 1; Length <= FWordStoreHeader::MAX_WORD_LENGTH; ++Length) {
+    auto &Words = Buckets[Length];
+    std::sort(Words.begin(), Words.end());
+    Words.erase(std::unique(Words.begin(), Words.end()), Words.end());
+
+    Header.Buckets[Length].Offset = Image.size();
+    Header.Buckets[Length].Count = Words.size();
+    for (const auto &Bucketed : Words) {
+      Image.insert(Image.end(), Bucketed.begin(), Bucketed.end());
+    }
+  }
+  std::memcpy(Image.data(), &Header, sizeof(Header));
+  return Image;
+}
+
+/**
+ * @brief FWordStore::Header
+ * @return
+ */
+const FWordStoreHeader &FWordStore::Header() const {
+  return *reinterpret_cast<const FWordStoreHeader *>(MyData);
+}
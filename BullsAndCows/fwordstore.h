@@ -0,0 +1,61 @@
+/* Read-only store of hidden word candidates (no view code or user interaction)
+ * Words are bucketed by length and kept as fixed size records, so the file
+ * can be mapped into memory and used without parsing. Any word is reachable
+ * in O(1) by its length and index.
+*/
+
+#ifndef FWORDSTORE_H
+#define FWORDSTORE_H
+#include <vector>
+#include "fbullcowgame.h"
+
+/* File layout (host byte order):
+ *   FWordStoreHeader
+ *   for each non empty bucket: Count records of Length chars (no separators)
+ */
+struct FWordStoreHeader
+{
+    static constexpr int32 MAX_WORD_LENGTH = 26; // longest isogram
+
+    struct FBucket
+    {
+        uint32 Offset; // from the beginning of the file
+        uint32 Count;
+    };
+
+    char Magic[4];  // "BCWS"
+    uint32 Version; // 1
+    FBucket Buckets[MAX_WORD_LENGTH + 1]; // indexed by word length
+};
+
+class FWordStore
+{
+public:
+    FWordStore(); // c-tor
+    ~FWordStore(); // d-tor
+    FWordStore(const FWordStore &) = delete;
+    FWordStore &operator=(const FWordStore &) = delete;
+
+    // maps a store file; plain word list (one word per line) is converted
+    // in memory instead
+    bool Open(const FString &Path);
+    void Close();
+
+    int32 GetWordCount(int32 WordLength) const;
+    FString GetWord(int32 WordLength, int32 Index) const;
+
+    // writes lowercase isograms from a word list into a store file
+    static bool Build(const FString &WordListPath, const FString &StorePath);
+
+private:
+    bool Map(const FString &Path);
+    static std::vector<char> BuildImage(const FString &WordListPath);
+    const FWordStoreHeader &Header() const;
+
+    const char *MyData; // whole store image
+    size_t MySize;
+    bool bIsMapped; // MyData is mapped file, otherwise points to MyImage
+    std::vector<char> MyImage;
+};
+
+#endif // FWORDSTORE_H
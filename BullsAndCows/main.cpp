@@ -3,33 +3,61 @@
  * user interactions. For game logic see the FBullCowGame class.
  */
 
+#include <cstdlib>
 #include <iostream>
 #include <string>
+#include <thread>
 #include "fbullcowgame.h"
+#include "fbullcowsolver.h"
+#include "fwordstore.h"
 
 // to make syntax Unreal friendly
 using FText = std::string;
 using int32 = int;
 
 // function prototypes as outside a class
-void PrintIntro();
-void PlayGame();
-void PrintGameSummary();
+void PrintIntro(const FBullCowGame &BCGame);
+void PlayGame(FBullCowGame &BCGame);
+void PrintGameSummary(const FBullCowGame &BCGame);
 bool AskToPlayAgain();
+int RunSolver(int argc, char *argv[]);
+int RunBuildStore(int argc, char *argv[]);
 
-FText GetValidGuess();
-FBullCowGame BCGame; // instantiate a game, which we re-use across all plays
+FText GetValidGuess(const FBullCowGame &BCGame);
 
 // the entry point of our application
 /**
  * @brief main
  * @return
  */
-int main()
+int main(int argc, char *argv[])
 {
+    if (argc > 1 && FText(argv[1]) == "--solve")
+        return RunSolver(argc, argv);
+    if (argc > 1 && FText(argv[1]) == "--build-store")
+        return RunBuildStore(argc, argv);
+
+    FBullCowGame BCGame; // instantiate a game, which we re-use across all plays
+
+    // --words STORE [LENGTH] picks hidden words from the word store
+    FWordStore WordStore;
+    if (argc > 2 && FText(argv[1]) == "--words") {
+        if (!WordStore.Open(argv[2])) {
+            std::cerr << "Can not open word store " << argv[2] << "\n";
+            return EXIT_FAILURE;
+        }
+        const int32 WordLength = (argc > 3) ? atoi(argv[3]) : 6;
+        if (WordStore.GetWordCount(WordLength) == 0) {
+            std::cerr << "No " << WordLength << " letter words in " << argv[2] << "\n";
+            return EXIT_FAILURE;
+        }
+        BCGame.SetWordStore(&WordStore, WordLength);
+    }
+
     do {
-        PrintIntro();
-        PlayGame();
+        BCGame.Reset();
+        PrintIntro(BCGame);
+        PlayGame(BCGame);
     } while (AskToPlayAgain());
 
     std::cout << std::endl;
@@ -37,10 +65,66 @@ int main()
     return 0; // exit the application
 }
 
+/**
+ * @brief RunSolver
+ * headless self-play: --solve DICTIONARY [LENGTH [THREADS [entropy|minimax]]]
+ * @return
+ */
+int RunSolver(int argc, char *argv[])
+{
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0]
+                  << " --solve DICTIONARY [LENGTH [THREADS [entropy|minimax]]]\n";
+        return EXIT_FAILURE;
+    }
+    const int32 WordLength = (argc > 3) ? atoi(argv[3]) : 6;
+    const int32 Threads = (argc > 4) ? atoi(argv[4])
+                                     : int32(std::thread::hardware_concurrency());
+    const ESolverStrategy Strategy = (argc > 5 && FText(argv[5]) == "minimax")
+                                     ? ESolverStrategy::Minimax
+                                     : ESolverStrategy::Entropy;
+
+    const auto Dictionary = FBullCowSolver::LoadDictionary(argv[2], WordLength);
+    if (Dictionary.empty()) {
+        std::cerr << "No " << WordLength << " letter isograms in " << argv[2] << "\n";
+        return EXIT_FAILURE;
+    }
+
+    const FSelfPlayResult Result =
+            FBullCowSolver::SelfPlay(Dictionary, Strategy, Threads);
+
+    std::cout << "Words : " << Dictionary.size() << "\n";
+    std::cout << "Threads : " << Result.Threads << "\n";
+    std::cout << "Seconds : " << Result.Seconds << "\n";
+    std::cout << "Games per second : " << Result.Games / Result.Seconds << "\n";
+    std::cout << "Average tries : " << double(Result.TotalTries) / Result.Games << "\n";
+    std::cout << "Worst tries : " << Result.WorstTries << "\n";
+    std::cout << "Lost games : " << Result.Lost << std::endl;
+    return 0;
+}
+
+/**
+ * @brief RunBuildStore
+ * converts word list into word store: --build-store WORDLIST STORE
+ * @return
+ */
+int RunBuildStore(int argc, char *argv[])
+{
+    if (argc < 4) {
+        std::cerr << "Usage: " << argv[0] << " --build-store WORDLIST STORE\n";
+        return EXIT_FAILURE;
+    }
+    if (!FWordStore::Build(argv[2], argv[3])) {
+        std::cerr << "Can not build word store " << argv[3] << "\n";
+        return EXIT_FAILURE;
+    }
+    return 0;
+}
+
 /**
  * @brief PrintIntro
  */
-void PrintIntro() {
+void PrintIntro(const FBullCowGame &BCGame) {
     std::cout << "Welcome to the Bulls and Cows game\n";
     std::cout << "Can you guess " << BCGame.GetMyHiddenWordLength();
     std::cout << " letters word I am thinking of?\n\n";
@@ -51,7 +135,7 @@ void PrintIntro() {
  * @brief GetValidGuess
  * @return
  */
-FText GetValidGuess() {
+FText GetValidGuess(const FBullCowGame &BCGame) {
 
     FText Guess = "";
     EGuessStatus Status = EGuessStatus::Not_Valid;
@@ -90,16 +174,15 @@ FText GetValidGuess() {
 /**
  * @brief PlayGame
  */
-void PlayGame()
+void PlayGame(FBullCowGame &BCGame)
 {
-    BCGame.Reset();
     int32 MaxTries = BCGame.GetMaxTries();
 
     // loop through till the game is won or no more tries
     while (!BCGame.IsGameWon() && BCGame.GetCurrentTry() <= MaxTries)
     {
 
-        FText Guess = GetValidGuess(); // TODO make loop checking valid guesses
+        FText Guess = GetValidGuess(BCGame); // TODO make loop checking valid guesses
         FBullCowCount BullCowCount = BCGame.SubbmitValidGuees(Guess);
 
 
@@ -109,7 +192,7 @@ void PlayGame()
         std::cout << std::endl;
 
     }
-    PrintGameSummary();
+    PrintGameSummary(BCGame);
 }
 
 /**
@@ -129,7 +212,7 @@ bool AskToPlayAgain() {
 /**
  * @brief PrintGameSummary
  */
-void PrintGameSummary()
+void PrintGameSummary(const FBullCowGame &BCGame)
 {
     if (BCGame.IsGameWon())
         std::cout << "Gratz U Won.\n";
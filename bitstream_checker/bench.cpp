@@ -0,0 +1,50 @@
+/**
+ * @file bench.cpp
+ * @brief Throughput of bit stream checkers
+ *
+ * @author Krzysztof Lasota
+ */
+
+#include <cstdint>
+
+extern "C" {
+#include "tripleBitStreamChecker.h"
+#include "trivialBitStreamChecker.h"
+}
+
+#include "microbench.hpp"
+
+
+namespace {
+
+/// Chunk of valid stream, no three equal bits in a row.
+const BitChunk ValidChunk = 0x55u;
+
+void BM_TripleVerify(microbench::State& state)
+{
+	TripleBitStreamChecker* checker = static_cast<TripleBitStreamChecker*>(alloc_TripleBitStreamChecker());
+	for (auto _ : state)
+		if (!checker->verify(checker, ValidChunk))
+			state.skipWithError("valid stream reported invalid");
+	checker->free_self(checker);
+
+	state.setBytesProcessed(state.iterations());
+}
+MICROBENCH(BM_TripleVerify);
+
+/// Bits of chunk, one call per bit, of range(0) interleaved streams.
+void BM_TrivialVerify(microbench::State& state)
+{
+	const unsigned streams = state.range();
+	unsigned streamNo = 0;
+	for (auto _ : state) {
+		for (unsigned bit = 0; bit < 8; ++bit)
+			microbench::doNotOptimize(verify(ValidChunk >> bit, streamNo));
+		streamNo = (streamNo + 1) % streams;
+	}
+
+	state.setBytesProcessed(state.iterations());
+}
+MICROBENCH(BM_TrivialVerify)->arg(1)->arg(16)->arg(200);
+
+} // namespace
@@ -0,0 +1,329 @@
+/**
+ * @file batch.cpp
+ * @brief Conversion of many files in one process
+ *
+ * @author Krzysztof Lasota
+ */
+
+#include "batch.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "conversion.hpp"
+#include "converter.hpp"
+#include "input.hpp"
+#include "output.hpp"
+#include "work_stealing_pool.hpp"
+
+
+namespace {
+
+std::system_error systemError(const std::string& what)
+{
+	return std::system_error(errno, std::generic_category(), what);
+}
+
+
+/// Descriptor closed with the object.
+class File
+{
+public:
+	File(const std::string& path, int flags)
+	 : mFd(::open(path.c_str(), flags | O_CLOEXEC, 0666))
+	{
+		if (mFd < 0)
+			throw systemError("open " + path);
+	}
+
+	~File()
+	{
+		if (mFd >= 0)
+			::close(mFd);
+	}
+
+	File(const File&) = delete;
+	File& operator=(const File&) = delete;
+
+	int fd() const { return mFd; }
+
+	/// Passes ownership of descriptor to caller.
+	int release()
+	{
+		const int fd = mFd;
+		mFd = -1;
+		return fd;
+	}
+
+	void close()
+	{
+		if (::close(release()) != 0)
+			throw systemError("close");
+	}
+
+private:
+	int mFd;
+};
+
+
+std::size_t readAll(int fd, std::uint8_t* buffer, std::size_t size)
+{
+	std::size_t done = 0;
+	while (done < size) {
+		const ssize_t count = ::read(fd, buffer + done, size - done);
+		if (count < 0 && errno == EINTR)
+			continue;
+		if (count < 0)
+			throw systemError("read");
+		if (count == 0)
+			break;
+		done += count;
+	}
+	return done;
+}
+
+void writeAll(int fd, const std::uint8_t* data, std::size_t size)
+{
+	while (size > 0) {
+		const ssize_t count = ::write(fd, data, size);
+		if (count < 0 && errno == EINTR)
+			continue;
+		if (count < 0)
+			throw systemError("write");
+		data += count;
+		size -= count;
+	}
+}
+
+/// Creates directory with all missing parents.
+void makeDirs(const std::string& path)
+{
+	for (std::size_t end = path.find('/', 1); ; end = path.find('/', end + 1)) {
+		const std::string dir = path.substr(0, end);
+		if (mkdir(dir.c_str(), 0777) != 0 && errno != EEXIST)
+			throw systemError("mkdir " + dir);
+		if (end == std::string::npos)
+			return;
+	}
+}
+
+std::string parentDir(const std::string& path)
+{
+	const std::size_t separator = path.rfind('/');
+	return (separator == std::string::npos || separator == 0) ? "" : path.substr(0, separator);
+}
+
+void walk(const std::string& inputDir, const std::string& outputDir, std::vector<BatchJob>& jobs)
+{
+	DIR* dirp = opendir(inputDir.c_str());
+	if (!dirp)
+		throw systemError("open directory " + inputDir);
+
+	std::vector<std::string> names;
+	while (const dirent* entry = readdir(dirp)) {
+		const std::string name = entry->d_name;
+		if (name != "." && name != "..")
+			names.push_back(name);
+	}
+	closedir(dirp);
+	std::sort(names.begin(), names.end());
+
+	for (const std::string& name : names) {
+		const std::string input = inputDir + '/' + name;
+		struct stat info;
+		if (lstat(input.c_str(), &info) != 0)
+			throw systemError("stat " + input);
+		if (S_ISDIR(info.st_mode))
+			walk(input, outputDir + '/' + name, jobs);
+		else if (S_ISREG(info.st_mode))
+			jobs.push_back(BatchJob{input, outputDir + '/' + name});
+	}
+}
+
+
+/**
+ * @brief Files of batch and state of workers converting them.
+ */
+class Batch
+{
+public:
+	Batch(const ConverterFactory& factory_, const BatchConfig& config_)
+	 : mFactory(factory_)
+	 , mBufferSize(std::max<std::size_t>(config_.bufferSize, 1))
+	{
+		const std::size_t threads = config_.threads > 0
+				? config_.threads : std::max(1u, std::thread::hardware_concurrency());
+		for (std::size_t idx = 0; idx < threads; ++idx)
+			mWorkers.emplace_back(new Worker(mFactory()));
+	}
+
+	BatchStats run(const std::vector<BatchJob>& jobs)
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		std::set<std::string> dirs;
+		for (const BatchJob& job : jobs)
+			dirs.insert(parentDir(job.output));
+		for (const std::string& dir : dirs)
+			if (!dir.empty())
+				makeDirs(dir);
+
+		{
+			WorkStealingPool pool(mWorkers.size());
+			for (const BatchJob& job : jobs)
+				pool.submit([this, &job]() { convertFile(job); });
+		}
+
+		BatchStats stats;
+		for (const std::unique_ptr<Worker>& worker : mWorkers) {
+			stats.files += worker->stats.files;
+			stats.bytesIn += worker->stats.bytesIn;
+			stats.bytesOut += worker->stats.bytesOut;
+			stats.failures.insert(stats.failures.end(),
+					worker->stats.failures.begin(), worker->stats.failures.end());
+		}
+		stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		return stats;
+	}
+
+private:
+	struct Worker
+	{
+		explicit
+		Worker(std::unique_ptr<Converter> converter_)
+		 : converter(std::move(converter_))
+		{
+		}
+
+		std::unique_ptr<Converter> converter;
+		std::vector<std::uint8_t> in;
+		std::vector<std::uint8_t> out;
+		BatchStats stats;
+	};
+
+	/// Worker task, failure is recorded for the file.
+	void convertFile(const BatchJob& job)
+	{
+		Worker& worker = *mWorkers[WorkStealingPool::currentWorker()];
+		try {
+			const ConversionStats converted = convertFile(worker, job);
+			++worker.stats.files;
+			worker.stats.bytesIn += converted.bytesIn;
+			worker.stats.bytesOut += converted.bytesOut;
+		}
+		catch (const std::exception& e) {
+			worker.stats.failures.push_back(BatchFailure{job.input, e.what()});
+			renewConverter(worker);
+		}
+	}
+
+	/// Converter may be left inside of failed stream, old one is kept when factory fails.
+	void renewConverter(Worker& worker)
+	{
+		try {
+			std::lock_guard<std::mutex> lock(mFactoryMutex);
+			worker.converter = mFactory();
+		}
+		catch (const std::exception&) {
+		}
+	}
+
+	ConversionStats convertFile(Worker& worker, const BatchJob& job)
+	{
+		File input(job.input, O_RDONLY);
+		struct stat info;
+		if (fstat(input.fd(), &info) != 0)
+			throw systemError("stat " + job.input);
+		struct stat outputInfo;
+		if (stat(job.output.c_str(), &outputInfo) == 0
+				&& outputInfo.st_dev == info.st_dev && outputInfo.st_ino == info.st_ino)
+			throw std::runtime_error("output is the same file as input");
+
+		if (!S_ISREG(info.st_mode) || std::uint64_t(info.st_size) > mBufferSize) {
+			std::unique_ptr<Input> streamed = Input::fromDescriptor(input.release(), true);
+			std::unique_ptr<Output> output = Output::open(job.output);
+			const ConversionStats stats = convert(*streamed, *worker.converter, *output);
+			output->close();
+			return stats;
+		}
+
+		// small file: single read, conversion in memory and single write
+		worker.in.resize(mBufferSize);
+		const std::size_t size = readAll(input.fd(), worker.in.data(), worker.in.size());
+		const std::size_t produced = convertBlock(*worker.converter,
+				InputView(worker.in.data(), size), worker.out);
+
+		File output(job.output, O_WRONLY | O_CREAT | O_TRUNC);
+		writeAll(output.fd(), worker.out.data(), produced);
+		output.close();
+
+		ConversionStats stats;
+		stats.bytesIn = size;
+		stats.bytesOut = produced;
+		return stats;
+	}
+
+	const ConverterFactory& mFactory;
+	std::mutex mFactoryMutex;    ///< factory is not required to be thread safe
+	const std::size_t mBufferSize;
+	std::vector<std::unique_ptr<Worker>> mWorkers;
+};
+
+} // namespace
+
+
+double BatchStats::filesPerSecond() const
+{
+	return seconds > 0 ? files / seconds : 0;
+}
+
+
+double BatchStats::megabytesPerSecond() const
+{
+	return seconds > 0 ? bytesIn / seconds / 1e6 : 0;
+}
+
+
+std::vector<BatchJob> walkDirectory(const std::string& inputDir, const std::string& outputDir)
+{
+	std::vector<BatchJob> jobs;
+	walk(inputDir, outputDir, jobs);
+	return jobs;
+}
+
+
+std::vector<BatchJob> readManifest(std::istream& manifest)
+{
+	std::vector<BatchJob> jobs;
+	std::string line;
+	for (std::size_t lineNo = 1; std::getline(manifest, line); ++lineNo) {
+		if (line.empty() || line[0] == '#')
+			continue;
+		const std::size_t separator = line.find('\t');
+		if (separator == std::string::npos || separator == 0 || separator + 1 == line.size())
+			throw std::invalid_argument("manifest line " + std::to_string(lineNo)
+					+ ": expected INPUT<TAB>OUTPUT");
+		jobs.push_back(BatchJob{line.substr(0, separator), line.substr(separator + 1)});
+	}
+	return jobs;
+}
+
+
+BatchStats convertBatch(const std::vector<BatchJob>& jobs, const ConverterFactory& factory,
+		const BatchConfig& config)
+{
+	return Batch(factory, config).run(jobs);
+}
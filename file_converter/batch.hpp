@@ -0,0 +1,85 @@
+/**
+ * @file batch.hpp
+ * @brief Conversion of many files in one process
+ *
+ * @author Krzysztof Lasota
+ */
+
+#ifndef BATCH_HPP_
+#define BATCH_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "parallel.hpp"
+
+
+/// Single file of batch.
+struct BatchJob
+{
+	std::string input;
+	std::string output;
+};
+
+/// File which could not be converted.
+struct BatchFailure
+{
+	std::string path;
+	std::string reason;
+};
+
+struct BatchStats
+{
+	std::size_t files = 0;    ///< converted successfully
+	std::uint64_t bytesIn = 0;
+	std::uint64_t bytesOut = 0;
+	double seconds = 0;
+	std::vector<BatchFailure> failures;
+
+	double filesPerSecond() const;
+	double megabytesPerSecond() const;    ///< of input
+};
+
+struct BatchConfig
+{
+	std::size_t threads = 0;                        ///< 0 for hardware concurrency
+	std::size_t bufferSize = std::size_t(1) << 20;  ///< larger files are streamed
+};
+
+
+/**
+ * @brief Jobs for all regular files under `inputDir`, in sorted order.
+ *
+ * Output of each file has the same path relative to `outputDir`. Symbolic
+ * links are not followed.
+ *
+ * @throw std::system_error when directory can not be read
+ */
+std::vector<BatchJob> walkDirectory(const std::string& inputDir, const std::string& outputDir);
+
+/**
+ * @brief Jobs listed in manifest, line `INPUT<TAB>OUTPUT` per file.
+ *
+ * Empty lines and lines starting with '#' are skipped.
+ *
+ * @throw std::invalid_argument for line without output path
+ */
+std::vector<BatchJob> readManifest(std::istream& manifest);
+
+/**
+ * @brief Convert all jobs on thread pool, creating missing output directories.
+ *
+ * Every worker owns one converter from factory, reused for all its files
+ * (see Converter::convert()), and input and output buffers of
+ * config.bufferSize bytes. Files fitting into buffer are converted with
+ * single read() and write(), larger ones are streamed by convert().
+ * Failed files are reported in stats, they do not stop the batch; worker
+ * then gets new converter from factory (calls are serialized).
+ */
+BatchStats convertBatch(const std::vector<BatchJob>& jobs, const ConverterFactory& factory,
+		const BatchConfig& config = BatchConfig());
+
+#endif /* BATCH_HPP_ */
@@ -0,0 +1,147 @@
+/**
+ * @file batch_test.cpp
+ * @brief Test for batch conversion of many files
+ *
+ * @author Krzysztof Lasota
+ */
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "batch.hpp"
+#include "converter.hpp"
+#include "test_utils.hpp"
+
+using namespace test;
+
+
+namespace {
+
+BatchConfig smallBuffers()
+{
+	BatchConfig config;
+	config.threads = 3;
+	config.bufferSize = 1000;    // some files are streamed
+	return config;
+}
+
+} // namespace
+
+
+TEST(Batch_Test, T01_WalkMapsTree)
+{
+	TempDir dir;
+	dir.makeDir("b");
+	dir.makeDir("b/c");
+	dir.write("a", "");
+	dir.write("b/c/d", "");
+	dir.write("b/e", "");
+	ASSERT_EQ(0, symlink("a", (dir.path() + "/link").c_str()));
+
+	const std::vector<BatchJob> jobs = walkDirectory(dir.path(), "out");
+
+	ASSERT_EQ(3u, jobs.size());
+	EXPECT_EQ(dir.path() + "/a", jobs[0].input);
+	EXPECT_EQ("out/a", jobs[0].output);
+	EXPECT_EQ(dir.path() + "/b/c/d", jobs[1].input);
+	EXPECT_EQ("out/b/c/d", jobs[1].output);
+	EXPECT_EQ("out/b/e", jobs[2].output);
+}
+
+TEST(Batch_Test, T02_ManifestSkipsComments)
+{
+	std::istringstream manifest("# input\toutput\n\nin 1\tout 1\nin2\tdir/out2\n");
+
+	const std::vector<BatchJob> jobs = readManifest(manifest);
+
+	ASSERT_EQ(2u, jobs.size());
+	EXPECT_EQ("in 1", jobs[0].input);
+	EXPECT_EQ("out 1", jobs[0].output);
+	EXPECT_EQ("in2", jobs[1].input);
+	EXPECT_EQ("dir/out2", jobs[1].output);
+}
+
+TEST(Batch_Test, T03_ManifestWithoutOutput)
+{
+	std::istringstream manifest("in1\tout1\nin2\n");
+	EXPECT_THROW(readManifest(manifest), std::invalid_argument);
+}
+
+TEST(Batch_Test, T04_ConvertsSmallAndLargeFiles)
+{
+	TempDir source, target;
+	source.makeDir("sub");
+	const std::vector<std::string> files = {"empty", "small", "sub/large", "sub/small"};
+	const std::vector<std::string> data = {"", patternData(10), patternData(5000), patternData(1000)};
+	for (std::size_t idx = 0; idx < files.size(); ++idx)
+		source.write(files[idx], data[idx]);
+
+	const BatchStats stats = convertBatch(walkDirectory(source.path(), target.path() + "/out"),
+			[]() { return Converter::create("upper"); }, smallBuffers());
+
+	std::unique_ptr<Converter> converter = Converter::create("upper");
+	for (std::size_t idx = 0; idx < files.size(); ++idx)
+		EXPECT_EQ(convertString(*converter, data[idx]), target.read("out/" + files[idx])) << files[idx];
+	EXPECT_EQ(4u, stats.files);
+	EXPECT_EQ(6010u, stats.bytesIn);
+	EXPECT_EQ(6010u, stats.bytesOut);
+	EXPECT_TRUE(stats.failures.empty());
+}
+
+TEST(Batch_Test, T05_FailureDoesNotStopBatch)
+{
+	TempDir dir;
+	dir.write("a", "abc");
+	dir.write("c", "def");
+	const std::vector<BatchJob> jobs = {
+		{dir.path() + "/a", dir.path() + "/A"},
+		{dir.path() + "/b", dir.path() + "/B"},
+		{dir.path() + "/c", dir.path() + "/C"},
+	};
+
+	const BatchStats stats = convertBatch(jobs, []() { return Converter::create("upper"); }, smallBuffers());
+
+	EXPECT_EQ(2u, stats.files);
+	ASSERT_EQ(1u, stats.failures.size());
+	EXPECT_EQ(dir.path() + "/b", stats.failures[0].path);
+	EXPECT_EQ("ABC", dir.read("A"));
+	EXPECT_EQ("DEF", dir.read("C"));
+}
+
+TEST(Batch_Test, T06_ConverterPerWorker)
+{
+	TempDir dir;
+	std::vector<BatchJob> jobs;
+	for (int file = 0; file < 20; ++file) {
+		const std::string name = std::to_string(file);
+		dir.write(name, name);
+		jobs.push_back(BatchJob{dir.path() + '/' + name, dir.path() + "/out" + name});
+	}
+
+	int created = 0;
+	const BatchStats stats = convertBatch(jobs, [&created]() {
+		++created;
+		return Converter::create("copy");
+	}, smallBuffers());
+
+	EXPECT_EQ(20u, stats.files);
+	EXPECT_EQ(3, created);
+	EXPECT_EQ("17", dir.read("out17"));
+}
+
+TEST(Batch_Test, T07_OutputSameAsInputFails)
+{
+	TempDir dir;
+	const std::string large = patternData(5000);
+	dir.write("large", large);
+	const std::vector<BatchJob> jobs = {{dir.path() + "/large", dir.path() + "/large"}};
+
+	const BatchStats stats = convertBatch(jobs, []() { return Converter::create("upper"); }, smallBuffers());
+
+	EXPECT_EQ(0u, stats.files);
+	ASSERT_EQ(1u, stats.failures.size());
+	EXPECT_EQ(large, dir.read("large"));
+}
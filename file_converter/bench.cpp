@@ -0,0 +1,210 @@
+/**
+ * @file bench.cpp
+ * @brief Throughput of iostream access to files, std::fstream versus stream_buffer.hpp
+ *
+ * @author Krzysztof Lasota
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "input.hpp"
+#include "output.hpp"
+#include "stream_buffer.hpp"
+
+
+namespace {
+
+/// Timing of single workload on single stream kind.
+struct Result
+{
+	std::string workload;
+	std::string stream;
+	double seconds;
+	std::size_t bytes;
+};
+
+const std::size_t BulkSize = std::size_t(64) << 10;
+
+/// Reads whole stream, returns bytes seen.
+typedef std::function<std::size_t(std::istream&)> ReadWorkload;
+/// Writes at least `bytes` into stream, returns bytes written.
+typedef std::function<std::size_t(std::ostream&, std::size_t bytes)> WriteWorkload;
+
+std::size_t readBulk(std::istream& in)
+{
+	std::vector<char> buffer(BulkSize);
+	std::size_t total = 0;
+	while (in.read(buffer.data(), buffer.size()) || in.gcount() > 0)
+		total += in.gcount();
+	return total;
+}
+
+std::size_t readLines(std::istream& in)
+{
+	std::size_t total = 0;
+	for (std::string line; std::getline(in, line); )
+		total += line.size() + 1;
+	return total;
+}
+
+std::size_t writeBulk(std::ostream& out, std::size_t bytes)
+{
+	const std::string block(BulkSize, 'x');
+	std::size_t done = 0;
+	for (; done < bytes; done += block.size())
+		out.write(block.data(), block.size());
+	return done;
+}
+
+std::size_t writeLines(std::ostream& out, std::size_t bytes)
+{
+	const std::string text = "quick brown fox jumps over the lazy dog";
+	std::size_t done = 0;
+	for (std::size_t line = 0; done < bytes; ++line) {
+		out << line << ' ' << text << '\n';
+		done += std::to_string(line).size() + text.size() + 2;
+	}
+	return done;
+}
+
+template <typename Function>
+double timed(Function function)
+{
+	const auto start = std::chrono::steady_clock::now();
+	function();
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::vector<Result> readResults(const std::string& path, const std::string& workload, ReadWorkload read)
+{
+	std::vector<Result> results;
+	std::size_t bytes = 0;
+
+	const double fstreamTime = timed([&]() {
+		std::ifstream in(path, std::ios::binary);
+		bytes = read(in);
+	});
+	results.push_back({workload, "fstream", fstreamTime, bytes});
+
+	const double mappedTime = timed([&]() {
+		std::unique_ptr<Input> input = Input::open(path);
+		InputStream in(*input);
+		bytes = read(in);
+	});
+	results.push_back({workload, "mapped", mappedTime, bytes});
+	return results;
+}
+
+std::vector<Result> writeResults(const std::string& path, const std::string& workload,
+		WriteWorkload write, std::size_t bytes)
+{
+	std::vector<Result> results;
+	std::size_t written = 0;
+
+	const double fstreamTime = timed([&]() {
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		written = write(out, bytes);
+	});
+	results.push_back({workload, "fstream", fstreamTime, written});
+
+	const double mappedTime = timed([&]() {
+		std::unique_ptr<Output> output = Output::open(path);
+		OutputStream out(*output);
+		written = write(out, bytes);
+		out.flush();
+		output->close();
+	});
+	results.push_back({workload, "mapped", mappedTime, written});
+
+	const double gatherTime = timed([&]() {
+		// write only descriptor is not mapped
+		std::unique_ptr<Output> output = Output::fromDescriptor(
+				::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666), true);
+		OutputStream out(*output);
+		written = write(out, bytes);
+		out.flush();
+		output->close();
+	});
+	results.push_back({workload, "gather", gatherTime, written});
+	return results;
+}
+
+void printUsage(const char* appl)
+{
+	std::cerr << "Usage: " << appl << " [-s MEGABYTES] [-f FILE]\n"
+			"  -s MEGABYTES  size of written and read file (default 256)\n"
+			"  -f FILE       scratch file (default bench.tmp), removed at end\n";
+}
+
+void printJson(const std::vector<Result>& results)
+{
+	std::printf("{\n  \"benchmark\": \"file_converter_iostream\",\n  \"results\": [");
+	for (std::size_t idx = 0; idx < results.size(); ++idx) {
+		const Result& r = results[idx];
+		std::printf("%s\n    {\"workload\": \"%s\", \"stream\": \"%s\", \"seconds\": %.6f,"
+				" \"bytes\": %zu, \"mb_per_second\": %.1f}",
+				(idx ? "," : ""), r.workload.c_str(), r.stream.c_str(), r.seconds,
+				r.bytes, r.bytes / r.seconds / 1e6);
+	}
+	std::printf("\n  ]\n}\n");
+}
+
+} // namespace
+
+
+int main(int argc, char** argv)
+{
+	std::size_t megabytes = 256;
+	std::string path = "bench.tmp";
+
+	int opt;
+	while ((opt = getopt(argc, argv, "s:f:h")) != -1) {
+		switch (opt) {
+		case 's':
+			megabytes = std::strtoul(optarg, nullptr, 10);
+			break;
+		case 'f':
+			path = optarg;
+			break;
+		default:
+			printUsage(argv[0]);
+			return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+	unsyncStandardStreams();
+	const std::size_t bytes = megabytes << 20;
+
+	std::vector<Result> results;
+	const struct
+	{
+		const char* name;
+		WriteWorkload write;
+		ReadWorkload read;
+	} workloads[] = {
+		{"bulk", writeBulk, readBulk},
+		{"lines", writeLines, readLines},
+	};
+	for (const auto& workload : workloads) {
+		// last writer leaves file for reading
+		for (const Result& result : writeResults(path, std::string("write_") + workload.name, workload.write, bytes))
+			results.push_back(result);
+		for (const Result& result : readResults(path, std::string("read_") + workload.name, workload.read))
+			results.push_back(result);
+	}
+	unlink(path.c_str());
+
+	printJson(results);
+
+	return 0;
+}
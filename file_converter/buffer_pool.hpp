@@ -0,0 +1,69 @@
+/**
+ * @file buffer_pool.hpp
+ * @brief Recycled fixed-size buffers passed between two threads
+ *
+ * @author Krzysztof Lasota
+ */
+
+#ifndef BUFFER_POOL_HPP_
+#define BUFFER_POOL_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "spsc_queue.hpp"
+
+
+/**
+ * @brief Fixed set of equally sized buffers allocated once.
+ *
+ * One thread acquires buffers and one thread releases them, so free list
+ * is a lock-free SpscQueue. Number of buffers bounds memory in flight.
+ */
+class BufferPool
+{
+public:
+	BufferPool(std::size_t count_, std::size_t bufferSize_)
+	 : mStorage(count_ * bufferSize_)
+	 , mBufferSize(bufferSize_)
+	 , mFree(count_)
+	{
+		for (std::size_t idx = 0; idx < count_; ++idx)
+			mFree.tryPush(mStorage.data() + idx * mBufferSize);
+	}
+
+	BufferPool(const BufferPool&) = delete;
+	BufferPool& operator=(const BufferPool&) = delete;
+
+	std::size_t bufferSize() const { return mBufferSize; }
+
+	/// Free buffer, waits for release; nullptr when cancelled.
+	std::uint8_t* acquire(const std::atomic<bool>& cancel)
+	{
+		std::uint8_t* buffer = nullptr;
+		return mFree.pop(buffer, cancel) ? buffer : nullptr;
+	}
+
+	/// Free buffer, nullptr when all are in use.
+	std::uint8_t* tryAcquire()
+	{
+		std::uint8_t* buffer = nullptr;
+		return mFree.tryPop(buffer) ? buffer : nullptr;
+	}
+
+	/// Return buffer obtained with acquire() or tryAcquire().
+	void release(std::uint8_t* buffer)
+	{
+		// pool never holds more than it owns, push can not fail
+		mFree.tryPush(buffer);
+	}
+
+private:
+	std::vector<std::uint8_t> mStorage;
+	std::size_t mBufferSize;
+	SpscQueue<std::uint8_t*> mFree;
+};
+
+#endif /* BUFFER_POOL_HPP_ */
@@ -0,0 +1,100 @@
+/**
+ * @file conversion.cpp
+ * @brief Core loop passing input through converter to output
+ *
+ * @author Krzysztof Lasota
+ */
+
+#include "conversion.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "converter.hpp"
+#include "input.hpp"
+#include "output.hpp"
+#include "profiler.hpp"
+
+
+namespace {
+
+/// Least free output space offered to convertBlock() converter, room for its trailer.
+const std::size_t MinBlockOutputSpace = std::size_t(64) << 10;
+
+} // namespace
+
+
+ConversionStats convert(Input& input, Converter& converter, Output& output,
+		std::size_t chunkSize, Profiler* profiler)
+{
+	ConversionStats stats;
+	// grows while converter needs longer contiguous input to progress
+	std::size_t minInput = 1;
+
+	for (;;) {
+		InputView in;
+		bool last;
+		{
+			Profiler::Scope scope(profiler, Profiler::Read);
+			in = input.peek(minInput);
+			// view passed to converter exceeds chunkSize for record longer than chunk
+			const std::size_t size = std::max(chunkSize, minInput);
+			last = input.lastView() && in.size() <= size;
+			in = in.first(std::min(in.size(), size));
+		}
+
+		OutputView out;
+		{
+			Profiler::Scope scope(profiler, Profiler::Write);
+			out = output.reserve(std::max<std::size_t>(converter.outputBound(in.size()), 1));
+		}
+
+		Converter::Result result;
+		{
+			Profiler::Scope scope(profiler, Profiler::Convert);
+			result = converter.convert(in, out, last);
+		}
+
+		input.consume(result.consumed);
+		output.commit(result.produced);
+		stats.bytesIn += result.consumed;
+		stats.bytesOut += result.produced;
+		if (profiler) {
+			profiler->addBytesIn(result.consumed);
+			profiler->addBytesOut(result.produced);
+		}
+
+		if (result.consumed > 0 || result.produced > 0) {
+			minInput = 1;
+			continue;
+		}
+		if (last && in.empty())
+			break;    // converter flushed everything
+		if (last || minInput > in.size())
+			throw std::runtime_error("converter does not make progress");
+		minInput = in.size() + 1;
+	}
+	return stats;
+}
+
+
+std::size_t convertBlock(Converter& converter, InputView in, std::vector<std::uint8_t>& out)
+{
+	std::size_t produced = 0;
+	for (;;) {
+		const std::size_t space = std::max(converter.outputBound(in.size()), MinBlockOutputSpace);
+		if (out.size() - produced < space)
+			out.resize(produced + space);
+
+		const Converter::Result result = converter.convert(in,
+				OutputView(out.data() + produced, out.size() - produced), true);
+		in = in.subspan(result.consumed);
+		produced += result.produced;
+
+		if (result.consumed == 0 && result.produced == 0) {
+			if (in.empty())
+				return produced;    // converter flushed everything
+			throw std::runtime_error("converter does not make progress");
+		}
+	}
+}
@@ -0,0 +1,57 @@
+/**
+ * @file conversion.hpp
+ * @brief Core loop passing input through converter to output
+ *
+ * @author Krzysztof Lasota
+ */
+
+#ifndef CONVERSION_HPP_
+#define CONVERSION_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "span.hpp"
+
+class Converter;
+class Input;
+class Output;
+class Profiler;
+
+
+struct ConversionStats
+{
+	std::uint64_t bytesIn = 0;
+	std::uint64_t bytesOut = 0;
+};
+
+
+/// Largest input view passed to converter in one call.
+const std::size_t DefaultChunkSize = std::size_t(4) << 20;
+
+/**
+ * @brief Convert whole input, output is not closed.
+ *
+ * Converter works directly on input and output buffers; data is copied only
+ * by converter itself.
+ *
+ * @param profiler optional instrumentation of read, convert and write calls
+ * @throw std::runtime_error when converter stops making progress
+ * @throw std::system_error when reading or writing fails
+ */
+ConversionStats convert(Input& input, Converter& converter, Output& output,
+		std::size_t chunkSize = DefaultChunkSize, Profiler* profiler = nullptr);
+
+/**
+ * @brief Convert `in` as whole stream into memory.
+ *
+ * Buffer `out` only grows, so it is reused without reallocation for
+ * following streams of similar size.
+ *
+ * @return bytes of output stored at start of `out`
+ * @throw std::runtime_error when converter stops making progress
+ */
+std::size_t convertBlock(Converter& converter, InputView in, std::vector<std::uint8_t>& out);
+
+#endif /* CONVERSION_HPP_ */
@@ -0,0 +1,220 @@
+/**
+ * @file conversion_test.cpp
+ * @brief Test for conversion core: inputs, outputs and conversion loop
+ *
+ * @author Krzysztof Lasota
+ */
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "conversion.hpp"
+#include "converter.hpp"
+#include "input.hpp"
+#include "output.hpp"
+#include "test_utils.hpp"
+
+using namespace test;
+
+
+namespace {
+
+/// Copies whole lines only, unterminated last line when input ends.
+class LineConverter : public Converter
+{
+public:
+	Result convert(InputView in, OutputView out, bool last) override
+	{
+		std::size_t size = std::min(in.size(), out.size());
+		if (!last || size < in.size()) {
+			while (size > 0 && in[size - 1] != '\n')
+				--size;
+		}
+		std::copy(in.begin(), in.begin() + size, out.begin());
+		return Result{size, size};
+	}
+};
+
+} // namespace
+
+
+TEST(Converter_Test, T01_BuiltinConversions)
+{
+	EXPECT_EQ("Mixed Case 1!", convertString(*Converter::create("copy"), "Mixed Case 1!"));
+	EXPECT_EQ("MIXED CASE 1!", convertString(*Converter::create("upper"), "Mixed Case 1!"));
+	EXPECT_EQ("mixed case 1!", convertString(*Converter::create("lower"), "Mixed Case 1!"));
+}
+
+TEST(Converter_Test, T02_UnknownNameThrows)
+{
+	EXPECT_THROW(Converter::create("unknown"), std::invalid_argument);
+}
+
+
+TEST(Input_Test, T01_FileIsSingleView)
+{
+	TempFile file;
+	file.write(patternData(100000));
+
+	std::unique_ptr<Input> input = Input::open(file.path());
+	const InputView view = input->peek();
+
+	EXPECT_TRUE(input->lastView());
+	EXPECT_EQ(100000u, input->sizeHint());
+	EXPECT_EQ(patternData(100000), std::string(view.begin(), view.end()));
+
+	input->consume(view.size());
+	EXPECT_TRUE(input->peek().empty());
+}
+
+TEST(Input_Test, T02_EmptyFile)
+{
+	TempFile file;
+
+	std::unique_ptr<Input> input = Input::open(file.path());
+
+	EXPECT_TRUE(input->peek().empty());
+	EXPECT_TRUE(input->lastView());
+}
+
+TEST(Input_Test, T03_PartiallyReadFileStartsAtOffset)
+{
+	TempFile file;
+	file.write(patternData(100000));
+
+	const int fd = ::open(file.path().c_str(), O_RDONLY);
+	ASSERT_LE(0, fd);
+	ASSERT_EQ(1000, lseek(fd, 1000, SEEK_SET));
+
+	std::unique_ptr<Input> input = Input::fromDescriptor(fd, true);
+	const InputView view = input->peek();
+
+	EXPECT_EQ(99000u, input->sizeHint());
+	EXPECT_EQ(patternData(100000).substr(1000), std::string(view.begin(), view.end()));
+}
+
+TEST(Input_Test, T04_PipeViewsAreContiguousAcrossRingEnd)
+{
+	const std::string data = patternData(1000000);
+	const std::size_t minSize = 10000;
+	PipeWriter writer(data);
+	std::unique_ptr<Input> input = Input::fromDescriptor(writer.readFd(), true, 100000);
+
+	std::string received;
+	for (;;) {
+		const InputView view = input->peek(minSize);
+		if (view.empty())
+			break;
+		if (!input->lastView()) {
+			ASSERT_GE(view.size(), minSize);
+		}
+
+		// consume less than seen, so views start at odd places of the ring
+		const std::size_t size = std::min<std::size_t>(view.size(), 7001);
+		received.append(view.begin(), view.begin() + size);
+		input->consume(size);
+	}
+
+	EXPECT_EQ(data, received);
+}
+
+
+TEST(Output_Test, T01_FileIsTruncatedToCommittedSize)
+{
+	TempFile file;
+	const std::string data = patternData(300000);
+
+	std::unique_ptr<Output> output = Output::open(file.path());
+	for (std::size_t done = 0; done < data.size(); done += 1000) {
+		const OutputView view = output->reserve(1000);
+		ASSERT_GE(view.size(), 1000u);
+		std::copy(data.begin() + done, data.begin() + done + 1000, view.begin());
+		output->commit(1000);
+	}
+	output->close();
+
+	EXPECT_EQ(data, file.read());
+}
+
+TEST(Output_Test, T02_PipeGathersBlocks)
+{
+	int fds[2];
+	ASSERT_EQ(0, pipe(fds));
+	const std::string data = patternData(40000);
+
+	std::string received;
+	std::thread reader([&]() {
+		char buffer[4096];
+		ssize_t count;
+		while ((count = ::read(fds[0], buffer, sizeof(buffer))) > 0)
+			received.append(buffer, count);
+		::close(fds[0]);
+	});
+
+	std::unique_ptr<Output> output = Output::fromDescriptor(fds[1], true, 1024);
+	for (std::size_t done = 0; done < data.size(); done += 100) {
+		const OutputView view = output->reserve(100);
+		std::copy(data.begin() + done, data.begin() + done + 100, view.begin());
+		output->commit(100);
+	}
+	output->close();
+	reader.join();
+
+	EXPECT_EQ(data.size(), output->size());
+	EXPECT_EQ(data, received);
+}
+
+
+TEST(Conversion_Test, T01_FileToFile)
+{
+	TempFile source, target;
+	const std::string data = patternData(3000000);
+	source.write(data);
+
+	std::unique_ptr<Converter> converter = Converter::create("upper");
+	std::unique_ptr<Input> input = Input::open(source.path());
+	std::unique_ptr<Output> output = Output::open(target.path());
+	const ConversionStats stats = convert(*input, *converter, *output, 1 << 20);
+	output->close();
+
+	EXPECT_EQ(data.size(), stats.bytesIn);
+	EXPECT_EQ(data.size(), stats.bytesOut);
+	EXPECT_EQ(convertString(*converter, data), target.read());
+}
+
+TEST(Conversion_Test, T02_ConverterGetsLongerInputWhenStalled)
+{
+	TempFile target;
+	const std::string data = patternData(200003);
+	PipeWriter writer(data);
+
+	SwapConverter converter;
+	std::unique_ptr<Input> input = Input::fromDescriptor(writer.readFd(), true, 65536);
+	std::unique_ptr<Output> output = Output::open(target.path());
+	convert(*input, converter, *output);
+	output->close();
+
+	EXPECT_EQ(convertString(converter, data), target.read());
+}
+
+TEST(Conversion_Test, T03_LastRecordLongerThanChunk)
+{
+	TempFile source, target;
+	const std::string data = "short\n" + std::string(100, 'x');
+	source.write(data);
+
+	LineConverter converter;
+	std::unique_ptr<Input> input = Input::open(source.path());
+	std::unique_ptr<Output> output = Output::open(target.path());
+	const ConversionStats stats = convert(*input, converter, *output, 16);
+	output->close();
+
+	EXPECT_EQ(data.size(), stats.bytesOut);
+	EXPECT_EQ(data, target.read());
+}
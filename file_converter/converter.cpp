@@ -0,0 +1,119 @@
+/**
+ * @file converter.cpp
+ * @brief Built-in converters
+ *
+ * @author Krzysztof Lasota
+ */
+
+#include "converter.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+
+namespace {
+
+/**
+ * @brief Copies input unchanged.
+ */
+class CopyConverter : public Converter
+{
+public:
+	Result convert(InputView in, OutputView out, bool) override
+	{
+		const std::size_t size = std::min(in.size(), out.size());
+		if (size > 0)
+			std::memcpy(out.data(), in.data(), size);
+		return Result{size, size};
+	}
+
+	bool chunkParallel() const override
+	{
+		return true;
+	}
+};
+
+
+/**
+ * @brief Replaces every byte using 256 entries table.
+ */
+class ByteMapConverter : public Converter
+{
+public:
+	template <typename Mapping>
+	explicit
+	ByteMapConverter(Mapping mapping)
+	{
+		for (unsigned byte = 0; byte < sizeof(mTable); ++byte)
+			mTable[byte] = mapping(byte);
+	}
+
+	Result convert(InputView in, OutputView out, bool) override
+	{
+		const std::size_t size = std::min(in.size(), out.size());
+		const std::uint8_t* src = in.data();
+		std::uint8_t* dst = out.data();
+		for (std::size_t idx = 0; idx < size; ++idx)
+			dst[idx] = mTable[src[idx]];
+		return Result{size, size};
+	}
+
+	bool chunkParallel() const override
+	{
+		return true;
+	}
+
+private:
+	std::uint8_t mTable[256];
+};
+
+
+std::uint8_t toUpper(unsigned byte)
+{
+	return ('a' <= byte && byte <= 'z') ? byte - 'a' + 'A' : byte;
+}
+
+std::uint8_t toLower(unsigned byte)
+{
+	return ('A' <= byte && byte <= 'Z') ? byte - 'A' + 'a' : byte;
+}
+
+} // namespace
+
+
+std::unique_ptr<Converter> Converter::create(const std::string& name)
+{
+	if (name == "copy")
+		return std::unique_ptr<Converter>(new CopyConverter());
+	if (name == "upper")
+		return std::unique_ptr<Converter>(new ByteMapConverter(toUpper));
+	if (name == "lower")
+		return std::unique_ptr<Converter>(new ByteMapConverter(toLower));
+
+	throw std::invalid_argument("unknown conversion: " + name);
+}
+
+
+std::vector<std::string> Converter::names()
+{
+	return {"copy", "lower", "upper"};
+}
+
+
+Converter::~Converter()
+{
+}
+
+
+std::size_t Converter::outputBound(std::size_t inSize) const
+{
+	return inSize;
+}
+
+
+bool Converter::chunkParallel() const
+{
+	return false;
+}
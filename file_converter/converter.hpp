@@ -0,0 +1,71 @@
+/**
+ * @file converter.hpp
+ * @brief Interface of conversion plugins
+ *
+ * @author Krzysztof Lasota
+ */
+
+#ifndef CONVERTER_HPP_
+#define CONVERTER_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "span.hpp"
+
+
+/**
+ * @brief Stream conversion working on views of input and output buffers.
+ *
+ * Converter sees bytes where they already are (mapped file, ring buffer)
+ * and writes straight into output buffer, nothing passes through
+ * std::iostream.
+ */
+class Converter
+{
+public:
+	struct Result
+	{
+		std::size_t consumed;    ///< bytes taken from input view
+		std::size_t produced;    ///< bytes written to output view
+	};
+
+	/**
+	 * @brief Create converter of given name.
+	 * @throw std::invalid_argument for unknown name
+	 */
+	static std::unique_ptr<Converter> create(const std::string& name);
+
+	/// Names accepted by create().
+	static std::vector<std::string> names();
+
+	virtual ~Converter();
+
+	/**
+	 * @brief Convert leading part of input.
+	 *
+	 * Unconsumed input is offered again by next call, extended with
+	 * following bytes. Converter must make progress when output view is at
+	 * least outputBound(in.size()) bytes long.
+	 *
+	 * @param last no input follows `in`; converter is called with empty
+	 *        last input until it produces nothing, afterwards converter
+	 *        starts new stream with next call
+	 */
+	virtual Result convert(InputView in, OutputView out, bool last) = 0;
+
+	/// Output size sufficient for converting `inSize` input bytes.
+	virtual std::size_t outputBound(std::size_t inSize) const;
+
+	/**
+	 * @brief True when no state is carried between chunks.
+	 *
+	 * Input may be split into blocks converted independently (each as whole
+	 * stream, by separate converter instances) and concatenated in order.
+	 */
+	virtual bool chunkParallel() const;
+};
+
+#endif /* CONVERTER_HPP_ */
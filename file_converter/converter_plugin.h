@@ -0,0 +1,100 @@
+/**
+ * @file converter_plugin.h
+ * @brief C ABI of conversion plugins loaded at run time
+ *
+ * Plugin is shared library `fc_<plugin>.so` exporting single function
+ * FC_PLUGIN_QUERY_SYMBOL. Host passes its ABI version, plugin returns static
+ * description of its conversions, or NULL when it can not serve this host.
+ * Only fields defined for negotiated version may be used; new fields are
+ * appended at the end of structures with new ABI version.
+ *
+ * @author Krzysztof Lasota
+ */
+
+#ifndef CONVERTER_PLUGIN_H_
+#define CONVERTER_PLUGIN_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FC_PLUGIN_ABI_VERSION 1u
+
+#define FC_PLUGIN_QUERY_SYMBOL "fc_plugin_query"
+
+/** Read-only view of input bytes. */
+typedef struct fc_in_span
+{
+	const uint8_t* data;
+	size_t size;
+} fc_in_span;
+
+/** Writable view of output bytes. */
+typedef struct fc_out_span
+{
+	uint8_t* data;
+	size_t size;
+} fc_out_span;
+
+/** Result codes of fc_plugin::convert. */
+enum fc_status
+{
+	FC_OK = 0,
+	FC_ERROR = -1    /**< conversion failed, input is invalid */
+};
+
+/** Capability flags of conversion, unknown bits are ignored by host. */
+enum fc_conversion_flags
+{
+	/**
+	 * No state is carried between chunks: any split of input into blocks,
+	 * each converted as a separate stream (own state, ending with last call)
+	 * and concatenated in order, is a valid output. Host may then convert
+	 * blocks in parallel, each on its own state.
+	 */
+	FC_CONVERSION_CHUNK_PARALLEL = 1u << 0
+};
+
+/** Capability of single conversion. */
+typedef struct fc_conversion_info
+{
+	const char* name;           /**< unique within plugin */
+	const char* description;    /**< one line, for listing */
+	uint32_t flags;             /**< fc_conversion_flags */
+} fc_conversion_info;
+
+/** Plugin description, valid while library stays loaded. */
+typedef struct fc_plugin
+{
+	uint32_t abi_version;       /**< version used by plugin, not greater than host one */
+	uint32_t conversion_count;
+	const fc_conversion_info* conversions;
+
+	/** New conversion state, NULL on failure. */
+	void* (*create)(uint32_t conversion);
+	void (*destroy)(void* state);
+
+	/**
+	 * Convert leading part of `in` into `out`, with semantics of
+	 * Converter::convert(). Bulk call, plugin processes as much as fits.
+	 * State which finished stream (last call producing nothing) is reused
+	 * for next stream.
+	 */
+	int (*convert)(void* state, fc_in_span in, fc_out_span out, int last,
+			size_t* consumed, size_t* produced);
+
+	/** Output size sufficient for `in_size` input bytes. */
+	size_t (*output_bound)(void* state, size_t in_size);
+} fc_plugin;
+
+/** Type of FC_PLUGIN_QUERY_SYMBOL. */
+typedef const fc_plugin* (*fc_plugin_query_fn)(uint32_t host_abi_version);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONVERTER_PLUGIN_H_ */
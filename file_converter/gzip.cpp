@@ -0,0 +1,453 @@
+/**
+ * @file gzip.cpp
+ * @brief Transparent gzip decompression of inputs and compression of outputs
+ *
+ * @author Krzysztof Lasota
+ */
+
+#include "gzip.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include <zlib.h>
+
+#include "work_stealing_pool.hpp"
+
+
+namespace {
+
+/// Largest view passed to zlib in one call, counters are 32 bit.
+const std::size_t MaxZlibView = std::size_t(1) << 30;
+
+/// Window bits selecting gzip wrapper, auto-detection of gzip and zlib for inflate.
+const int GzipWindowBits = 15 + 16;
+const int AutoWindowBits = 15 + 32;
+
+const std::string GzipSuffix = ".gz";
+
+std::string zlibMessage(const z_stream& stream, const char* what)
+{
+	return std::string(what) + ": " + (stream.msg ? stream.msg : "zlib failure");
+}
+
+
+/**
+ * @brief Deflate stream producing gzip members.
+ */
+class Deflater
+{
+public:
+	explicit
+	Deflater(int level)
+	{
+		std::memset(&mStream, 0, sizeof(mStream));
+		if (deflateInit2(&mStream, level, Z_DEFLATED, GzipWindowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+			throw std::runtime_error("can not initialize deflate");
+	}
+
+	~Deflater()
+	{
+		deflateEnd(&mStream);
+	}
+
+	Deflater(const Deflater&) = delete;
+	Deflater& operator=(const Deflater&) = delete;
+
+	/// Compress `in` into sink, Z_FINISH ends gzip member and starts next one.
+	void deflateTo(Output& sink, InputView in, int flush)
+	{
+		do {
+			const InputView piece = in.first(std::min(in.size(), MaxZlibView));
+			in = in.subspan(piece.size());
+			const int pieceFlush = in.empty() ? flush : Z_NO_FLUSH;
+			mStream.next_in = const_cast<Bytef*>(piece.data());
+			mStream.avail_in = piece.size();
+
+			int status;
+			do {
+				const OutputView out = sink.reserve(OutputChunk);
+				mStream.next_out = out.data();
+				mStream.avail_out = std::min(out.size(), MaxZlibView);
+				status = deflate(&mStream, pieceFlush);
+				if (status == Z_STREAM_ERROR)
+					throw std::runtime_error(zlibMessage(mStream, "deflate"));
+				sink.commit(std::min(out.size(), MaxZlibView) - mStream.avail_out);
+			} while (mStream.avail_out == 0 || (pieceFlush == Z_FINISH && status != Z_STREAM_END));
+		} while (!in.empty());
+
+		if (flush == Z_FINISH)
+			deflateReset(&mStream);
+	}
+
+	/// Compress `in` as whole gzip member into `out`.
+	std::size_t deflateMember(InputView in, std::vector<std::uint8_t>& out)
+	{
+		const std::size_t bound = deflateBound(&mStream, in.size());
+		if (out.size() < bound)
+			out.resize(bound);
+
+		mStream.next_in = const_cast<Bytef*>(in.data());
+		mStream.avail_in = in.size();
+		mStream.next_out = out.data();
+		mStream.avail_out = out.size();
+		const int status = deflate(&mStream, Z_FINISH);
+		const std::size_t produced = out.size() - mStream.avail_out;
+		deflateReset(&mStream);
+		if (status != Z_STREAM_END)
+			throw std::runtime_error(zlibMessage(mStream, "deflate"));
+		return produced;
+	}
+
+private:
+	/// Least output space requested from sink per deflate call.
+	static constexpr std::size_t OutputChunk = std::size_t(64) << 10;
+
+	z_stream mStream;
+};
+
+} // namespace
+
+
+bool isGzipPath(const std::string& path)
+{
+	return path.size() > GzipSuffix.size()
+			&& path.compare(path.size() - GzipSuffix.size(), GzipSuffix.size(), GzipSuffix) == 0;
+}
+
+
+/**
+ * @brief Inflate stream of InflateInput.
+ */
+class InflateInput::Stream
+{
+public:
+	Stream()
+	{
+		std::memset(&z, 0, sizeof(z));
+		if (inflateInit2(&z, AutoWindowBits) != Z_OK)
+			throw std::runtime_error("can not initialize inflate");
+	}
+
+	~Stream()
+	{
+		inflateEnd(&z);
+	}
+
+	z_stream z;
+};
+
+
+InflateInput::InflateInput(std::unique_ptr<Input> source_, std::size_t bufferSize)
+ : mSource(std::move(source_))
+ , mStream(new Stream())
+ , mBuffer(std::max(bufferSize, 2 * MaxPeekSize))
+ , mHead(0)
+ , mTail(0)
+ , mEnd(false)
+{
+}
+
+
+InflateInput::~InflateInput()
+{
+}
+
+
+InputView InflateInput::peek(std::size_t minSize)
+{
+	minSize = std::max<std::size_t>(std::min(minSize, MaxPeekSize), 1);
+	while (mTail - mHead < minSize && !mEnd) {
+		// buffer holds at least 2 * MaxPeekSize, so compacted one has space for minSize
+		if (mBuffer.size() - mTail < MaxPeekSize) {
+			std::memmove(mBuffer.data(), mBuffer.data() + mHead, mTail - mHead);
+			mTail -= mHead;
+			mHead = 0;
+		}
+		mTail += inflateInto(mBuffer.data() + mTail, mBuffer.size() - mTail);
+	}
+	return InputView(mBuffer.data() + mHead, mTail - mHead);
+}
+
+
+void InflateInput::consume(std::size_t size)
+{
+	mHead += size;
+	if (mHead == mTail)
+		mHead = mTail = 0;
+}
+
+
+bool InflateInput::lastView() const
+{
+	return mEnd;
+}
+
+
+std::size_t InflateInput::read(OutputView buffer)
+{
+	std::size_t done = std::min(buffer.size(), mTail - mHead);
+	std::memcpy(buffer.data(), mBuffer.data() + mHead, done);
+	consume(done);
+
+	while (done < buffer.size() && !mEnd)
+		done += inflateInto(buffer.data() + done, buffer.size() - done);
+	return done;
+}
+
+
+std::size_t InflateInput::inflateInto(std::uint8_t* data, std::size_t size)
+{
+	z_stream& z = mStream->z;
+	std::size_t produced = 0;
+	while (produced == 0 && !mEnd) {
+		const InputView in = mSource->peek(1);
+		if (in.empty())
+			throw std::runtime_error("truncated gzip input");
+
+		z.next_in = const_cast<Bytef*>(in.data());
+		z.avail_in = std::min(in.size(), MaxZlibView);
+		const std::size_t space = std::min(size, MaxZlibView);
+		z.next_out = data;
+		z.avail_out = space;
+
+		const int status = inflate(&z, Z_NO_FLUSH);
+		mSource->consume(std::min(in.size(), MaxZlibView) - z.avail_in);
+		produced = space - z.avail_out;
+
+		if (status == Z_STREAM_END) {
+			// next gzip member, anything else (e.g. zero padding) ends input
+			const InputView next = mSource->peek(2);
+			if (next.size() < 2 || next[0] != 0x1f || next[1] != 0x8b)
+				mEnd = true;
+			else
+				inflateReset(&z);
+		}
+		else if (status != Z_OK) {
+			throw std::runtime_error(zlibMessage(z, "corrupt gzip input"));
+		}
+	}
+	return produced;
+}
+
+
+/**
+ * @brief Compression of DeflateOutput blocks, on calling thread or on pool.
+ */
+class DeflateOutput::Impl
+{
+public:
+	Impl(std::unique_ptr<Output> sink_, const DeflateConfig& config)
+	 : mSink(std::move(sink_))
+	 , mCancel(false)
+	 , mSubmitted(0)
+	 , mWritten(0)
+	{
+		const std::size_t threads = config.threads > 0
+				? config.threads : std::max(1u, std::thread::hardware_concurrency());
+		for (std::size_t idx = 0; idx < threads; ++idx)
+			mDeflaters.emplace_back(new Deflater(config.level));
+		if (threads > 1) {
+			mSlots.resize(2 * threads);
+			mPool.reset(new WorkStealingPool(threads));
+		}
+	}
+
+	~Impl()
+	{
+		// tasks refer to slots and deflaters
+		mCancel = true;
+		mPool.reset();
+	}
+
+	bool parallel() const
+	{
+		return mPool != nullptr;
+	}
+
+	/**
+	 * @brief Compress first `used` bytes of buffer.
+	 *
+	 * Parallel compression takes the buffer and leaves previously used one
+	 * in its place.
+	 */
+	void compress(std::vector<std::uint8_t>& buffer, std::size_t used, bool finish)
+	{
+		if (!parallel()) {
+			mDeflaters.front()->deflateTo(*mSink, InputView(buffer.data(), used),
+					finish ? Z_FINISH : Z_NO_FLUSH);
+			return;
+		}
+
+		// empty output still needs one member
+		if (used > 0 || (finish && mSubmitted == 0)) {
+			if (mSubmitted - mWritten == mSlots.size())
+				writeBlock(mWritten++);
+
+			Slot& slot = mSlots[mSubmitted++ % mSlots.size()];
+			slot.in.swap(buffer);
+			slot.used = used;
+			slot.done = false;
+			slot.error = nullptr;
+			mPool->submit([this, &slot]() { deflateBlock(slot); });
+		}
+		if (finish)
+			while (mWritten < mSubmitted)
+				writeBlock(mWritten++);
+	}
+
+	/// Compress without copying, on calling thread only.
+	void compressDirect(InputView data)
+	{
+		mDeflaters.front()->deflateTo(*mSink, data, Z_NO_FLUSH);
+	}
+
+	Output& sink()
+	{
+		return *mSink;
+	}
+
+private:
+	/// Block in flight, slots are reused round robin.
+	struct Slot
+	{
+		std::vector<std::uint8_t> in;
+		std::size_t used = 0;
+		std::vector<std::uint8_t> out;
+		std::size_t produced = 0;
+		bool done = false;    ///< guarded by mDoneMutex
+		std::exception_ptr error;
+	};
+
+	/// Worker task, block becomes gzip member.
+	void deflateBlock(Slot& slot)
+	{
+		try {
+			if (!mCancel)
+				slot.produced = mDeflaters[WorkStealingPool::currentWorker()]->deflateMember(
+						InputView(slot.in.data(), slot.used), slot.out);
+		}
+		catch (...) {
+			slot.error = std::current_exception();
+			mCancel = true;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mDoneMutex);
+			slot.done = true;
+		}
+		mDone.notify_all();
+	}
+
+	/// Waits for block and writes its member.
+	void writeBlock(std::size_t block)
+	{
+		Slot& slot = mSlots[block % mSlots.size()];
+		{
+			std::unique_lock<std::mutex> lock(mDoneMutex);
+			mDone.wait(lock, [&slot]() { return slot.done; });
+		}
+		if (slot.error)
+			std::rethrow_exception(slot.error);
+		mSink->write(InputView(slot.out.data(), slot.produced));
+	}
+
+	std::unique_ptr<Output> mSink;
+	std::vector<std::unique_ptr<Deflater>> mDeflaters;    ///< one per worker
+
+	std::vector<Slot> mSlots;
+	std::atomic<bool> mCancel;
+	std::size_t mSubmitted;
+	std::size_t mWritten;
+
+	std::mutex mDoneMutex;
+	std::condition_variable mDone;
+
+	std::unique_ptr<WorkStealingPool> mPool;
+};
+
+
+DeflateOutput::DeflateOutput(std::unique_ptr<Output> sink_, const DeflateConfig& config)
+ : mImpl(new Impl(std::move(sink_), config))
+ , mBuffer(std::max<std::size_t>(config.blockSize, 1))
+ , mUsed(0)
+ , mSize(0)
+ , mClosed(false)
+{
+}
+
+
+DeflateOutput::~DeflateOutput()
+{
+	try {
+		close();
+	}
+	catch (const std::exception&) {
+		// destructor must not throw, call close() explicitly to handle errors
+	}
+}
+
+
+OutputView DeflateOutput::reserve(std::size_t minSize)
+{
+	if (mBuffer.size() - mUsed < minSize) {
+		// block size is kept for following blocks, only exceptional reservation grows it
+		const std::size_t blockSize = std::max(mBuffer.size(), minSize);
+		flushBuffer(false);
+		if (mBuffer.size() < blockSize)
+			mBuffer.resize(blockSize);
+	}
+	return OutputView(mBuffer.data() + mUsed, mBuffer.size() - mUsed);
+}
+
+
+void DeflateOutput::commit(std::size_t size)
+{
+	mUsed += size;
+	mSize += size;
+}
+
+
+void DeflateOutput::write(InputView data)
+{
+	if (mImpl->parallel() || data.size() < mBuffer.size()) {
+		Output::write(data);
+		return;
+	}
+
+	flushBuffer(false);
+	mImpl->compressDirect(data);
+	mSize += data.size();
+}
+
+
+void DeflateOutput::close()
+{
+	if (mClosed)
+		return;
+	mClosed = true;
+	flushBuffer(true);
+	mImpl->sink().close();
+}
+
+
+std::uint64_t DeflateOutput::size() const
+{
+	return mSize;
+}
+
+
+void DeflateOutput::flushBuffer(bool finish)
+{
+	const std::size_t blockSize = mBuffer.size();
+	mImpl->compress(mBuffer, mUsed, finish);
+	mUsed = 0;
+	if (mBuffer.size() < blockSize)
+		mBuffer.resize(blockSize);
+}
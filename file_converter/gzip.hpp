@@ -0,0 +1,110 @@
+/**
+ * @file gzip.hpp
+ * @brief Transparent gzip decompression of inputs and compression of outputs
+ *
+ * @author Krzysztof Lasota
+ */
+
+#ifndef GZIP_HPP_
+#define GZIP_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "input.hpp"
+#include "output.hpp"
+
+
+/// True for paths with ".gz" suffix.
+bool isGzipPath(const std::string& path);
+
+
+/**
+ * @brief Input inflating gzip (or zlib) data read from other input.
+ *
+ * Compressed bytes are inflated straight from views of source (mapped
+ * file, ring buffer) into own buffer, bulk read() inflates directly into
+ * caller's buffer. Concatenated gzip members are read as one stream, data
+ * following the last member that is not gzip member is ignored.
+ */
+class InflateInput : public Input
+{
+public:
+	static constexpr std::size_t DefaultBufferSize = std::size_t(1) << 20;
+
+	/// @throw std::runtime_error when inflate can not be initialized
+	explicit
+	InflateInput(std::unique_ptr<Input> source_, std::size_t bufferSize = DefaultBufferSize);
+
+	~InflateInput();
+
+	/// @throw std::runtime_error for corrupted or truncated compressed data
+	InputView peek(std::size_t minSize = 1) override;
+	void consume(std::size_t size) override;
+	bool lastView() const override;
+	std::size_t read(OutputView buffer) override;
+
+private:
+	/// Inflate into buffer, produces at least one byte unless at end.
+	std::size_t inflateInto(std::uint8_t* data, std::size_t size);
+
+	class Stream;
+
+	std::unique_ptr<Input> mSource;
+	std::unique_ptr<Stream> mStream;
+	std::vector<std::uint8_t> mBuffer;
+	std::size_t mHead;
+	std::size_t mTail;
+	bool mEnd;    ///< source ended with complete member
+};
+
+
+struct DeflateConfig
+{
+	int level = 6;                                  ///< zlib compression level, 0-9
+	std::size_t threads = 1;                        ///< 0 for hardware concurrency
+	std::size_t blockSize = std::size_t(1) << 20;  ///< uncompressed bytes per deflate call or member
+};
+
+/**
+ * @brief Output compressing committed data into gzip format of other output.
+ *
+ * With single thread data is deflated as one member, in blocks of
+ * config.blockSize, bulk write() is deflated without copying. With more
+ * threads every block is deflated on WorkStealingPool as independent gzip
+ * member and members are written in order; concatenated members are
+ * valid gzip file at cost of slightly worse ratio.
+ */
+class DeflateOutput : public Output
+{
+public:
+	/// @throw std::runtime_error when deflate can not be initialized
+	DeflateOutput(std::unique_ptr<Output> sink_, const DeflateConfig& config = DeflateConfig());
+
+	~DeflateOutput();
+
+	OutputView reserve(std::size_t minSize) override;
+	void commit(std::size_t size) override;
+	void write(InputView data) override;
+	/// Finishes compressed stream and closes sink.
+	void close() override;
+	/// Uncompressed bytes committed so far.
+	std::uint64_t size() const override;
+
+private:
+	/// Compress buffered data, which may be last.
+	void flushBuffer(bool finish);
+
+	class Impl;
+
+	std::unique_ptr<Impl> mImpl;
+	std::vector<std::uint8_t> mBuffer;
+	std::size_t mUsed;
+	std::uint64_t mSize;
+	bool mClosed;
+};
+
+#endif /* GZIP_HPP_ */
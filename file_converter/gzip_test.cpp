@@ -0,0 +1,141 @@
+/**
+ * @file gzip_test.cpp
+ * @brief Test for gzip compressed inputs and outputs
+ *
+ * @author Krzysztof Lasota
+ */
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+
+#include "conversion.hpp"
+#include "converter.hpp"
+#include "gzip.hpp"
+#include "test_utils.hpp"
+
+using namespace test;
+
+
+namespace {
+
+/// Compress data into file with given settings.
+void compress(const std::string& path, const std::string& data, const DeflateConfig& config)
+{
+	DeflateOutput output(Output::open(path), config);
+	output.write(InputView(reinterpret_cast<const std::uint8_t*>(data.data()), data.size()));
+	output.close();
+}
+
+std::string decompress(std::unique_ptr<Input> source)
+{
+	InflateInput input(std::move(source), 1000);
+	std::string data;
+	for (InputView view; !(view = input.peek(100)).empty(); input.consume(view.size()))
+		data.append(view.begin(), view.end());
+	return data;
+}
+
+DeflateConfig smallBlocks(std::size_t threads)
+{
+	DeflateConfig config;
+	config.threads = threads;
+	config.blockSize = 10000;
+	return config;
+}
+
+std::size_t countMembers(const std::string& gzip)
+{
+	std::size_t count = 0;
+	for (std::size_t pos = 0; (pos = gzip.find("\x1f\x8b\x08", pos)) != std::string::npos; ++pos)
+		++count;
+	return count;
+}
+
+} // namespace
+
+
+TEST(Gzip_Test, T01_GzipPath)
+{
+	EXPECT_TRUE(isGzipPath("a.gz"));
+	EXPECT_TRUE(isGzipPath("dir/a.txt.gz"));
+	EXPECT_FALSE(isGzipPath(".gz"));
+	EXPECT_FALSE(isGzipPath("a.gzip"));
+}
+
+TEST(Gzip_Test, T02_SingleMemberRoundTrip)
+{
+	TempFile file;
+	const std::string data = patternData(1000000);
+	compress(file.path(), data, smallBlocks(1));
+
+	EXPECT_GT(data.size() / 10, file.read().size());
+	EXPECT_EQ(data, decompress(Input::open(file.path())));
+}
+
+TEST(Gzip_Test, T03_ParallelMembersFromPipe)
+{
+	TempFile file;
+	const std::string data = patternData(1000000);
+	compress(file.path(), data, smallBlocks(3));
+	const std::string gzip = file.read();
+	EXPECT_LE(100u, countMembers(gzip));
+
+	PipeWriter writer(gzip);
+	EXPECT_EQ(data, decompress(Input::fromDescriptor(writer.readFd(), true)));
+}
+
+TEST(Gzip_Test, T04_EmptyOutputIsValid)
+{
+	TempFile serial, parallel;
+	compress(serial.path(), "", smallBlocks(1));
+	compress(parallel.path(), "", smallBlocks(2));
+
+	EXPECT_EQ("", decompress(Input::open(serial.path())));
+	EXPECT_EQ("", decompress(Input::open(parallel.path())));
+}
+
+TEST(Gzip_Test, T05_ConversionThroughCompression)
+{
+	TempFile source, target;
+	const std::string data = patternData(300001);
+	compress(source.path(), data, smallBlocks(1));
+
+	std::unique_ptr<Converter> converter = Converter::create("upper");
+	InflateInput input(Input::open(source.path()));
+	DeflateOutput output(Output::open(target.path()), smallBlocks(2));
+	const ConversionStats stats = convert(input, *converter, output);
+	output.close();
+
+	EXPECT_EQ(data.size(), stats.bytesOut);
+	EXPECT_EQ(convertString(*converter, data), decompress(Input::open(target.path())));
+}
+
+TEST(Gzip_Test, T06_CorruptAndTruncatedInput)
+{
+	TempFile file;
+	compress(file.path(), patternData(100000), smallBlocks(1));
+	std::string gzip = file.read();
+
+	file.write(gzip.substr(0, gzip.size() / 2));
+	EXPECT_THROW(decompress(Input::open(file.path())), std::runtime_error);
+
+	gzip[gzip.size() / 2] ^= 0x55;
+	file.write(gzip);
+	EXPECT_THROW(decompress(Input::open(file.path())), std::runtime_error);
+}
+
+TEST(Gzip_Test, T07_TrailingDataAfterLastMemberIgnored)
+{
+	TempFile file;
+	const std::string data = patternData(100000);
+	compress(file.path(), data, smallBlocks(1));
+	const std::string gzip = file.read();
+
+	file.write(gzip + std::string(4096, '\0'));
+	EXPECT_EQ(data, decompress(Input::open(file.path())));
+
+	file.write(gzip + gzip + "x");
+	EXPECT_EQ(data + data, decompress(Input::open(file.path())));
+}
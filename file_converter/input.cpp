@@ -0,0 +1,290 @@
+/**
+ * @file input.cpp
+ * @brief Memory mapped and ring buffered inputs
+ *
+ * @author Krzysztof Lasota
+ */
+
+#include "input.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace {
+
+std::system_error systemError(const std::string& what)
+{
+	return std::system_error(errno, std::generic_category(), what);
+}
+
+
+/**
+ * @brief Regular file mapped read-only as a whole.
+ */
+class MappedInput : public Input
+{
+public:
+	MappedInput(int fd, bool owned, std::size_t size, std::size_t offset)
+	 : mData(nullptr)
+	 , mSize(size)
+	 , mStart(std::min(offset, size))
+	 , mOffset(mStart)
+	{
+		if (mSize > 0) {
+			void* data = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (data == MAP_FAILED) {
+				const std::system_error error = systemError("mmap input");
+				if (owned)
+					::close(fd);
+				throw error;
+			}
+			madvise(data, mSize, MADV_SEQUENTIAL);
+			mData = static_cast<const std::uint8_t*>(data);
+		}
+		// mapping stays valid after descriptor is closed
+		if (owned)
+			::close(fd);
+	}
+
+	~MappedInput()
+	{
+		if (mData)
+			munmap(const_cast<std::uint8_t*>(mData), mSize);
+	}
+
+	InputView peek(std::size_t) override
+	{
+		return InputView(mData + mOffset, mSize - mOffset);
+	}
+
+	void consume(std::size_t size) override
+	{
+		mOffset += size;
+	}
+
+	bool lastView() const override
+	{
+		return true;
+	}
+
+	std::uint64_t sizeHint() const override
+	{
+		return mSize - mStart;
+	}
+
+	bool stableViews() const override
+	{
+		return true;
+	}
+
+private:
+	const std::uint8_t* mData;
+	std::size_t mSize;
+	std::size_t mStart;     ///< descriptor offset when opened, not part of input
+	std::size_t mOffset;
+};
+
+
+/**
+ * @brief Descriptor read into ring buffer.
+ *
+ * Storage is guard area followed by the ring. When view requested by peek()
+ * would wrap around the ring, the short part before the end of the ring is
+ * copied into guard area, right in front of the wrapped part.
+ */
+class RingInput : public Input
+{
+public:
+	RingInput(int fd, bool owned, std::size_t ringSize)
+	 : mFd(fd)
+	 , mOwned(owned)
+	 , mStorage(MaxPeekSize + std::max(ringSize, MaxPeekSize))
+	 , mCapacity(mStorage.size() - MaxPeekSize)
+	 , mHead(0)
+	 , mTail(0)
+	 , mEof(false)
+	 , mLast(false)
+	{
+	}
+
+	~RingInput()
+	{
+		if (mOwned)
+			::close(mFd);
+	}
+
+	InputView peek(std::size_t minSize) override
+	{
+		minSize = std::min(std::max<std::size_t>(minSize, 1), MaxPeekSize);
+
+		while (available() < minSize && !mEof)
+			fill();
+
+		const std::size_t pos = mHead % mCapacity;
+		const std::size_t untilEnd = mCapacity - pos;
+		const std::uint8_t* ring = ringBegin();
+
+		if (available() <= untilEnd) {
+			mLast = mEof;
+			return InputView(ring + pos, available());
+		}
+		if (untilEnd >= minSize) {
+			mLast = false;
+			return InputView(ring + pos, untilEnd);
+		}
+
+		// join short tail of the ring with wrapped data
+		std::uint8_t* start = ringBegin() - untilEnd;
+		std::memmove(start, ring + pos, untilEnd);
+		mLast = mEof;
+		return InputView(start, available());
+	}
+
+	void consume(std::size_t size) override
+	{
+		mHead += size;
+	}
+
+	bool lastView() const override
+	{
+		return mLast;
+	}
+
+	/// Buffered bytes first, then directly from descriptor into buffer.
+	std::size_t read(OutputView buffer) override
+	{
+		std::size_t done = 0;
+		while (done < buffer.size() && available() > 0) {
+			const InputView view = peek(1);
+			const std::size_t size = std::min(view.size(), buffer.size() - done);
+			std::memcpy(buffer.data() + done, view.data(), size);
+			consume(size);
+			done += size;
+		}
+		while (done < buffer.size() && !mEof) {
+			const std::size_t count = readSome(buffer.data() + done, buffer.size() - done);
+			mHead += count;
+			mTail += count;
+			done += count;
+		}
+		return done;
+	}
+
+private:
+	std::size_t available() const
+	{
+		return mTail - mHead;
+	}
+
+	std::uint8_t* ringBegin()
+	{
+		return mStorage.data() + MaxPeekSize;
+	}
+
+	/// Single read into contiguous free space of the ring.
+	void fill()
+	{
+		const std::size_t pos = mTail % mCapacity;
+		const std::size_t space = std::min(mCapacity - available(), mCapacity - pos);
+
+		mTail += readSome(ringBegin() + pos, space);
+	}
+
+	/// Single read from descriptor, sets end of input flag.
+	std::size_t readSome(std::uint8_t* buffer, std::size_t size)
+	{
+		ssize_t count;
+		do {
+			count = ::read(mFd, buffer, size);
+		} while (count < 0 && errno == EINTR);
+
+		if (count < 0)
+			throw systemError("read input");
+		if (count == 0)
+			mEof = true;
+		return count;
+	}
+
+	int mFd;
+	bool mOwned;
+	std::vector<std::uint8_t> mStorage;
+	std::size_t mCapacity;
+	std::uint64_t mHead;    ///< stream offset of first unread byte
+	std::uint64_t mTail;    ///< stream offset of first byte not yet read
+	bool mEof;
+	bool mLast;
+};
+
+} // namespace
+
+
+constexpr std::size_t Input::DefaultRingSize;
+constexpr std::size_t Input::MaxPeekSize;
+
+
+std::unique_ptr<Input> Input::open(const std::string& path, std::size_t ringSize)
+{
+	if (path == "-")
+		return fromDescriptor(STDIN_FILENO, false, ringSize);
+
+	const int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		throw systemError("open " + path);
+	return fromDescriptor(fd, true, ringSize);
+}
+
+
+std::unique_ptr<Input> Input::fromDescriptor(int fd, bool owned, std::size_t ringSize)
+{
+	struct stat info;
+	if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode)) {
+		// redirected standard input may be already partially read
+		const off_t offset = lseek(fd, 0, SEEK_CUR);
+		return std::unique_ptr<Input>(new MappedInput(fd, owned, info.st_size,
+				offset > 0 ? offset : 0));
+	}
+
+	return std::unique_ptr<Input>(new RingInput(fd, owned, ringSize));
+}
+
+
+Input::~Input()
+{
+}
+
+
+std::uint64_t Input::sizeHint() const
+{
+	return 0;
+}
+
+
+bool Input::stableViews() const
+{
+	return false;
+}
+
+
+std::size_t Input::read(OutputView buffer)
+{
+	std::size_t done = 0;
+	while (done < buffer.size()) {
+		const InputView view = peek();
+		if (view.empty())
+			break;
+		const std::size_t size = std::min(view.size(), buffer.size() - done);
+		std::memcpy(buffer.data() + done, view.data(), size);
+		consume(size);
+		done += size;
+	}
+	return done;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file input.hpp
+ * @brief Sources of bytes for conversion
+ *
+ * @author Krzysztof Lasota
+ */
+
+#ifndef INPUT_HPP_
+#define INPUT_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "span.hpp"
+
+
+/**
+ * @brief Source of bytes read in place.
+ *
+ * Readers look at unread bytes with peek() and release them with consume(),
+ * so data is never copied out of the source buffer. Regular files are
+ * memory mapped as a whole, other descriptors (pipes, terminals, sockets)
+ * are read into ring buffer.
+ */
+class Input
+{
+public:
+	static constexpr std::size_t DefaultRingSize = std::size_t(8) << 20;
+	/// Longest view guaranteed by peek() across end of ring buffer.
+	static constexpr std::size_t MaxPeekSize = std::size_t(64) << 10;
+
+	/**
+	 * @brief Open file for reading, "-" stands for standard input.
+	 * @throw std::system_error when file can not be opened or mapped
+	 */
+	static std::unique_ptr<Input> open(const std::string& path,
+			std::size_t ringSize = DefaultRingSize);
+
+	/**
+	 * @brief Read from already opened descriptor.
+	 * @param owned close descriptor with the input
+	 * @throw std::system_error when regular file can not be mapped
+	 */
+	static std::unique_ptr<Input> fromDescriptor(int fd, bool owned,
+			std::size_t ringSize = DefaultRingSize);
+
+	virtual ~Input();
+
+	/**
+	 * @brief Contiguous unread bytes, waits for data when needed.
+	 * @param minSize bytes expected in view, fewer only at end of input;
+	 *        limited to MaxPeekSize
+	 * @return view valid until next call of peek() or consume(),
+	 *         empty at end of input
+	 * @throw std::system_error when reading fails
+	 */
+	virtual InputView peek(std::size_t minSize = 1) = 0;
+
+	/// Release first `size` bytes of view returned by last peek().
+	virtual void consume(std::size_t size) = 0;
+
+	/// True when view returned by last peek() reaches end of input.
+	virtual bool lastView() const = 0;
+
+	/// Total size of input when known up front, 0 otherwise.
+	virtual std::uint64_t sizeHint() const;
+
+	/// True when views returned by peek() stay valid until input is destroyed.
+	virtual bool stableViews() const;
+
+	/**
+	 * @brief Copy unread bytes into buffer owned by caller.
+	 * @return bytes copied, less than buffer size only at end of input
+	 * @throw std::system_error when reading fails
+	 */
+	virtual std::size_t read(OutputView buffer);
+};
+
+#endif /* INPUT_HPP_ */
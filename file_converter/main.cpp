@@ -1,10 +1,267 @@
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "batch.hpp"
+#include "conversion.hpp"
+#include "converter.hpp"
+#include "gzip.hpp"
+#include "input.hpp"
+#include "output.hpp"
+#include "parallel.hpp"
+#include "pipeline.hpp"
+#include "plugin_registry.hpp"
+#include "profiler.hpp"
+#include "stream_buffer.hpp"
+
+static void printUsage(const char* appl)
+{
+	std::cerr << "Usage: " << appl << " [-c CONVERSION] [-o OUTPUT] [-p DIR]... [-t] [-j THREADS] [-z THREADS] [-v] [-R REPORT] [-T TRACE] [-l] [INPUT]\n"
+			"       " << appl << " -b [-c CONVERSION] [-p DIR]... [-j THREADS] -o OUTPUT_DIR INPUT_DIR\n"
+			"       " << appl << " -m MANIFEST [-c CONVERSION] [-p DIR]... [-j THREADS]\n"
+			"  INPUT          file to convert, \"-\" or none for standard input\n"
+			"  -c CONVERSION  conversion type (default copy), PLUGIN[:NAME] for plugins\n"
+			"  -o OUTPUT      converted file, \"-\" or none for standard output\n"
+			"  -p DIR         search plugins (fc_PLUGIN.so) in DIR before directories\n"
+			"                 listed in " << PluginRegistry::PathVariable << "\n"
+			"  -t             read, convert and write in parallel threads\n"
+			"  -z THREADS     compress OUTPUT.gz as independent blocks on THREADS cores\n"
+			"                 (default 1, 0 for all); INPUT.gz is always decompressed\n"
+			"  -j THREADS     convert blocks on THREADS cores (0 for all) when conversion\n"
+			"                 has no state between chunks, otherwise as without -j;\n"
+			"                 number of batch workers (default all cores)\n"
+			"  -b             convert all files under INPUT_DIR into OUTPUT_DIR\n"
+			"  -m MANIFEST    convert files listed as INPUT<TAB>OUTPUT lines\n"
+			"  -v             print progress line every second on standard error\n"
+			"  -R REPORT      write JSON report of bytes, stage times, stalls and queue\n"
+			"                 occupancy, \"-\" for standard error\n"
+			"  -T TRACE       write Chrome trace-event JSON of stages\n"
+			"  -l             list conversion types\n";
+}
+
+struct Options
+{
+	std::string conversion = "copy";
+	std::string input = "-";
+	std::string output = "-";
+	std::vector<std::string> pluginDirs;
+	bool pipelined = false;
+	unsigned long deflateThreads = 1;
+	long threads = -1;    ///< not given
+	bool batch = false;
+	std::string manifest;
+	bool progress = false;
+	std::string report;
+	std::string trace;
+	bool list = false;
+};
+
+/// Write report of profiler into file, "-" for standard error, nothing for empty path.
+static void writeProfile(const std::string& path, const Profiler& profiler,
+		void (Profiler::*writer)(std::ostream&) const)
+{
+	if (path.empty())
+		return;
+	if (path == "-") {
+		(profiler.*writer)(std::cerr);
+		return;
+	}
+
+	std::ofstream out(path);
+	(profiler.*writer)(out);
+	if (!out.flush())
+		throw std::runtime_error("can not write " + path);
+}
+
+/// True when both paths name the same existing file, "-" is never the same.
+static bool sameFile(const std::string& first, const std::string& second)
+{
+	if (first == "-" || second == "-")
+		return false;
+	struct stat firstInfo;
+	struct stat secondInfo;
+	return stat(first.c_str(), &firstInfo) == 0 && stat(second.c_str(), &secondInfo) == 0
+			&& firstInfo.st_dev == secondInfo.st_dev && firstInfo.st_ino == secondInfo.st_ino;
+}
+
+/**
+ * @brief Convert files of directory tree or manifest, report throughput.
+ * @return exit status, failure when any file failed
+ */
+static int runBatch(const Options& opts, PluginRegistry& registry)
+{
+	std::vector<BatchJob> jobs;
+	if (opts.batch) {
+		jobs = walkDirectory(opts.input, opts.output);
+	}
+	else if (opts.manifest == "-") {
+		jobs = readManifest(std::cin);
+	}
+	else {
+		std::ifstream manifest(opts.manifest);
+		if (!manifest)
+			throw std::runtime_error("can not open manifest " + opts.manifest);
+		jobs = readManifest(manifest);
+	}
+
+	BatchConfig config;
+	config.threads = opts.threads > 0 ? opts.threads : 0;
+	const BatchStats stats = convertBatch(jobs,
+			[&]() { return registry.create(opts.conversion); }, config);
+
+	for (const BatchFailure& failure : stats.failures)
+		std::cerr << failure.path << ": " << failure.reason << '\n';
+	std::cerr << std::fixed << std::setprecision(1)
+			<< stats.files << " files, " << stats.bytesIn / 1e6 << " MB in "
+			<< std::setprecision(3) << stats.seconds << " s ("
+			<< std::setprecision(1) << stats.filesPerSecond() << " files/s, "
+			<< stats.megabytesPerSecond() << " MB/s)";
+	if (!stats.failures.empty())
+		std::cerr << ", " << stats.failures.size() << " failed";
+	std::cerr << '\n';
+	return stats.failures.empty() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
 
 /**
  * @brief main application function
  */
-int main()
+int main(int argc, char** argv)
 {
-	std::cout << "Hello World!" << std::endl;
-	return 0;
+	unsyncStandardStreams();
+	Options opts;
+
+	int opt;
+	while ((opt = getopt(argc, argv, "c:o:p:tj:z:bm:vR:T:lh")) != -1) {
+		switch (opt) {
+		case 'c':
+			opts.conversion = optarg;
+			break;
+		case 'o':
+			opts.output = optarg;
+			break;
+		case 'p':
+			opts.pluginDirs.push_back(optarg);
+			break;
+		case 't':
+			opts.pipelined = true;
+			break;
+		case 'z':
+			opts.deflateThreads = std::strtoul(optarg, nullptr, 10);
+			break;
+		case 'j':
+			opts.threads = std::strtol(optarg, nullptr, 10);
+			break;
+		case 'b':
+			opts.batch = true;
+			break;
+		case 'm':
+			opts.manifest = optarg;
+			break;
+		case 'v':
+			opts.progress = true;
+			break;
+		case 'R':
+			opts.report = optarg;
+			break;
+		case 'T':
+			opts.trace = optarg;
+			break;
+		case 'l':
+			opts.list = true;
+			break;
+		default:
+			printUsage(argv[0]);
+			return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+	const bool batch = opts.batch || !opts.manifest.empty();
+	// batch conversion reports its own summary, instrumentation is for single file
+	const bool instrumented = opts.progress || !opts.report.empty() || !opts.trace.empty();
+	if (optind + 1 < argc || (opts.batch && (optind == argc || opts.output == "-"))
+			|| (!opts.manifest.empty() && optind < argc) || (batch && instrumented)) {
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+	if (optind < argc)
+		opts.input = argv[optind];
+
+	const std::vector<std::string> envDirs = PluginRegistry::environmentDirs();
+	opts.pluginDirs.insert(opts.pluginDirs.end(), envDirs.begin(), envDirs.end());
+
+	try {
+		// plugins are loaded only when conversion needs them
+		PluginRegistry registry(opts.pluginDirs);
+		if (opts.list) {
+			for (const auto& conversion : registry.list())
+				std::cout << conversion.first << '\t' << conversion.second << '\n';
+			return EXIT_SUCCESS;
+		}
+
+		if (batch)
+			return runBatch(opts, registry);
+
+		// output is truncated before input is read
+		if (sameFile(opts.input, opts.output))
+			throw std::runtime_error(opts.output + " is the same file as input");
+
+		std::unique_ptr<Converter> converter = registry.create(opts.conversion);
+		std::unique_ptr<Input> input = Input::open(opts.input);
+		if (isGzipPath(opts.input))
+			input.reset(new InflateInput(std::move(input)));
+		std::unique_ptr<Output> output = Output::open(opts.output);
+		if (isGzipPath(opts.output)) {
+			DeflateConfig config;
+			config.threads = opts.deflateThreads;
+			output.reset(new DeflateOutput(std::move(output), config));
+		}
+
+		std::unique_ptr<Profiler> profiler;
+		if (instrumented) {
+			ProfilerConfig config;
+			config.progressInterval = opts.progress ? 1.0 : 0.0;
+			config.progress = &std::cerr;
+			config.trace = !opts.trace.empty();
+			profiler.reset(new Profiler(config));
+		}
+
+		if (opts.threads >= 0 && opts.threads != 1 && converter->chunkParallel()) {
+			ParallelConfig config;
+			config.threads = opts.threads;
+			config.profiler = profiler.get();
+			convertParallel(*input, [&]() { return registry.create(opts.conversion); }, *output, config);
+		}
+		else if (opts.pipelined) {
+			PipelineConfig config;
+			config.profiler = profiler.get();
+			convertPipelined(*input, *converter, *output, config);
+		}
+		else {
+			convert(*input, *converter, *output, DefaultChunkSize, profiler.get());
+		}
+		{
+			// compression of last block and flush are part of writing
+			Profiler::Scope scope(profiler.get(), Profiler::Write);
+			output->close();
+		}
+
+		if (profiler) {
+			profiler->finish();
+			writeProfile(opts.report, *profiler, &Profiler::writeReport);
+			writeProfile(opts.trace, *profiler, &Profiler::writeTrace);
+		}
+	}
+	catch (const std::exception& e) {
+		std::cerr << argv[0] << ": " << e.what() << '\n';
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
 }
@@ -0,0 +1,317 @@
+/**
+ * @file output.cpp
+ * @brief Memory mapped and gathered (writev) outputs
+ *
+ * @author Krzysztof Lasota
+ */
+
+#include "output.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+
+namespace {
+
+std::system_error systemError(const std::string& what)
+{
+	return std::system_error(errno, std::generic_category(), what);
+}
+
+
+/**
+ * @brief Regular file written through shared mapping.
+ *
+ * File is extended ahead of written data in growing steps and truncated
+ * to committed size on close().
+ */
+class MappedOutput : public Output
+{
+public:
+	/// Smallest extension of the file, amortizes remapping.
+	static constexpr std::size_t MinGrowSize = std::size_t(16) << 20;
+
+	MappedOutput(int fd, bool owned)
+	 : mFd(fd)
+	 , mOwned(owned)
+	 , mData(nullptr)
+	 , mCapacity(0)
+	 , mSize(0)
+	{
+	}
+
+	~MappedOutput()
+	{
+		try {
+			close();
+		}
+		catch (const std::exception&) {
+			// destructor must not throw, call close() explicitly to handle errors
+		}
+	}
+
+	OutputView reserve(std::size_t minSize) override
+	{
+		if (mCapacity - mSize < minSize)
+			grow(std::max(std::max(mCapacity * 2, mSize + minSize), MinGrowSize));
+		return OutputView(mData + mSize, mCapacity - mSize);
+	}
+
+	void commit(std::size_t size) override
+	{
+		mSize += size;
+	}
+
+	void close() override
+	{
+		if (mFd < 0)
+			return;
+
+		const int fd = mFd;
+		mFd = -1;
+		if (mData)
+			munmap(mData, mCapacity);
+		mData = nullptr;
+
+		if (ftruncate(fd, mSize) != 0) {
+			const std::system_error error = systemError("truncate output");
+			if (mOwned)
+				::close(fd);
+			throw error;
+		}
+		if (mOwned)
+			::close(fd);
+	}
+
+	std::uint64_t size() const override
+	{
+		return mSize;
+	}
+
+private:
+	void grow(std::size_t capacity)
+	{
+		if (ftruncate(mFd, capacity) != 0)
+			throw systemError("extend output");
+		if (mData)
+			munmap(mData, mCapacity);
+		mData = nullptr;
+		mCapacity = 0;
+
+		void* data = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, mFd, 0);
+		if (data == MAP_FAILED)
+			throw systemError("mmap output");
+		mData = static_cast<std::uint8_t*>(data);
+		mCapacity = capacity;
+	}
+
+	int mFd;
+	bool mOwned;
+	std::uint8_t* mData;
+	std::size_t mCapacity;
+	std::size_t mSize;
+};
+
+constexpr std::size_t MappedOutput::MinGrowSize;
+
+
+/**
+ * @brief Descriptor written from list of blocks with single writev() call.
+ */
+class GatherOutput : public Output
+{
+public:
+	/// Blocks filled before they are written together.
+	static constexpr std::size_t MaxBlocks = 16;
+
+	GatherOutput(int fd, bool owned, std::size_t blockSize)
+	 : mFd(fd)
+	 , mOwned(owned)
+	 , mBlocks(MaxBlocks, std::vector<std::uint8_t>(std::max<std::size_t>(blockSize, 1)))
+	 , mUsed(MaxBlocks, 0)
+	 , mCurrent(0)
+	 , mSize(0)
+	{
+	}
+
+	~GatherOutput()
+	{
+		try {
+			close();
+		}
+		catch (const std::exception&) {
+			// destructor must not throw, call close() explicitly to handle errors
+		}
+	}
+
+	OutputView reserve(std::size_t minSize) override
+	{
+		if (mBlocks[mCurrent].size() - mUsed[mCurrent] < minSize) {
+			if (mUsed[mCurrent] > 0 && ++mCurrent == MaxBlocks)
+				flush();
+			// oversized requests get bigger block, it is reused afterwards
+			if (mBlocks[mCurrent].size() < minSize)
+				mBlocks[mCurrent].resize(minSize);
+		}
+		std::vector<std::uint8_t>& block = mBlocks[mCurrent];
+		return OutputView(block.data() + mUsed[mCurrent], block.size() - mUsed[mCurrent]);
+	}
+
+	void commit(std::size_t size) override
+	{
+		mUsed[mCurrent] += size;
+		mSize += size;
+	}
+
+	/// Large buffers are written in place, together with pending blocks.
+	void write(InputView data) override
+	{
+		if (data.size() < mBlocks[mCurrent].size()) {
+			Output::write(data);
+			return;
+		}
+		flush(data);
+		mSize += data.size();
+	}
+
+	void close() override
+	{
+		if (mFd < 0)
+			return;
+
+		try {
+			flush();
+		}
+		catch (const std::exception&) {
+			if (mOwned)
+				::close(mFd);
+			mFd = -1;
+			throw;
+		}
+		if (mOwned)
+			::close(mFd);
+		mFd = -1;
+	}
+
+	std::uint64_t size() const override
+	{
+		return mSize;
+	}
+
+private:
+	/// Write committed blocks followed by `tail`.
+	void flush(InputView tail = InputView())
+	{
+		iovec iov[MaxBlocks + 1];
+		int count = 0;
+		for (std::size_t idx = 0; idx < MaxBlocks && mUsed[idx] > 0; ++idx) {
+			iov[count].iov_base = mBlocks[idx].data();
+			iov[count].iov_len = mUsed[idx];
+			++count;
+		}
+		if (!tail.empty()) {
+			iov[count].iov_base = const_cast<std::uint8_t*>(tail.data());
+			iov[count].iov_len = tail.size();
+			++count;
+		}
+
+		// partial writes resume inside of the first unwritten block
+		iovec* pending = iov;
+		while (count > 0) {
+			const ssize_t written = writev(mFd, pending, count);
+			if (written < 0) {
+				if (errno == EINTR)
+					continue;
+				throw systemError("write output");
+			}
+			std::size_t left = written;
+			while (count > 0 && left >= pending->iov_len) {
+				left -= pending->iov_len;
+				++pending;
+				--count;
+			}
+			if (count > 0) {
+				pending->iov_base = static_cast<std::uint8_t*>(pending->iov_base) + left;
+				pending->iov_len -= left;
+			}
+		}
+
+		std::fill(mUsed.begin(), mUsed.end(), 0);
+		mCurrent = 0;
+	}
+
+	int mFd;
+	bool mOwned;
+	std::vector<std::vector<std::uint8_t>> mBlocks;
+	std::vector<std::size_t> mUsed;    ///< committed bytes in each block
+	std::size_t mCurrent;
+	std::uint64_t mSize;
+};
+
+constexpr std::size_t GatherOutput::MaxBlocks;
+
+
+/// Mapping replaces file content from its beginning, so only fresh
+/// read-write descriptors positioned at the start qualify.
+bool isMappable(int fd)
+{
+	struct stat info;
+	if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode))
+		return false;
+
+	const int flags = fcntl(fd, F_GETFL);
+	return flags >= 0 && (flags & O_ACCMODE) == O_RDWR && !(flags & O_APPEND)
+			&& lseek(fd, 0, SEEK_CUR) == 0;
+}
+
+} // namespace
+
+
+constexpr std::size_t Output::DefaultBlockSize;
+
+
+std::unique_ptr<Output> Output::open(const std::string& path, std::size_t blockSize)
+{
+	if (path == "-")
+		return fromDescriptor(STDOUT_FILENO, false, blockSize);
+
+	const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0666);
+	if (fd < 0)
+		throw systemError("open " + path);
+	return fromDescriptor(fd, true, blockSize);
+}
+
+
+std::unique_ptr<Output> Output::fromDescriptor(int fd, bool owned, std::size_t blockSize)
+{
+	if (isMappable(fd))
+		return std::unique_ptr<Output>(new MappedOutput(fd, owned));
+
+	return std::unique_ptr<Output>(new GatherOutput(fd, owned, blockSize));
+}
+
+
+Output::~Output()
+{
+}
+
+
+void Output::write(InputView data)
+{
+	while (!data.empty()) {
+		const OutputView view = reserve(1);
+		const std::size_t size = std::min(view.size(), data.size());
+		std::memcpy(view.data(), data.data(), size);
+		commit(size);
+		data = data.subspan(size);
+	}
+}
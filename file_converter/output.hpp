@@ -0,0 +1,76 @@
+/**
+ * @file output.hpp
+ * @brief Destinations of converted bytes
+ *
+ * @author Krzysztof Lasota
+ */
+
+#ifndef OUTPUT_HPP_
+#define OUTPUT_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "span.hpp"
+
+
+/**
+ * @brief Destination of bytes written in place.
+ *
+ * Writers ask for free space with reserve(), fill it and publish it with
+ * commit(), so converted data is produced directly in its final buffer.
+ * Regular files are memory mapped and grown as needed, other descriptors
+ * (pipes, terminals, sockets) are written with writev() from a list of
+ * buffers.
+ */
+class Output
+{
+public:
+	static constexpr std::size_t DefaultBlockSize = std::size_t(1) << 20;
+
+	/**
+	 * @brief Create (truncate) file for writing, "-" stands for standard output.
+	 * @throw std::system_error when file can not be opened
+	 */
+	static std::unique_ptr<Output> open(const std::string& path,
+			std::size_t blockSize = DefaultBlockSize);
+
+	/**
+	 * @brief Write to already opened descriptor.
+	 * @param owned close descriptor with the output
+	 */
+	static std::unique_ptr<Output> fromDescriptor(int fd, bool owned,
+			std::size_t blockSize = DefaultBlockSize);
+
+	/// Closes output, errors are ignored; call close() to handle them.
+	virtual ~Output();
+
+	/**
+	 * @brief Free space for at least `minSize` bytes.
+	 * @return view valid until next call of reserve(), commit() or close()
+	 * @throw std::system_error when output can not be grown or flushed
+	 */
+	virtual OutputView reserve(std::size_t minSize) = 0;
+
+	/// Publish first `size` bytes of view returned by last reserve().
+	virtual void commit(std::size_t size) = 0;
+
+	/**
+	 * @brief Append bytes held in buffer owned by caller.
+	 * @throw std::system_error when output can not be grown or flushed
+	 */
+	virtual void write(InputView data);
+
+	/**
+	 * @brief Write all committed bytes and release the output.
+	 * @throw std::system_error when writing fails
+	 */
+	virtual void close() = 0;
+
+	/// Bytes committed so far.
+	virtual std::uint64_t size() const = 0;
+};
+
+#endif /* OUTPUT_HPP_ */
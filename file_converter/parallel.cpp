@@ -0,0 +1,183 @@
+/**
+ * @file parallel.cpp
+ * @brief Block-parallel conversion for converters without cross-chunk state
+ *
+ * @author Krzysztof Lasota
+ */
+
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "converter.hpp"
+#include "input.hpp"
+#include "output.hpp"
+#include "profiler.hpp"
+#include "work_stealing_pool.hpp"
+
+
+namespace {
+
+/// Block in flight, slots are reused round robin.
+struct Slot
+{
+	std::vector<std::uint8_t> in;     ///< copy of input, unused for mapped input
+	InputView view;
+	std::vector<std::uint8_t> out;    ///< grows to largest block output
+	std::size_t produced = 0;
+	bool done = false;                ///< guarded by ParallelConversion::mDoneMutex
+	std::exception_ptr error;
+};
+
+
+class ParallelConversion
+{
+public:
+	ParallelConversion(Input& input_, const ConverterFactory& factory, Output& output_,
+			const ParallelConfig& config_)
+	 : mInput(input_)
+	 , mOutput(output_)
+	 , mBlockSize(std::max<std::size_t>(config_.blockSize, 1))
+	 , mProfiler(config_.profiler)
+	 , mCancel(false)
+	{
+		const std::size_t threads = config_.threads > 0
+				? config_.threads : std::max(1u, std::thread::hardware_concurrency());
+		for (std::size_t idx = 0; idx < threads; ++idx) {
+			mConverters.push_back(factory());
+			if (!mConverters.back()->chunkParallel())
+				throw std::invalid_argument("conversion can not be split into blocks");
+		}
+		mSlots.resize(2 * threads);
+		mPool.reset(new WorkStealingPool(threads));
+	}
+
+	~ParallelConversion()
+	{
+		// tasks refer to slots and converters
+		mCancel = true;
+		mPool.reset();
+	}
+
+	ConversionStats run()
+	{
+		std::size_t written = 0;
+		std::size_t block = 0;
+		for (bool last = false; !last; ++block) {
+			if (block - written == mSlots.size())
+				write(written++);
+
+			if (mProfiler)
+				mProfiler->sampleQueue(Profiler::ReadQueue, block - written, mSlots.size());
+			Slot& slot = mSlots[block % mSlots.size()];
+			{
+				Profiler::Scope scope(mProfiler, Profiler::Read);
+				last = read(slot);
+			}
+			if (last && slot.view.empty() && block > 0)
+				break;    // input ended on block boundary
+
+			slot.done = false;
+			slot.error = nullptr;
+			mPool->submit([this, &slot]() { convert(slot); });
+		}
+		while (written < block)
+			write(written++);
+		return mStats;
+	}
+
+private:
+	/// @return true for last block of input
+	bool read(Slot& slot)
+	{
+		if (mInput.stableViews()) {
+			const InputView view = mInput.peek();
+			slot.view = view.first(std::min(view.size(), mBlockSize));
+			mInput.consume(slot.view.size());
+			return slot.view.size() == view.size();
+		}
+
+		slot.in.resize(mBlockSize);
+		const std::size_t size = mInput.read(OutputView(slot.in.data(), slot.in.size()));
+		slot.view = InputView(slot.in.data(), size);
+		return size < mBlockSize;
+	}
+
+	/// Worker task, whole block is single stream for converter of the worker.
+	void convert(Slot& slot)
+	{
+		try {
+			Profiler::Scope scope(mProfiler, Profiler::Convert);
+			if (!mCancel)
+				slot.produced = convertBlock(*mConverters[WorkStealingPool::currentWorker()],
+						slot.view, slot.out);
+		}
+		catch (...) {
+			slot.error = std::current_exception();
+			mCancel = true;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mDoneMutex);
+			slot.done = true;
+		}
+		mDone.notify_all();
+	}
+
+	/// Waits for block and writes its output.
+	void write(std::size_t block)
+	{
+		Slot& slot = mSlots[block % mSlots.size()];
+		{
+			std::unique_lock<std::mutex> lock(mDoneMutex);
+			if (!slot.done) {
+				Profiler::Scope scope(mProfiler, Profiler::Write, true);
+				mDone.wait(lock, [&slot]() { return slot.done; });
+			}
+		}
+		if (slot.error)
+			std::rethrow_exception(slot.error);
+
+		{
+			Profiler::Scope scope(mProfiler, Profiler::Write);
+			mOutput.write(InputView(slot.out.data(), slot.produced));
+		}
+		mStats.bytesIn += slot.view.size();
+		mStats.bytesOut += slot.produced;
+		if (mProfiler) {
+			mProfiler->addBytesIn(slot.view.size());
+			mProfiler->addBytesOut(slot.produced);
+		}
+	}
+
+	Input& mInput;
+	Output& mOutput;
+	const std::size_t mBlockSize;
+	Profiler* const mProfiler;
+
+	std::vector<std::unique_ptr<Converter>> mConverters;    ///< one per worker
+	std::vector<Slot> mSlots;
+	std::atomic<bool> mCancel;
+
+	std::mutex mDoneMutex;
+	std::condition_variable mDone;
+	ConversionStats mStats;
+
+	std::unique_ptr<WorkStealingPool> mPool;
+};
+
+} // namespace
+
+
+ConversionStats convertParallel(Input& input, const ConverterFactory& factory, Output& output,
+		const ParallelConfig& config)
+{
+	return ParallelConversion(input, factory, output, config).run();
+}
@@ -0,0 +1,44 @@
+/**
+ * @file parallel.hpp
+ * @brief Block-parallel conversion for converters without cross-chunk state
+ *
+ * @author Krzysztof Lasota
+ */
+
+#ifndef PARALLEL_HPP_
+#define PARALLEL_HPP_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+#include "conversion.hpp"
+
+
+struct ParallelConfig
+{
+	std::size_t blockSize = DefaultChunkSize;    ///< input bytes of one block
+	std::size_t threads = 0;                    ///< 0 for hardware concurrency
+	Profiler* profiler = nullptr;               ///< optional instrumentation
+};
+
+/// Creates converter instances, never called concurrently.
+typedef std::function<std::unique_ptr<Converter>()> ConverterFactory;
+
+
+/**
+ * @brief Convert whole input split into blocks on all cores, output is not closed.
+ *
+ * Every block is converted as a separate stream by one of per-worker
+ * converters (see Converter::chunkParallel()) on WorkStealingPool, outputs
+ * are written in input order by calling thread. Memory mapped blocks are
+ * not copied. At most two blocks per worker are in flight.
+ *
+ * @throw std::invalid_argument when converter is not chunk-parallel
+ * @throw std::runtime_error when converter stops making progress
+ * @throw std::system_error when reading or writing fails
+ */
+ConversionStats convertParallel(Input& input, const ConverterFactory& factory, Output& output,
+		const ParallelConfig& config = ParallelConfig());
+
+#endif /* PARALLEL_HPP_ */
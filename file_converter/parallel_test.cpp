@@ -0,0 +1,199 @@
+/**
+ * @file parallel_test.cpp
+ * @brief Test for work-stealing pool and block-parallel conversion
+ *
+ * @author Krzysztof Lasota
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+
+#include "converter.hpp"
+#include "input.hpp"
+#include "output.hpp"
+#include "parallel.hpp"
+#include "plugin_registry.hpp"
+#include "test_utils.hpp"
+#include "work_stealing_pool.hpp"
+
+using namespace test;
+
+
+namespace {
+
+/// Writes every byte twice, no state between chunks.
+class DoubleConverter : public Converter
+{
+public:
+	Result convert(InputView in, OutputView out, bool) override
+	{
+		const std::size_t size = std::min(in.size(), out.size() / 2);
+		for (std::size_t idx = 0; idx < size; ++idx)
+			out[2 * idx] = out[2 * idx + 1] = in[idx];
+		return Result{size, 2 * size};
+	}
+
+	std::size_t outputBound(std::size_t inSize) const override
+	{
+		return 2 * inSize;
+	}
+
+	bool chunkParallel() const override
+	{
+		return true;
+	}
+};
+
+/// Fails on input containing given byte.
+class FailingConverter : public Converter
+{
+public:
+	Result convert(InputView in, OutputView out, bool) override
+	{
+		const std::size_t size = std::min(in.size(), out.size());
+		if (std::find(in.begin(), in.begin() + size, '!') != in.begin() + size)
+			throw std::runtime_error("conversion failed");
+		return Result{size, size};
+	}
+
+	bool chunkParallel() const override
+	{
+		return true;
+	}
+};
+
+template <typename ConverterType>
+ConverterFactory factoryOf()
+{
+	return []() { return std::unique_ptr<Converter>(new ConverterType()); };
+}
+
+ConverterFactory factoryOf(const std::string& name)
+{
+	return [name]() { return Converter::create(name); };
+}
+
+ParallelConfig smallBlocks()
+{
+	ParallelConfig config;
+	config.blockSize = 4096 + 3;
+	config.threads = 3;
+	return config;
+}
+
+} // namespace
+
+
+TEST(WorkStealingPool_Test, T01_RunsAllTasks)
+{
+	std::atomic<int> count(0);
+	{
+		WorkStealingPool pool(3);
+		EXPECT_EQ(3u, pool.size());
+		for (int task = 0; task < 100; ++task)
+			pool.submit([&count]() { ++count; });
+	}
+	EXPECT_EQ(100, count);
+}
+
+TEST(WorkStealingPool_Test, T02_NestedSubmitGoesToWorker)
+{
+	std::atomic<int> count(0);
+	std::atomic<bool> inWorker(true);
+	{
+		WorkStealingPool pool(2);
+		EXPECT_EQ(WorkStealingPool::NoWorker, WorkStealingPool::currentWorker());
+		for (int task = 0; task < 10; ++task)
+			pool.submit([&]() {
+				for (int nested = 0; nested < 10; ++nested)
+					pool.submit([&]() {
+						if (WorkStealingPool::currentWorker() >= pool.size())
+							inWorker = false;
+						++count;
+					});
+			});
+	}
+	EXPECT_EQ(100, count);
+	EXPECT_TRUE(inWorker);
+}
+
+TEST(Parallel_Test, T01_MappedFileMatchesSerial)
+{
+	TempFile source, target;
+	const std::string data = patternData(1000000);
+	source.write(data);
+
+	std::unique_ptr<Input> input = Input::open(source.path());
+	std::unique_ptr<Output> output = Output::open(target.path());
+	const ConversionStats stats = convertParallel(*input, factoryOf("upper"), *output, smallBlocks());
+	output->close();
+
+	EXPECT_EQ(data.size(), stats.bytesIn);
+	EXPECT_EQ(data.size(), stats.bytesOut);
+	EXPECT_EQ(convertString(*Converter::create("upper"), data), target.read());
+}
+
+TEST(Parallel_Test, T02_PipeWithGrowingOutput)
+{
+	TempFile target;
+	const std::string data = patternData(300001);
+	PipeWriter writer(data);
+
+	std::unique_ptr<Input> input = Input::fromDescriptor(writer.readFd(), true);
+	std::unique_ptr<Output> output = Output::open(target.path());
+	const ConversionStats stats = convertParallel(*input, factoryOf<DoubleConverter>(), *output, smallBlocks());
+	output->close();
+
+	DoubleConverter converter;
+	EXPECT_EQ(2 * data.size(), stats.bytesOut);
+	EXPECT_EQ(convertString(converter, data), target.read());
+}
+
+TEST(Parallel_Test, T03_EmptyInput)
+{
+	TempFile source, target;
+
+	std::unique_ptr<Input> input = Input::open(source.path());
+	std::unique_ptr<Output> output = Output::open(target.path());
+	const ConversionStats stats = convertParallel(*input, factoryOf("copy"), *output, smallBlocks());
+	output->close();
+
+	EXPECT_EQ(0u, stats.bytesOut);
+	EXPECT_EQ("", target.read());
+}
+
+TEST(Parallel_Test, T04_ConverterErrorIsRethrown)
+{
+	TempFile source, target;
+	std::string data = patternData(1000000);
+	data[500000] = '!';
+	source.write(data);
+
+	std::unique_ptr<Input> input = Input::open(source.path());
+	std::unique_ptr<Output> output = Output::open(target.path());
+	EXPECT_THROW(convertParallel(*input, factoryOf<FailingConverter>(), *output, smallBlocks()),
+			std::runtime_error);
+}
+
+TEST(Parallel_Test, T05_StatefulConverterIsRejected)
+{
+	TempFile source, target;
+	std::unique_ptr<Input> input = Input::open(source.path());
+	std::unique_ptr<Output> output = Output::open(target.path());
+	EXPECT_THROW(convertParallel(*input, factoryOf<SwapConverter>(), *output, smallBlocks()),
+			std::invalid_argument);
+}
+
+TEST(Parallel_Test, T06_CapabilityFlags)
+{
+	PluginRegistry registry({"plugins"});
+	EXPECT_TRUE(registry.create("copy")->chunkParallel());
+	EXPECT_TRUE(registry.create("upper")->chunkParallel());
+	EXPECT_TRUE(registry.create("sample:rot13")->chunkParallel());
+	EXPECT_TRUE(registry.create("sample:hex")->chunkParallel());
+	EXPECT_FALSE(SwapConverter().chunkParallel());
+}
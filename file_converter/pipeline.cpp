@@ -0,0 +1,286 @@
+/**
+ * @file pipeline.cpp
+ * @brief Conversion overlapping reading, converting and writing
+ *
+ * @author Krzysztof Lasota
+ */
+
+#include "pipeline.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "buffer_pool.hpp"
+#include "converter.hpp"
+#include "input.hpp"
+#include "output.hpp"
+#include "profiler.hpp"
+#include "spsc_queue.hpp"
+
+
+namespace {
+
+const std::size_t PageSize = 4096;
+
+/// Piece of data travelling between stages.
+struct Chunk
+{
+	const std::uint8_t* data;
+	std::size_t size;
+	std::uint8_t* buffer;    ///< pool buffer holding data, nullptr for mapped input
+	bool last;
+};
+
+
+class Pipeline
+{
+public:
+	Pipeline(Input& input_, Converter& converter_, Output& output_, const PipelineConfig& config_)
+	 : mInput(input_)
+	 , mConverter(converter_)
+	 , mOutput(output_)
+	 , mChunkSize(std::max<std::size_t>(config_.chunkSize, 1))
+	 , mProfiler(config_.profiler)
+	 , mInputPool(input_.stableViews() ? 0 : std::max<std::size_t>(config_.depth, 1), mChunkSize)
+	 , mOutputPool(std::max<std::size_t>(config_.depth, 1), mChunkSize)
+	 , mRead(std::max<std::size_t>(config_.depth, 1))
+	 , mConverted(std::max<std::size_t>(config_.depth, 1))
+	 , mCancel(false)
+	 , mOutBuffer(nullptr)
+	 , mOutUsed(0)
+	{
+	}
+
+	ConversionStats run()
+	{
+		std::thread reader(&Pipeline::guarded, this, &Pipeline::readStage);
+		std::thread writer(&Pipeline::guarded, this, &Pipeline::writeStage);
+		guarded(&Pipeline::convertStage);
+		reader.join();
+		writer.join();
+
+		if (mError)
+			std::rethrow_exception(mError);
+		return mStats;
+	}
+
+private:
+	typedef void (Pipeline::*Stage)();
+
+	/// Runs stage, first failure cancels all stages.
+	void guarded(Stage stage)
+	{
+		try {
+			(this->*stage)();
+		}
+		catch (...) {
+			std::lock_guard<std::mutex> lock(mErrorMutex);
+			if (!mError)
+				mError = std::current_exception();
+			mCancel = true;
+		}
+	}
+
+	void readStage()
+	{
+		if (mInput.stableViews()) {
+			// mapping is passed on, page faults are taken here
+			for (bool last = false; !last; ) {
+				InputView view;
+				std::size_t size;
+				{
+					Profiler::Scope scope(mProfiler, Profiler::Read);
+					view = mInput.peek();
+					size = std::min(view.size(), mChunkSize);
+					last = size == view.size();
+					touchPages(view.first(size));
+					mInput.consume(size);
+				}
+				if (!push(mRead, Profiler::ReadQueue, Profiler::Read, Chunk{view.data(), size, nullptr, last}))
+					return;
+			}
+			return;
+		}
+
+		for (bool last = false; !last; ) {
+			std::uint8_t* buffer = acquire(mInputPool, Profiler::Read);
+			if (!buffer)
+				return;
+			std::size_t size;
+			{
+				Profiler::Scope scope(mProfiler, Profiler::Read);
+				size = mInput.read(OutputView(buffer, mChunkSize));
+			}
+			last = size < mChunkSize;
+			if (!push(mRead, Profiler::ReadQueue, Profiler::Read, Chunk{buffer, size, buffer, last}))
+				return;
+		}
+	}
+
+	void convertStage()
+	{
+		std::vector<std::uint8_t> carry;    // unconsumed end of previous chunk
+
+		Chunk chunk;
+		do {
+			if (!pop(mRead, Profiler::Convert, chunk))
+				return;
+
+			InputView in(chunk.data, chunk.size);
+			if (!carry.empty()) {
+				carry.insert(carry.end(), in.begin(), in.end());
+				in = InputView(carry.data(), carry.size());
+			}
+
+			in = convertChunk(in, chunk.last);
+			std::vector<std::uint8_t>(in.begin(), in.end()).swap(carry);
+
+			if (chunk.buffer)
+				mInputPool.release(chunk.buffer);
+		} while (!chunk.last);
+
+		if (mOutUsed > 0)
+			passOutput();
+		push(mConverted, Profiler::WriteQueue, Profiler::Convert, Chunk{nullptr, 0, nullptr, true});
+	}
+
+	/// @return input which converter needs to see together with next chunk
+	InputView convertChunk(InputView in, bool last)
+	{
+		for (;;) {
+			if (!mOutBuffer) {
+				mOutBuffer = acquire(mOutputPool, Profiler::Convert);
+				if (!mOutBuffer)
+					return InputView();
+			}
+			const OutputView out(mOutBuffer + mOutUsed, mChunkSize - mOutUsed);
+
+			// converter is guaranteed to progress only with bounded output
+			std::size_t size = in.size();
+			while (size > 0 && mConverter.outputBound(size) > out.size())
+				size /= 2;
+			const bool lastCall = last && size == in.size();
+
+			Converter::Result result;
+			{
+				Profiler::Scope scope(mProfiler, Profiler::Convert);
+				result = mConverter.convert(in.first(size), out, lastCall);
+			}
+			in = in.subspan(result.consumed);
+			mOutUsed += result.produced;
+			mStats.bytesIn += result.consumed;
+			if (mProfiler)
+				mProfiler->addBytesIn(result.consumed);
+
+			if (mOutUsed == mChunkSize)
+				passOutput();
+			if (result.consumed > 0 || result.produced > 0) {
+				if (in.empty() && !last)
+					return in;
+				continue;
+			}
+
+			if (lastCall && in.empty())
+				return in;    // converter flushed everything
+			if (mOutUsed > 0)
+				passOutput();    // retry with whole empty buffer
+			else if (!last)
+				return in;
+			else
+				throw std::runtime_error("converter does not make progress");
+		}
+	}
+
+	void passOutput()
+	{
+		push(mConverted, Profiler::WriteQueue, Profiler::Convert, Chunk{mOutBuffer, mOutUsed, mOutBuffer, false});
+		mOutBuffer = nullptr;
+		mOutUsed = 0;
+	}
+
+	void writeStage()
+	{
+		Chunk chunk;
+		while (pop(mConverted, Profiler::Write, chunk) && chunk.data) {
+			{
+				Profiler::Scope scope(mProfiler, Profiler::Write);
+				mOutput.write(InputView(chunk.data, chunk.size));
+			}
+			mStats.bytesOut += chunk.size;
+			if (mProfiler)
+				mProfiler->addBytesOut(chunk.size);
+			mOutputPool.release(chunk.buffer);
+		}
+	}
+
+	/// Blocking push, waiting counts as stall of pushing stage.
+	bool push(SpscQueue<Chunk>& queue, Profiler::Queue id, Profiler::Stage stage, const Chunk& chunk)
+	{
+		if (mProfiler)
+			mProfiler->sampleQueue(id, queue.size(), queue.capacity());
+		if (queue.tryPush(chunk))
+			return true;
+		Profiler::Scope scope(mProfiler, stage, true);
+		return queue.push(chunk, mCancel);
+	}
+
+	/// Blocking pop, waiting counts as stall of popping stage.
+	bool pop(SpscQueue<Chunk>& queue, Profiler::Stage stage, Chunk& chunk)
+	{
+		if (queue.tryPop(chunk))
+			return true;
+		Profiler::Scope scope(mProfiler, stage, true);
+		return queue.pop(chunk, mCancel);
+	}
+
+	/// Blocking acquire, waiting for recycled buffer counts as stall.
+	std::uint8_t* acquire(BufferPool& pool, Profiler::Stage stage)
+	{
+		std::uint8_t* buffer = pool.tryAcquire();
+		if (buffer)
+			return buffer;
+		Profiler::Scope scope(mProfiler, stage, true);
+		return pool.acquire(mCancel);
+	}
+
+	static void touchPages(InputView view)
+	{
+		std::uint8_t sum = 0;
+		for (std::size_t offset = 0; offset < view.size(); offset += PageSize)
+			sum += *static_cast<const volatile std::uint8_t*>(view.data() + offset);
+		(void)sum;
+	}
+
+	Input& mInput;
+	Converter& mConverter;
+	Output& mOutput;
+	const std::size_t mChunkSize;
+	Profiler* const mProfiler;
+
+	BufferPool mInputPool;     ///< acquired by reader, released by converter
+	BufferPool mOutputPool;    ///< acquired by converter, released by writer
+	SpscQueue<Chunk> mRead;
+	SpscQueue<Chunk> mConverted;
+
+	std::atomic<bool> mCancel;
+	std::mutex mErrorMutex;
+	std::exception_ptr mError;
+	ConversionStats mStats;
+
+	std::uint8_t* mOutBuffer;
+	std::size_t mOutUsed;
+};
+
+} // namespace
+
+
+ConversionStats convertPipelined(Input& input, Converter& converter, Output& output,
+		const PipelineConfig& config)
+{
+	return Pipeline(input, converter, output, config).run();
+}
@@ -0,0 +1,42 @@
+/**
+ * @file pipeline.hpp
+ * @brief Conversion overlapping reading, converting and writing
+ *
+ * @author Krzysztof Lasota
+ */
+
+#ifndef PIPELINE_HPP_
+#define PIPELINE_HPP_
+
+#include <cstddef>
+
+#include "conversion.hpp"
+
+
+struct PipelineConfig
+{
+	std::size_t chunkSize = DefaultChunkSize;    ///< size of every buffer
+	std::size_t depth = 4;                       ///< buffers between two stages
+	Profiler* profiler = nullptr;                ///< optional instrumentation
+};
+
+
+/**
+ * @brief Convert whole input with read, convert and write stages running
+ *        in parallel, output is not closed.
+ *
+ * Reader thread fills chunks (memory mapped input is only faulted in and
+ * passed as views), converter runs on calling thread and writer thread
+ * drains converted buffers. Stages exchange buffers of two recycled pools
+ * through bounded lock-free queues, so memory use is fixed and slowest
+ * stage sets the pace. Input left unconsumed at chunk end is carried over
+ * to the next chunk. First error of any stage stops all of them and is
+ * rethrown.
+ *
+ * @throw std::runtime_error when converter stops making progress
+ * @throw std::system_error when reading or writing fails
+ */
+ConversionStats convertPipelined(Input& input, Converter& converter, Output& output,
+		const PipelineConfig& config = PipelineConfig());
+
+#endif /* PIPELINE_HPP_ */
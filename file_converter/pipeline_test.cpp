@@ -0,0 +1,151 @@
+/**
+ * @file pipeline_test.cpp
+ * @brief Test for multi-threaded conversion pipeline
+ *
+ * @author Krzysztof Lasota
+ */
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+
+#include "converter.hpp"
+#include "input.hpp"
+#include "output.hpp"
+#include "pipeline.hpp"
+#include "test_utils.hpp"
+
+using namespace test;
+
+
+namespace {
+
+/// Writes every byte twice.
+class DoubleConverter : public Converter
+{
+public:
+	Result convert(InputView in, OutputView out, bool) override
+	{
+		const std::size_t size = std::min(in.size(), out.size() / 2);
+		for (std::size_t idx = 0; idx < size; ++idx)
+			out[2 * idx] = out[2 * idx + 1] = in[idx];
+		return Result{size, 2 * size};
+	}
+
+	std::size_t outputBound(std::size_t inSize) const override
+	{
+		return 2 * inSize;
+	}
+};
+
+/// Fails after given number of input bytes.
+class FailingConverter : public Converter
+{
+public:
+	explicit
+	FailingConverter(std::size_t limit_)
+	 : mLimit(limit_)
+	{
+	}
+
+	Result convert(InputView in, OutputView out, bool) override
+	{
+		const std::size_t size = std::min(in.size(), out.size());
+		if (size > mLimit)
+			throw std::runtime_error("conversion failed");
+		mLimit -= size;
+		return Result{size, size};
+	}
+
+private:
+	std::size_t mLimit;
+};
+
+PipelineConfig smallChunks()
+{
+	PipelineConfig config;
+	config.chunkSize = 4096 + 3;    // chunk ends fall between 4 byte groups
+	config.depth = 3;
+	return config;
+}
+
+} // namespace
+
+
+TEST(Pipeline_Test, T01_MappedFileToFile)
+{
+	TempFile source, target;
+	const std::string data = patternData(1000000);
+	source.write(data);
+
+	std::unique_ptr<Converter> converter = Converter::create("upper");
+	std::unique_ptr<Input> input = Input::open(source.path());
+	std::unique_ptr<Output> output = Output::open(target.path());
+	const ConversionStats stats = convertPipelined(*input, *converter, *output, smallChunks());
+	output->close();
+
+	EXPECT_EQ(data.size(), stats.bytesIn);
+	EXPECT_EQ(data.size(), stats.bytesOut);
+	EXPECT_EQ(convertString(*converter, data), target.read());
+}
+
+TEST(Pipeline_Test, T02_PipeWithCarryOver)
+{
+	TempFile target;
+	const std::string data = patternData(300001);
+	PipeWriter writer(data);
+
+	SwapConverter converter;
+	std::unique_ptr<Input> input = Input::fromDescriptor(writer.readFd(), true);
+	std::unique_ptr<Output> output = Output::open(target.path());
+	convertPipelined(*input, converter, *output, smallChunks());
+	output->close();
+
+	EXPECT_EQ(convertString(converter, data), target.read());
+}
+
+TEST(Pipeline_Test, T03_OutputLargerThanInput)
+{
+	TempFile source, target;
+	const std::string data = patternData(100000);
+	source.write(data);
+
+	DoubleConverter converter;
+	std::unique_ptr<Input> input = Input::open(source.path());
+	std::unique_ptr<Output> output = Output::open(target.path());
+	const ConversionStats stats = convertPipelined(*input, converter, *output, smallChunks());
+	output->close();
+
+	EXPECT_EQ(2 * data.size(), stats.bytesOut);
+	EXPECT_EQ(convertString(converter, data), target.read());
+}
+
+TEST(Pipeline_Test, T04_EmptyInput)
+{
+	TempFile source, target;
+
+	std::unique_ptr<Converter> converter = Converter::create("copy");
+	std::unique_ptr<Input> input = Input::open(source.path());
+	std::unique_ptr<Output> output = Output::open(target.path());
+	const ConversionStats stats = convertPipelined(*input, *converter, *output, smallChunks());
+	output->close();
+
+	EXPECT_EQ(0u, stats.bytesOut);
+	EXPECT_EQ("", target.read());
+}
+
+TEST(Pipeline_Test, T05_ConverterErrorStopsAllStages)
+{
+	TempFile target;
+	const std::string data = patternData(1000000);
+	PipeWriter writer(data);
+
+	FailingConverter converter(50000);
+	std::unique_ptr<Input> input = Input::fromDescriptor(writer.readFd(), true);
+	std::unique_ptr<Output> output = Output::open(target.path());
+
+	EXPECT_THROW(convertPipelined(*input, converter, *output, smallChunks()), std::runtime_error);
+	// unread data must not block the writing thread
+	input.reset();
+}
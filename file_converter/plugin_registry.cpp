@@ -0,0 +1,276 @@
+/**
+ * @file plugin_registry.cpp
+ * @brief Lazy loader of conversion plugins
+ *
+ * @author Krzysztof Lasota
+ */
+
+#include "plugin_registry.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+#include <dirent.h>
+#include <dlfcn.h>
+#include <unistd.h>
+
+#include "converter_plugin.h"
+
+
+namespace {
+
+const std::string LibraryPrefix = "fc_";
+const std::string LibrarySuffix = ".so";
+const char NameSeparator = ':';
+
+std::string libraryName(const std::string& plugin)
+{
+	return LibraryPrefix + plugin + LibrarySuffix;
+}
+
+bool endsWith(const std::string& str, const std::string& suffix)
+{
+	return str.size() >= suffix.size()
+			&& str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // namespace
+
+
+/**
+ * @brief Opened plugin library.
+ */
+class Plugin
+{
+public:
+	Plugin(const std::string& name_, const std::string& path)
+	 : mName(name_)
+	 , mHandle(dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL))
+	 , mDesc(nullptr)
+	{
+		if (!mHandle)
+			throw std::runtime_error("can not load plugin " + mName + ": " + dlerror());
+
+		const fc_plugin_query_fn query =
+				reinterpret_cast<fc_plugin_query_fn>(dlsym(mHandle, FC_PLUGIN_QUERY_SYMBOL));
+		mDesc = query ? query(FC_PLUGIN_ABI_VERSION) : nullptr;
+		if (!mDesc || mDesc->abi_version == 0 || mDesc->abi_version > FC_PLUGIN_ABI_VERSION) {
+			dlclose(mHandle);
+			throw std::runtime_error("plugin " + mName + " does not support ABI version "
+					+ std::to_string(FC_PLUGIN_ABI_VERSION));
+		}
+	}
+
+	~Plugin()
+	{
+		dlclose(mHandle);
+	}
+
+	Plugin(const Plugin&) = delete;
+	Plugin& operator=(const Plugin&) = delete;
+
+	const std::string& name() const { return mName; }
+	const fc_plugin& desc() const { return *mDesc; }
+
+	/// Index of conversion, first one for empty name, count when not found.
+	std::uint32_t find(const std::string& conversion) const
+	{
+		if (conversion.empty())
+			return 0;
+		std::uint32_t idx = 0;
+		while (idx < mDesc->conversion_count && conversion != mDesc->conversions[idx].name)
+			++idx;
+		return idx;
+	}
+
+private:
+	std::string mName;
+	void* mHandle;
+	const fc_plugin* mDesc;
+};
+
+
+namespace {
+
+/**
+ * @brief Converter forwarding bulk calls to plugin.
+ */
+class PluginConverter : public Converter
+{
+public:
+	PluginConverter(const std::shared_ptr<Plugin>& plugin_, std::uint32_t conversion_)
+	 : mPlugin(plugin_)
+	 , mConversion(conversion_)
+	 , mState(mPlugin->desc().create(conversion_))
+	{
+		if (!mState)
+			throw std::runtime_error("plugin " + mPlugin->name() + " can not create "
+					+ mPlugin->desc().conversions[mConversion].name);
+	}
+
+	~PluginConverter()
+	{
+		mPlugin->desc().destroy(mState);
+	}
+
+	Result convert(InputView in, OutputView out, bool last) override
+	{
+		const fc_in_span inSpan = {in.data(), in.size()};
+		const fc_out_span outSpan = {out.data(), out.size()};
+		Result result = {0, 0};
+
+		const int status = mPlugin->desc().convert(mState, inSpan, outSpan, last,
+				&result.consumed, &result.produced);
+		if (status != FC_OK)
+			throw std::runtime_error(mPlugin->name() + NameSeparator
+					+ mPlugin->desc().conversions[mConversion].name + " conversion failed");
+		return result;
+	}
+
+	std::size_t outputBound(std::size_t inSize) const override
+	{
+		return mPlugin->desc().output_bound
+				? mPlugin->desc().output_bound(mState, inSize)
+				: Converter::outputBound(inSize);
+	}
+
+	bool chunkParallel() const override
+	{
+		return mPlugin->desc().conversions[mConversion].flags & FC_CONVERSION_CHUNK_PARALLEL;
+	}
+
+private:
+	std::shared_ptr<Plugin> mPlugin;
+	std::uint32_t mConversion;
+	void* mState;
+};
+
+} // namespace
+
+
+const char* const PluginRegistry::PathVariable = "FILE_CONVERTER_PLUGINS";
+
+
+PluginRegistry::PluginRegistry(const std::vector<std::string>& searchDirs_)
+ : mSearchDirs(searchDirs_)
+{
+}
+
+
+PluginRegistry::~PluginRegistry()
+{
+}
+
+
+std::vector<std::string> PluginRegistry::environmentDirs()
+{
+	std::vector<std::string> dirs;
+	const char* path = std::getenv(PathVariable);
+	if (!path)
+		return dirs;
+
+	const std::string paths(path);
+	std::size_t begin = 0;
+	for (std::size_t end; (end = paths.find(':', begin)) != std::string::npos; begin = end + 1)
+		if (end > begin)
+			dirs.push_back(paths.substr(begin, end - begin));
+	if (begin < paths.size())
+		dirs.push_back(paths.substr(begin));
+	return dirs;
+}
+
+
+std::unique_ptr<Converter> PluginRegistry::create(const std::string& name)
+{
+	const std::size_t separator = name.find(NameSeparator);
+	const std::vector<std::string> builtins = Converter::names();
+	if (separator == std::string::npos
+			&& std::find(builtins.begin(), builtins.end(), name) != builtins.end())
+		return Converter::create(name);
+
+	const std::string pluginName = name.substr(0, separator);
+	const std::string conversion = (separator == std::string::npos) ? "" : name.substr(separator + 1);
+	const std::shared_ptr<Plugin> plugin = load(pluginName);
+	if (!plugin)
+		throw std::invalid_argument("unknown conversion: " + name);
+
+	const std::uint32_t idx = plugin->find(conversion);
+	if (idx >= plugin->desc().conversion_count)
+		throw std::invalid_argument("unknown conversion: " + name);
+	return std::unique_ptr<Converter>(new PluginConverter(plugin, idx));
+}
+
+
+std::vector<std::pair<std::string, std::string>> PluginRegistry::list()
+{
+	std::vector<std::pair<std::string, std::string>> names;
+	for (const std::string& builtin : Converter::names())
+		names.emplace_back(builtin, "built-in");
+
+	std::vector<std::string> plugins;
+	for (const std::string& dir : mSearchDirs) {
+		DIR* dirp = opendir(dir.c_str());
+		if (!dirp)
+			continue;
+		while (const dirent* entry = readdir(dirp)) {
+			const std::string file = entry->d_name;
+			if (file.compare(0, LibraryPrefix.size(), LibraryPrefix) == 0 && endsWith(file, LibrarySuffix))
+				plugins.push_back(file.substr(LibraryPrefix.size(),
+						file.size() - LibraryPrefix.size() - LibrarySuffix.size()));
+		}
+		closedir(dirp);
+	}
+	std::sort(plugins.begin(), plugins.end());
+	plugins.erase(std::unique(plugins.begin(), plugins.end()), plugins.end());
+
+	for (const std::string& pluginName : plugins) {
+		// one stale library must not hide the others
+		std::shared_ptr<Plugin> plugin;
+		try {
+			plugin = load(pluginName);
+		}
+		catch (const std::exception& e) {
+			names.emplace_back(pluginName, std::string("error: ") + e.what());
+			continue;
+		}
+		if (!plugin)
+			continue;
+		const fc_plugin& desc = plugin->desc();
+		for (std::uint32_t idx = 0; idx < desc.conversion_count; ++idx)
+			names.emplace_back(pluginName + NameSeparator + desc.conversions[idx].name,
+					desc.conversions[idx].description);
+	}
+	return names;
+}
+
+
+std::size_t PluginRegistry::loadedCount() const
+{
+	return mPlugins.size();
+}
+
+
+/**
+ * @return loaded plugin, nullptr when no search directory holds it
+ */
+std::shared_ptr<Plugin> PluginRegistry::load(const std::string& plugin)
+{
+	const auto found = mPlugins.find(plugin);
+	if (found != mPlugins.end())
+		return found->second;
+
+	// plugin name must not escape search directories
+	if (plugin.empty() || plugin.find('/') != std::string::npos)
+		return nullptr;
+
+	for (const std::string& dir : mSearchDirs) {
+		const std::string path = dir + '/' + libraryName(plugin);
+		if (access(path.c_str(), R_OK) != 0)
+			continue;
+		const std::shared_ptr<Plugin> loaded = std::make_shared<Plugin>(plugin, path);
+		mPlugins[plugin] = loaded;
+		return loaded;
+	}
+	return nullptr;
+}
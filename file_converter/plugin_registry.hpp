@@ -0,0 +1,72 @@
+/**
+ * @file plugin_registry.hpp
+ * @brief Lazy loader of conversion plugins
+ *
+ * @author Krzysztof Lasota
+ */
+
+#ifndef PLUGIN_REGISTRY_HPP_
+#define PLUGIN_REGISTRY_HPP_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "converter.hpp"
+
+class Plugin;
+
+
+/**
+ * @brief Source of built-in and plugin converters.
+ *
+ * Conversion is named `plugin:conversion`, or just `plugin` for the first
+ * conversion of plugin; names without plugin part that match built-in
+ * converter (see Converter::names()) stay built-in. Plugin `plugin` is
+ * library `fc_plugin.so` found in the first search directory holding it.
+ * Libraries are opened only when a conversion of them is requested,
+ * listing opens all of them.
+ */
+class PluginRegistry
+{
+public:
+	/// Environment variable with colon separated search directories.
+	static const char* const PathVariable;
+
+	explicit
+	PluginRegistry(const std::vector<std::string>& searchDirs_);
+	~PluginRegistry();
+
+	PluginRegistry(const PluginRegistry&) = delete;
+	PluginRegistry& operator=(const PluginRegistry&) = delete;
+
+	/// Directories from PathVariable, empty when not set.
+	static std::vector<std::string> environmentDirs();
+
+	/**
+	 * @brief Create converter, plugin library stays loaded while converter lives.
+	 * @throw std::invalid_argument for unknown conversion
+	 * @throw std::runtime_error when plugin can not be loaded or rejects host
+	 */
+	std::unique_ptr<Converter> create(const std::string& name);
+
+	/**
+	 * @brief Names of all conversions with descriptions, loads every plugin found.
+	 *
+	 * Plugin which can not be loaded is listed by its name with "error: "
+	 * and the reason as description.
+	 */
+	std::vector<std::pair<std::string, std::string>> list();
+
+	/// Number of plugin libraries opened so far.
+	std::size_t loadedCount() const;
+
+private:
+	std::shared_ptr<Plugin> load(const std::string& plugin);
+
+	std::vector<std::string> mSearchDirs;
+	std::map<std::string, std::shared_ptr<Plugin>> mPlugins;
+};
+
+#endif /* PLUGIN_REGISTRY_HPP_ */
@@ -0,0 +1,105 @@
+/**
+ * @file plugin_registry_test.cpp
+ * @brief Test for plugin registry, uses plugins/fc_sample.so
+ *
+ * @author Krzysztof Lasota
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "plugin_registry.hpp"
+#include "test_utils.hpp"
+
+using namespace test;
+
+
+namespace {
+
+const std::vector<std::string> SampleDirs = {"missing_dir", "plugins"};
+
+} // namespace
+
+
+TEST(PluginRegistry_Test, T01_BuiltinDoesNotLoadPlugins)
+{
+	PluginRegistry registry(SampleDirs);
+
+	EXPECT_EQ("ABC", convertString(*registry.create("upper"), "abc"));
+	EXPECT_EQ(0u, registry.loadedCount());
+}
+
+TEST(PluginRegistry_Test, T02_PluginConversionByName)
+{
+	PluginRegistry registry(SampleDirs);
+
+	EXPECT_EQ("Uryyb, jbeyq!", convertString(*registry.create("sample:rot13"), "Hello, world!"));
+	EXPECT_EQ("00ff41", convertString(*registry.create("sample:hex"), std::string("\0\xff" "A", 3)));
+	EXPECT_EQ(1u, registry.loadedCount());
+}
+
+TEST(PluginRegistry_Test, T03_PluginNameSelectsFirstConversion)
+{
+	PluginRegistry registry(SampleDirs);
+
+	EXPECT_EQ("nop", convertString(*registry.create("sample"), "abc"));
+}
+
+TEST(PluginRegistry_Test, T04_ConverterKeepsPluginLoaded)
+{
+	std::unique_ptr<Converter> converter;
+	{
+		PluginRegistry registry(SampleDirs);
+		converter = registry.create("sample:rot13");
+	}
+
+	EXPECT_EQ("nop", convertString(*converter, "abc"));
+}
+
+TEST(PluginRegistry_Test, T05_UnknownConversion)
+{
+	PluginRegistry registry(SampleDirs);
+
+	EXPECT_THROW(registry.create("missing"), std::invalid_argument);
+	EXPECT_THROW(registry.create("sample:missing"), std::invalid_argument);
+	EXPECT_THROW(registry.create("../plugins/sample"), std::invalid_argument);
+}
+
+TEST(PluginRegistry_Test, T06_ListQueriesAllPlugins)
+{
+	PluginRegistry registry(SampleDirs);
+	const auto conversions = registry.list();
+
+	const auto hasName = [&](const std::string& name) {
+		return std::any_of(conversions.begin(), conversions.end(),
+				[&](const std::pair<std::string, std::string>& conversion) {
+					return conversion.first == name;
+				});
+	};
+	EXPECT_TRUE(hasName("copy"));
+	EXPECT_TRUE(hasName("sample:rot13"));
+	EXPECT_TRUE(hasName("sample:hex"));
+}
+
+TEST(PluginRegistry_Test, T07_ListShowsUnloadablePlugin)
+{
+	TempDir dir;
+	dir.write("fc_broken.so", "not a shared library");
+	PluginRegistry registry({dir.path(), "plugins"});
+	const auto conversions = registry.list();
+
+	const auto broken = std::find_if(conversions.begin(), conversions.end(),
+			[](const std::pair<std::string, std::string>& conversion) {
+				return conversion.first == "broken";
+			});
+	ASSERT_NE(conversions.end(), broken);
+	EXPECT_EQ(0u, broken->second.find("error: "));
+	EXPECT_TRUE(std::any_of(conversions.begin(), conversions.end(),
+			[](const std::pair<std::string, std::string>& conversion) {
+				return conversion.first == "sample:rot13";
+			}));
+	EXPECT_EQ("copy", conversions.front().first);
+}
@@ -0,0 +1,100 @@
+/**
+ * @file sample_plugin.c
+ * @brief Example conversion plugin (fc_sample.so) using the C ABI
+ *
+ * @author Krzysztof Lasota
+ */
+
+#include <stdlib.h>
+
+#include "../converter_plugin.h"
+
+
+enum sample_conversion
+{
+	SAMPLE_ROT13,
+	SAMPLE_HEX
+};
+
+static const fc_conversion_info conversions[] = {
+	{"rot13", "rotate latin letters by 13 places", FC_CONVERSION_CHUNK_PARALLEL},
+	{"hex", "lowercase hexadecimal dump, no separators", FC_CONVERSION_CHUNK_PARALLEL}
+};
+
+typedef struct sample_state
+{
+	uint32_t conversion;
+} sample_state;
+
+
+static void* sample_create(uint32_t conversion)
+{
+	sample_state* state = malloc(sizeof(*state));
+	if (state)
+		state->conversion = conversion;
+	return state;
+}
+
+static void sample_destroy(void* state)
+{
+	free(state);
+}
+
+static uint8_t rot13(uint8_t byte)
+{
+	const uint8_t lower = byte | 0x20;
+	if (lower < 'a' || 'z' < lower)
+		return byte;
+	return (lower <= 'm') ? byte + 13 : byte - 13;
+}
+
+static int sample_convert(void* state_, fc_in_span in, fc_out_span out, int last,
+		size_t* consumed, size_t* produced)
+{
+	static const char digits[] = "0123456789abcdef";
+	const sample_state* state = state_;
+	size_t idx;
+	(void)last;
+
+	if (state->conversion == SAMPLE_ROT13) {
+		const size_t size = (in.size < out.size) ? in.size : out.size;
+		for (idx = 0; idx < size; ++idx)
+			out.data[idx] = rot13(in.data[idx]);
+		*consumed = *produced = size;
+		return FC_OK;
+	}
+
+	if (state->conversion == SAMPLE_HEX) {
+		const size_t size = (in.size < out.size / 2) ? in.size : out.size / 2;
+		for (idx = 0; idx < size; ++idx) {
+			out.data[2 * idx] = digits[in.data[idx] >> 4];
+			out.data[2 * idx + 1] = digits[in.data[idx] & 0xf];
+		}
+		*consumed = size;
+		*produced = 2 * size;
+		return FC_OK;
+	}
+	return FC_ERROR;
+}
+
+static size_t sample_output_bound(void* state_, size_t in_size)
+{
+	const sample_state* state = state_;
+	return (state->conversion == SAMPLE_HEX) ? 2 * in_size : in_size;
+}
+
+static const fc_plugin plugin = {
+	FC_PLUGIN_ABI_VERSION,
+	sizeof(conversions) / sizeof(conversions[0]),
+	conversions,
+	sample_create,
+	sample_destroy,
+	sample_convert,
+	sample_output_bound
+};
+
+
+const fc_plugin* fc_plugin_query(uint32_t host_abi_version)
+{
+	return (host_abi_version >= FC_PLUGIN_ABI_VERSION) ? &plugin : NULL;
+}
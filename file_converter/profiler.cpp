@@ -0,0 +1,278 @@
+/**
+ * @file profiler.cpp
+ * @brief Throughput and per-stage instrumentation of conversions
+ *
+ * @author Krzysztof Lasota
+ */
+
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <ostream>
+
+
+namespace {
+
+const char* const StageNames[] = {"read", "convert", "write"};
+const char* const QueueNames[] = {"read", "write"};
+
+double nsToSeconds(std::uint64_t ns)
+{
+	return ns / 1e9;
+}
+
+} // namespace
+
+
+const std::size_t Profiler::StageCount;
+const std::size_t Profiler::QueueCount;
+
+
+Profiler::Scope::Scope(Profiler* profiler_, Stage stage_, bool stall_)
+ : mProfiler(profiler_)
+ , mStage(stage_)
+ , mStall(stall_)
+{
+	if (mProfiler)
+		mStart = std::chrono::steady_clock::now();
+}
+
+
+Profiler::Scope::~Scope()
+{
+	if (mProfiler)
+		mProfiler->record(mStage, mStall, mStart, std::chrono::steady_clock::now());
+}
+
+
+Profiler::Profiler(const ProfilerConfig& config)
+ : mConfig(config)
+ , mStart(std::chrono::steady_clock::now())
+ , mFinishNs(0)
+ , mBytesIn(0)
+ , mBytesOut(0)
+ , mProgressStop(false)
+ , mLastBytesIn(0)
+ , mLastSeconds(0)
+{
+	for (StageCounters& stage : mStages) {
+		stage.busyNs = 0;
+		stage.calls = 0;
+		stage.stallNs = 0;
+		stage.stalls = 0;
+	}
+	for (QueueCounters& queue : mQueues) {
+		queue.sum = 0;
+		queue.samples = 0;
+		queue.max = 0;
+		queue.capacity = 0;
+	}
+	std::fill(mLastBusyNs, mLastBusyNs + StageCount, 0);
+
+	if (mConfig.progressInterval > 0 && mConfig.progress)
+		mProgressThread = std::thread(&Profiler::progressLoop, this);
+}
+
+
+Profiler::~Profiler()
+{
+	finish();
+}
+
+
+void Profiler::addBytesIn(std::uint64_t bytes)
+{
+	mBytesIn.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+
+void Profiler::addBytesOut(std::uint64_t bytes)
+{
+	mBytesOut.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+
+void Profiler::sampleQueue(Queue queue, std::size_t size, std::size_t capacity)
+{
+	QueueCounters& counters = mQueues[queue];
+	counters.sum.fetch_add(size, std::memory_order_relaxed);
+	counters.samples.fetch_add(1, std::memory_order_relaxed);
+	counters.capacity.store(capacity, std::memory_order_relaxed);
+	std::size_t max = counters.max.load(std::memory_order_relaxed);
+	while (size > max && !counters.max.compare_exchange_weak(max, size, std::memory_order_relaxed))
+		;
+
+	if (mConfig.trace)
+		addTrace(TraceEvent{queueName(queue), false, true,
+				sinceStart(std::chrono::steady_clock::now()), size, 0});
+}
+
+
+void Profiler::finish()
+{
+	if (mFinishNs.load() != 0)
+		return;
+	mFinishNs = std::max<std::uint64_t>(sinceStart(std::chrono::steady_clock::now()), 1);
+
+	if (mProgressThread.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(mProgressMutex);
+			mProgressStop = true;
+		}
+		mProgressWake.notify_all();
+		mProgressThread.join();
+		printProgress(true);
+	}
+}
+
+
+void Profiler::writeReport(std::ostream& out) const
+{
+	const double total = seconds();
+	std::size_t bound = 0;
+	for (std::size_t stage = 1; stage < StageCount; ++stage)
+		if (mStages[stage].busyNs > mStages[bound].busyNs)
+			bound = stage;
+
+	char line[256];
+	std::snprintf(line, sizeof(line), "{\n  \"seconds\": %.6f,\n  \"bytes_in\": %llu,\n"
+			"  \"bytes_out\": %llu,\n  \"mb_per_second_in\": %.1f,\n  \"bound\": \"%s\",\n  \"stages\": [",
+			total, (unsigned long long)mBytesIn.load(), (unsigned long long)mBytesOut.load(),
+			mBytesIn / total / 1e6, StageNames[bound]);
+	out << line;
+	for (std::size_t stage = 0; stage < StageCount; ++stage) {
+		const StageCounters& counters = mStages[stage];
+		std::snprintf(line, sizeof(line), "%s\n    {\"name\": \"%s\", \"calls\": %llu,"
+				" \"busy_seconds\": %.6f, \"utilization\": %.3f, \"stalls\": %llu, \"stall_seconds\": %.6f}",
+				stage ? "," : "", StageNames[stage], (unsigned long long)counters.calls.load(),
+				nsToSeconds(counters.busyNs), nsToSeconds(counters.busyNs) / total,
+				(unsigned long long)counters.stalls.load(), nsToSeconds(counters.stallNs));
+		out << line;
+	}
+	out << "\n  ],\n  \"queues\": [";
+	for (std::size_t queue = 0; queue < QueueCount; ++queue) {
+		const QueueCounters& counters = mQueues[queue];
+		const std::uint64_t samples = counters.samples;
+		std::snprintf(line, sizeof(line), "%s\n    {\"name\": \"%s\", \"capacity\": %zu,"
+				" \"samples\": %llu, \"mean_occupancy\": %.2f, \"max_occupancy\": %zu}",
+				queue ? "," : "", QueueNames[queue], counters.capacity.load(),
+				(unsigned long long)samples, samples ? double(counters.sum) / samples : 0.0,
+				counters.max.load());
+		out << line;
+	}
+	out << "\n  ]\n}\n";
+}
+
+
+void Profiler::writeTrace(std::ostream& out) const
+{
+	std::lock_guard<std::mutex> lock(mTraceMutex);
+	out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+	char line[256];
+	for (std::size_t idx = 0; idx < mTrace.size(); ++idx) {
+		const TraceEvent& event = mTrace[idx];
+		if (event.counter)
+			std::snprintf(line, sizeof(line), "%s\n{\"name\": \"%s queue\", \"ph\": \"C\", \"ts\": %.3f,"
+					" \"pid\": 1, \"args\": {\"size\": %llu}}",
+					idx ? "," : "", event.name, event.startNs / 1e3, (unsigned long long)event.durationNs);
+		else
+			std::snprintf(line, sizeof(line), "%s\n{\"name\": \"%s%s\", \"cat\": \"%s\", \"ph\": \"X\","
+					" \"ts\": %.3f, \"dur\": %.3f, \"pid\": 1, \"tid\": %zu}",
+					idx ? "," : "", event.name, event.stall ? " stall" : "", event.stall ? "stall" : "stage",
+					event.startNs / 1e3, event.durationNs / 1e3, event.thread);
+		out << line;
+	}
+	out << "\n]}\n";
+}
+
+
+const char* Profiler::stageName(Stage stage)
+{
+	return StageNames[stage];
+}
+
+
+const char* Profiler::queueName(Queue queue)
+{
+	return QueueNames[queue];
+}
+
+
+void Profiler::record(Stage stage, bool stall, std::chrono::steady_clock::time_point start,
+		std::chrono::steady_clock::time_point end)
+{
+	const std::uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+	StageCounters& counters = mStages[stage];
+	if (stall) {
+		counters.stallNs.fetch_add(ns, std::memory_order_relaxed);
+		counters.stalls.fetch_add(1, std::memory_order_relaxed);
+	}
+	else {
+		counters.busyNs.fetch_add(ns, std::memory_order_relaxed);
+		counters.calls.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	if (mConfig.trace)
+		addTrace(TraceEvent{StageNames[stage], stall, false, sinceStart(start), ns, 0});
+}
+
+
+void Profiler::addTrace(const TraceEvent& event)
+{
+	std::lock_guard<std::mutex> lock(mTraceMutex);
+	const auto thread = mThreads.emplace(std::this_thread::get_id(), mThreads.size() + 1).first;
+	mTrace.push_back(event);
+	mTrace.back().thread = thread->second;
+}
+
+
+std::uint64_t Profiler::sinceStart(std::chrono::steady_clock::time_point time) const
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(time - mStart).count();
+}
+
+
+double Profiler::seconds() const
+{
+	const std::uint64_t finish = mFinishNs;
+	return nsToSeconds(finish ? finish : std::max<std::uint64_t>(sinceStart(std::chrono::steady_clock::now()), 1));
+}
+
+
+void Profiler::progressLoop()
+{
+	const auto interval = std::chrono::duration<double>(mConfig.progressInterval);
+	std::unique_lock<std::mutex> lock(mProgressMutex);
+	while (!mProgressWake.wait_for(lock, interval, [this]() { return mProgressStop; }))
+		printProgress(false);
+}
+
+
+/// Totals, throughput and stage utilization since previous line.
+void Profiler::printProgress(bool last)
+{
+	if (last) {
+		// final line shows averages of whole conversion
+		mLastBytesIn = 0;
+		mLastSeconds = 0;
+		std::fill(mLastBusyNs, mLastBusyNs + StageCount, 0);
+	}
+	const double now = seconds();
+	const double elapsed = std::max(now - mLastSeconds, 1e-9);
+	const std::uint64_t bytesIn = mBytesIn;
+
+	char line[256];
+	int length = std::snprintf(line, sizeof(line), "\r%.1f MB in, %.1f MB out, %.1f MB/s",
+			bytesIn / 1e6, mBytesOut / 1e6, (bytesIn - mLastBytesIn) / elapsed / 1e6);
+	for (std::size_t stage = 0; stage < StageCount; ++stage) {
+		const std::uint64_t busyNs = mStages[stage].busyNs;
+		length += std::snprintf(line + length, sizeof(line) - length, ", %s %.0f%%",
+				StageNames[stage], nsToSeconds(busyNs - mLastBusyNs[stage]) / elapsed * 100);
+		mLastBusyNs[stage] = busyNs;
+	}
+	mLastBytesIn = bytesIn;
+	mLastSeconds = now;
+
+	*mConfig.progress << line << (last ? "\n" : "") << std::flush;
+}
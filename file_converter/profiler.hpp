@@ -0,0 +1,168 @@
+/**
+ * @file profiler.hpp
+ * @brief Throughput and per-stage instrumentation of conversions
+ *
+ * @author Krzysztof Lasota
+ */
+
+#ifndef PROFILER_HPP_
+#define PROFILER_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+struct ProfilerConfig
+{
+	double progressInterval = 0;    ///< seconds between progress lines, 0 for none
+	std::ostream* progress = nullptr;    ///< destination of progress lines
+	bool trace = false;             ///< keep events for writeTrace()
+};
+
+
+/**
+ * @brief Counters shared by all stages of one conversion.
+ *
+ * Conversions take optional pointer to profiler, all members may be
+ * called from any thread. Counters are relaxed atomics, so enabled
+ * profiler costs two clock reads per chunk and stage; trace events are
+ * kept only on request.
+ */
+class Profiler
+{
+public:
+	enum Stage
+	{
+		Read,
+		Convert,
+		Write
+	};
+	static const std::size_t StageCount = 3;
+
+	enum Queue
+	{
+		ReadQueue,     ///< read chunks waiting for converter
+		WriteQueue     ///< converted chunks waiting for writer
+	};
+	static const std::size_t QueueCount = 2;
+
+	/**
+	 * @brief Time of stage spent on scope, working or waiting for other stage.
+	 *
+	 * Does nothing for null profiler.
+	 */
+	class Scope
+	{
+	public:
+		Scope(Profiler* profiler_, Stage stage_, bool stall_ = false);
+		~Scope();
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		Profiler* mProfiler;
+		Stage mStage;
+		bool mStall;
+		std::chrono::steady_clock::time_point mStart;
+	};
+
+	explicit
+	Profiler(const ProfilerConfig& config = ProfilerConfig());
+
+	/// Stops progress line.
+	~Profiler();
+
+	Profiler(const Profiler&) = delete;
+	Profiler& operator=(const Profiler&) = delete;
+
+	void addBytesIn(std::uint64_t bytes);
+	void addBytesOut(std::uint64_t bytes);
+
+	/// Records number of elements in queue.
+	void sampleQueue(Queue queue, std::size_t size, std::size_t capacity);
+
+	/// Stops the clock and progress line, prints last progress line.
+	void finish();
+
+	/**
+	 * @brief JSON report of counters.
+	 *
+	 * Field "bound" names stage with highest busy time, the one limiting
+	 * throughput.
+	 */
+	void writeReport(std::ostream& out) const;
+
+	/// Chrome trace-event JSON (chrome://tracing, Perfetto) of all scopes.
+	void writeTrace(std::ostream& out) const;
+
+	static const char* stageName(Stage stage);
+	static const char* queueName(Queue queue);
+
+private:
+	struct StageCounters
+	{
+		std::atomic<std::uint64_t> busyNs;
+		std::atomic<std::uint64_t> calls;
+		std::atomic<std::uint64_t> stallNs;
+		std::atomic<std::uint64_t> stalls;
+	};
+
+	struct QueueCounters
+	{
+		std::atomic<std::uint64_t> sum;
+		std::atomic<std::uint64_t> samples;
+		std::atomic<std::size_t> max;
+		std::atomic<std::size_t> capacity;
+	};
+
+	/// Complete event ("ph": "X") or counter event ("ph": "C") of trace.
+	struct TraceEvent
+	{
+		const char* name;
+		bool stall;
+		bool counter;
+		std::uint64_t startNs;
+		std::uint64_t durationNs;    ///< value for counter
+		std::size_t thread;
+	};
+
+	void record(Stage stage, bool stall, std::chrono::steady_clock::time_point start,
+			std::chrono::steady_clock::time_point end);
+	void addTrace(const TraceEvent& event);
+	std::uint64_t sinceStart(std::chrono::steady_clock::time_point time) const;
+	double seconds() const;
+	void progressLoop();
+	void printProgress(bool last);
+
+	const ProfilerConfig mConfig;
+	const std::chrono::steady_clock::time_point mStart;
+	std::atomic<std::uint64_t> mFinishNs;    ///< 0 while running
+
+	std::atomic<std::uint64_t> mBytesIn;
+	std::atomic<std::uint64_t> mBytesOut;
+	StageCounters mStages[StageCount];
+	QueueCounters mQueues[QueueCount];
+
+	mutable std::mutex mTraceMutex;
+	std::vector<TraceEvent> mTrace;
+	std::map<std::thread::id, std::size_t> mThreads;    ///< small trace ids
+
+	std::mutex mProgressMutex;
+	std::condition_variable mProgressWake;
+	bool mProgressStop;
+	std::thread mProgressThread;
+	std::uint64_t mLastBytesIn;
+	std::uint64_t mLastBusyNs[StageCount];
+	double mLastSeconds;
+};
+
+#endif /* PROFILER_HPP_ */
@@ -0,0 +1,133 @@
+/**
+ * @file profiler_test.cpp
+ * @brief Test for conversion instrumentation
+ *
+ * @author Krzysztof Lasota
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "conversion.hpp"
+#include "converter.hpp"
+#include "input.hpp"
+#include "output.hpp"
+#include "parallel.hpp"
+#include "pipeline.hpp"
+#include "profiler.hpp"
+#include "test_utils.hpp"
+
+using namespace test;
+
+
+namespace {
+
+std::string report(const Profiler& profiler)
+{
+	std::ostringstream sout;
+	profiler.writeReport(sout);
+	return sout.str();
+}
+
+} // namespace
+
+
+TEST(Profiler_Test, T01_ScopesAndBound)
+{
+	ProfilerConfig config;
+	config.trace = true;
+	Profiler profiler(config);
+	{
+		Profiler::Scope scope(&profiler, Profiler::Convert);
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	}
+	{
+		Profiler::Scope scope(&profiler, Profiler::Write, true);
+	}
+	{
+		Profiler::Scope scope(nullptr, Profiler::Read);
+	}
+	profiler.addBytesIn(1000);
+	profiler.sampleQueue(Profiler::ReadQueue, 3, 4);
+	profiler.sampleQueue(Profiler::ReadQueue, 1, 4);
+	profiler.finish();
+
+	const std::string json = report(profiler);
+	EXPECT_NE(std::string::npos, json.find("\"bytes_in\": 1000,"));
+	EXPECT_NE(std::string::npos, json.find("\"bound\": \"convert\""));
+	EXPECT_NE(std::string::npos, json.find("{\"name\": \"read\", \"calls\": 0,"));
+	EXPECT_NE(std::string::npos, json.find("{\"name\": \"convert\", \"calls\": 1,"));
+	EXPECT_NE(std::string::npos, json.find("\"stalls\": 1,"));
+	EXPECT_NE(std::string::npos, json.find("\"capacity\": 4, \"samples\": 2, \"mean_occupancy\": 2.00, \"max_occupancy\": 3"));
+
+	std::ostringstream trace;
+	profiler.writeTrace(trace);
+	EXPECT_NE(std::string::npos, trace.str().find("\"name\": \"convert\", \"cat\": \"stage\", \"ph\": \"X\""));
+	EXPECT_NE(std::string::npos, trace.str().find("\"name\": \"write stall\", \"cat\": \"stall\""));
+	EXPECT_NE(std::string::npos, trace.str().find("\"name\": \"read queue\", \"ph\": \"C\""));
+}
+
+TEST(Profiler_Test, T02_ProgressLine)
+{
+	std::ostringstream progress;
+	ProfilerConfig config;
+	config.progressInterval = 0.01;
+	config.progress = &progress;
+	{
+		Profiler profiler(config);
+		profiler.addBytesIn(2000000);
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	}
+
+	const std::string lines = progress.str();
+	EXPECT_EQ('\r', lines.front());
+	EXPECT_EQ('\n', lines.back());
+	EXPECT_NE(std::string::npos, lines.find("2.0 MB in, 0.0 MB out"));
+	EXPECT_NE(std::string::npos, lines.find("read 0%, convert 0%, write 0%"));
+}
+
+TEST(Profiler_Test, T03_ConversionsCountBytes)
+{
+	TempFile source, target;
+	const std::string data = patternData(1000000);
+	source.write(data);
+	std::unique_ptr<Converter> converter = Converter::create("upper");
+
+	Profiler serial;
+	{
+		std::unique_ptr<Input> input = Input::open(source.path());
+		std::unique_ptr<Output> output = Output::open(target.path());
+		convert(*input, *converter, *output, 4096, &serial);
+	}
+	EXPECT_NE(std::string::npos, report(serial).find("\"bytes_out\": 1000000,"));
+
+	Profiler pipelined;
+	{
+		PipeWriter writer(data);
+		std::unique_ptr<Input> input = Input::fromDescriptor(writer.readFd(), true);
+		std::unique_ptr<Output> output = Output::open(target.path());
+		PipelineConfig config;
+		config.chunkSize = 4096;
+		config.profiler = &pipelined;
+		convertPipelined(*input, *converter, *output, config);
+	}
+	EXPECT_NE(std::string::npos, report(pipelined).find("\"bytes_in\": 1000000,"));
+	EXPECT_NE(std::string::npos, report(pipelined).find("\"bytes_out\": 1000000,"));
+	EXPECT_EQ(std::string::npos, report(pipelined).find("\"samples\": 0,"));
+
+	Profiler parallel;
+	{
+		std::unique_ptr<Input> input = Input::open(source.path());
+		std::unique_ptr<Output> output = Output::open(target.path());
+		ParallelConfig config;
+		config.blockSize = 4096;
+		config.threads = 2;
+		config.profiler = &parallel;
+		convertParallel(*input, []() { return Converter::create("upper"); }, *output, config);
+	}
+	EXPECT_NE(std::string::npos, report(parallel).find("\"bytes_out\": 1000000,"));
+}
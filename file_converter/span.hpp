@@ -0,0 +1,75 @@
+/**
+ * @file span.hpp
+ * @brief Non-owning views of contiguous memory passed to converters
+ *
+ * @author Krzysztof Lasota
+ */
+
+#ifndef SPAN_HPP_
+#define SPAN_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+
+/**
+ * @brief Pointer and size of contiguous elements owned by someone else.
+ *
+ * Minimal subset of C++20 std::span, enough to hand memory mapped files
+ * and I/O buffers to converters without copying them.
+ */
+template <typename T>
+class Span
+{
+public:
+	typedef T element_type;
+	typedef std::size_t size_type;
+
+	Span()
+	 : mData(nullptr)
+	 , mSize(0)
+	{
+	}
+
+	Span(T* data_, size_type size_)
+	 : mData(data_)
+	 , mSize(size_)
+	{
+	}
+
+	/// Mutable view converts to read-only view.
+	template <typename U,
+			typename = typename std::enable_if<std::is_convertible<U(*)[], T(*)[]>::value>::type>
+	Span(const Span<U>& other)
+	 : mData(other.data())
+	 , mSize(other.size())
+	{
+	}
+
+	T* data() const { return mData; }
+	size_type size() const { return mSize; }
+	bool empty() const { return mSize == 0; }
+
+	T* begin() const { return mData; }
+	T* end() const { return mData + mSize; }
+	T& operator[](size_type idx) const { return mData[idx]; }
+
+	/// First `count` elements, `count` not greater than size().
+	Span first(size_type count) const { return Span(mData, count); }
+	/// Elements following first `offset` elements, `offset` not greater than size().
+	Span subspan(size_type offset) const { return Span(mData + offset, mSize - offset); }
+
+private:
+	T* mData;
+	size_type mSize;
+};
+
+
+/// Bytes converter reads from.
+typedef Span<const std::uint8_t> InputView;
+
+/// Bytes converter writes to.
+typedef Span<std::uint8_t> OutputView;
+
+#endif /* SPAN_HPP_ */
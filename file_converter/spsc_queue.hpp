@@ -0,0 +1,116 @@
+/**
+ * @file spsc_queue.hpp
+ * @brief Bounded lock-free queue for single producer and single consumer
+ *
+ * @author Krzysztof Lasota
+ */
+
+#ifndef SPSC_QUEUE_HPP_
+#define SPSC_QUEUE_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+
+/**
+ * @brief Ring of fixed capacity, exactly one thread pushes and one pops.
+ *
+ * Indices are owned by one side each and published with release/acquire
+ * ordering, so no locks or read-modify-write operations are needed.
+ * Blocking variants spin shortly, then yield and finally sleep, giving up
+ * when `cancel` flag is raised.
+ */
+template <typename T>
+class SpscQueue
+{
+public:
+	explicit
+	SpscQueue(std::size_t capacity_)
+	 : mSlots(capacity_ + 1)
+	 , mHead(0)
+	 , mTail(0)
+	{
+	}
+
+	SpscQueue(const SpscQueue&) = delete;
+	SpscQueue& operator=(const SpscQueue&) = delete;
+
+	std::size_t capacity() const { return mSlots.size() - 1; }
+
+	/// Approximate number of queued elements, exact for the calling side.
+	std::size_t size() const
+	{
+		const std::size_t tail = mTail.load(std::memory_order_acquire);
+		const std::size_t head = mHead.load(std::memory_order_acquire);
+		return (tail + mSlots.size() - head) % mSlots.size();
+	}
+
+	/// Producer side, false when queue is full.
+	bool tryPush(const T& value)
+	{
+		const std::size_t tail = mTail.load(std::memory_order_relaxed);
+		const std::size_t next = (tail + 1) % mSlots.size();
+		if (next == mHead.load(std::memory_order_acquire))
+			return false;
+		mSlots[tail] = value;
+		mTail.store(next, std::memory_order_release);
+		return true;
+	}
+
+	/// Consumer side, false when queue is empty.
+	bool tryPop(T& value)
+	{
+		const std::size_t head = mHead.load(std::memory_order_relaxed);
+		if (head == mTail.load(std::memory_order_acquire))
+			return false;
+		value = mSlots[head];
+		mHead.store((head + 1) % mSlots.size(), std::memory_order_release);
+		return true;
+	}
+
+	/// Producer side, waits for free slot; false when cancelled.
+	bool push(const T& value, const std::atomic<bool>& cancel)
+	{
+		for (unsigned spin = 0; !tryPush(value); ++spin) {
+			if (cancel.load(std::memory_order_relaxed))
+				return false;
+			backoff(spin);
+		}
+		return true;
+	}
+
+	/// Consumer side, waits for element; false when cancelled.
+	bool pop(T& value, const std::atomic<bool>& cancel)
+	{
+		for (unsigned spin = 0; !tryPop(value); ++spin) {
+			if (cancel.load(std::memory_order_relaxed))
+				return false;
+			backoff(spin);
+		}
+		return true;
+	}
+
+private:
+	static void backoff(unsigned spin)
+	{
+		// stages exchange large buffers, long busy waits gain nothing
+		if (spin >= 1024)
+			std::this_thread::sleep_for(std::chrono::microseconds(50));
+		else if (spin >= 64)
+			std::this_thread::yield();
+	}
+
+	static constexpr std::size_t CacheLineSize = 64;
+
+	std::vector<T> mSlots;
+	// producer and consumer indices on separate cache lines
+	char mPadHead[CacheLineSize];
+	std::atomic<std::size_t> mHead;
+	char mPadTail[CacheLineSize - sizeof(std::atomic<std::size_t>)];
+	std::atomic<std::size_t> mTail;
+};
+
+#endif /* SPSC_QUEUE_HPP_ */
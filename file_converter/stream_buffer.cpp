@@ -0,0 +1,196 @@
+/**
+ * @file stream_buffer.cpp
+ * @brief std::iostream access to conversion inputs and outputs
+ *
+ * @author Krzysztof Lasota
+ */
+
+#include "stream_buffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "input.hpp"
+#include "output.hpp"
+
+
+namespace {
+
+/// Largest put area, positions inside it must fit into int of pbump().
+const std::size_t MaxPutArea = std::size_t(1) << 30;
+
+} // namespace
+
+
+InputStreamBuf::InputStreamBuf(Input& input_)
+ : mInput(input_)
+ , mReleased(0)
+{
+}
+
+
+InputStreamBuf::~InputStreamBuf()
+{
+	try {
+		sync();
+	}
+	catch (const std::exception&) {
+		// destructor must not throw, sync stream explicitly to handle errors
+	}
+}
+
+
+InputStreamBuf::int_type InputStreamBuf::underflow()
+{
+	if (gptr() < egptr())
+		return traits_type::to_int_type(*gptr());
+
+	release();
+	const InputView view = mInput.peek(1);
+	if (view.empty())
+		return traits_type::eof();
+
+	// get area is never written, putback of other character fails
+	char* data = reinterpret_cast<char*>(const_cast<std::uint8_t*>(view.data()));
+	setg(data, data, data + view.size());
+	return traits_type::to_int_type(*gptr());
+}
+
+
+std::streamsize InputStreamBuf::xsgetn(char_type* s, std::streamsize count)
+{
+	const std::streamsize shown = std::min<std::streamsize>(count, egptr() - gptr());
+	if (shown > 0) {
+		std::memcpy(s, gptr(), shown);
+		setg(eback(), gptr() + shown, egptr());
+	}
+	if (shown == count)
+		return count;
+
+	release();
+	const std::size_t copied = mInput.read(OutputView(reinterpret_cast<std::uint8_t*>(s + shown), count - shown));
+	mReleased += copied;
+	return shown + copied;
+}
+
+
+int InputStreamBuf::sync()
+{
+	mInput.consume(gptr() - eback());
+	mReleased += gptr() - eback();
+	setg(nullptr, nullptr, nullptr);
+	return 0;
+}
+
+
+/// Only tells current position.
+InputStreamBuf::pos_type InputStreamBuf::seekoff(off_type off, std::ios_base::seekdir dir,
+		std::ios_base::openmode which)
+{
+	if (off != 0 || dir != std::ios_base::cur || !(which & std::ios_base::in))
+		return pos_type(off_type(-1));
+	return pos_type(mReleased + (gptr() - eback()));
+}
+
+
+void InputStreamBuf::release()
+{
+	mInput.consume(egptr() - eback());
+	mReleased += egptr() - eback();
+	setg(nullptr, nullptr, nullptr);
+}
+
+
+OutputStreamBuf::OutputStreamBuf(Output& output_)
+ : mOutput(output_)
+{
+}
+
+
+OutputStreamBuf::~OutputStreamBuf()
+{
+	try {
+		commit();
+	}
+	catch (const std::exception&) {
+		// destructor must not throw, flush stream explicitly to handle errors
+	}
+}
+
+
+OutputStreamBuf::int_type OutputStreamBuf::overflow(int_type ch)
+{
+	commit();
+	const OutputView view = mOutput.reserve(1);
+	char* data = reinterpret_cast<char*>(view.data());
+	setp(data, data + std::min(view.size(), MaxPutArea));
+
+	if (traits_type::eq_int_type(ch, traits_type::eof()))
+		return traits_type::not_eof(ch);
+	*pptr() = traits_type::to_char_type(ch);
+	pbump(1);
+	return ch;
+}
+
+
+std::streamsize OutputStreamBuf::xsputn(const char_type* s, std::streamsize count)
+{
+	if (count <= epptr() - pptr()) {
+		std::memcpy(pptr(), s, count);
+		pbump(int(count));
+		return count;
+	}
+
+	commit();
+	mOutput.write(InputView(reinterpret_cast<const std::uint8_t*>(s), count));
+	return count;
+}
+
+
+int OutputStreamBuf::sync()
+{
+	commit();
+	return 0;
+}
+
+
+/// Only tells current position.
+OutputStreamBuf::pos_type OutputStreamBuf::seekoff(off_type off, std::ios_base::seekdir dir,
+		std::ios_base::openmode which)
+{
+	if (off != 0 || dir != std::ios_base::cur || !(which & std::ios_base::out))
+		return pos_type(off_type(-1));
+	return pos_type(off_type(mOutput.size() + (pptr() - pbase())));
+}
+
+
+void OutputStreamBuf::commit()
+{
+	if (pbase())
+		mOutput.commit(pptr() - pbase());
+	setp(nullptr, nullptr);
+}
+
+
+InputStream::InputStream(Input& input_)
+ : std::istream(nullptr)
+ , mBuffer(input_)
+{
+	rdbuf(&mBuffer);
+}
+
+
+OutputStream::OutputStream(Output& output_)
+ : std::ostream(nullptr)
+ , mBuffer(output_)
+{
+	rdbuf(&mBuffer);
+}
+
+
+void unsyncStandardStreams()
+{
+	std::ios_base::sync_with_stdio(false);
+	std::cin.tie(nullptr);
+}
@@ -0,0 +1,116 @@
+/**
+ * @file stream_buffer.hpp
+ * @brief std::iostream access to conversion inputs and outputs
+ *
+ * @author Krzysztof Lasota
+ */
+
+#ifndef STREAM_BUFFER_HPP_
+#define STREAM_BUFFER_HPP_
+
+#include <istream>
+#include <ostream>
+#include <streambuf>
+
+class Input;
+class Output;
+
+
+/**
+ * @brief Read-only stream buffer showing views of Input as get area.
+ *
+ * Mapped file is visible as a whole, other inputs one ring buffer view at
+ * a time, so characters are not copied into stream buffer. Bulk reads
+ * (xsgetn) bypass get area and copy straight into caller's buffer.
+ * Errors of Input are thrown through stream functions, std::istream turns
+ * them into badbit unless exceptions() asks to rethrow. sync() and
+ * destructor consume extracted characters from Input, so Input can be
+ * passed on after a header was read through stream.
+ */
+class InputStreamBuf : public std::streambuf
+{
+public:
+	explicit
+	InputStreamBuf(Input& input_);
+
+	/// Consumes extracted characters, errors are lost, sync stream first.
+	~InputStreamBuf();
+
+protected:
+	int_type underflow() override;
+	std::streamsize xsgetn(char_type* s, std::streamsize count) override;
+	int sync() override;
+	pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+
+private:
+	/// Passes whole get area back to input.
+	void release();
+
+	Input& mInput;
+	std::streamoff mReleased;    ///< bytes read before get area
+};
+
+
+/**
+ * @brief Write-only stream buffer using reserved space of Output as put area.
+ *
+ * Characters are formatted directly into mapped file or output block,
+ * bulk writes (xsputn) larger than put area go to Output::write().
+ * sync() commits put area; Output is closed by its owner after stream is
+ * flushed.
+ */
+class OutputStreamBuf : public std::streambuf
+{
+public:
+	explicit
+	OutputStreamBuf(Output& output_);
+
+	/// Commits pending characters, errors are lost, flush stream first.
+	~OutputStreamBuf();
+
+protected:
+	int_type overflow(int_type ch) override;
+	std::streamsize xsputn(const char_type* s, std::streamsize count) override;
+	int sync() override;
+	pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+
+private:
+	/// Commits put area, which becomes empty.
+	void commit();
+
+	Output& mOutput;
+};
+
+
+/// std::istream reading Input, see InputStreamBuf.
+class InputStream : public std::istream
+{
+public:
+	explicit
+	InputStream(Input& input_);
+
+private:
+	InputStreamBuf mBuffer;
+};
+
+/// std::ostream writing Output, see OutputStreamBuf.
+class OutputStream : public std::ostream
+{
+public:
+	explicit
+	OutputStream(Output& output_);
+
+private:
+	OutputStreamBuf mBuffer;
+};
+
+
+/**
+ * @brief Stop synchronizing standard streams with C stdio and untie std::cin.
+ *
+ * Must be called before any standard stream I/O. Reading std::cin then
+ * does not flush std::cout, and both use own buffers.
+ */
+void unsyncStandardStreams();
+
+#endif /* STREAM_BUFFER_HPP_ */
@@ -0,0 +1,141 @@
+/**
+ * @file stream_buffer_test.cpp
+ * @brief Test for iostream access to inputs and outputs
+ *
+ * @author Krzysztof Lasota
+ */
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+
+#include <iterator>
+#include <sstream>
+#include <string>
+
+#include "input.hpp"
+#include "output.hpp"
+#include "stream_buffer.hpp"
+#include "test_utils.hpp"
+
+using namespace test;
+
+
+namespace {
+
+std::string lines(std::size_t count)
+{
+	std::ostringstream sout;
+	for (std::size_t line = 0; line < count; ++line)
+		sout << "line " << line << ' ' << patternData(line % 100) << '\n';
+	return sout.str();
+}
+
+} // namespace
+
+
+TEST(InputStream_Test, T01_MappedLines)
+{
+	TempFile source;
+	const std::string data = lines(10000);
+	source.write(data);
+
+	std::unique_ptr<Input> input = Input::open(source.path());
+	InputStream in(*input);
+	std::ostringstream copy;
+	for (std::string line; std::getline(in, line); )
+		copy << line << '\n';
+
+	EXPECT_EQ(data, copy.str());
+	EXPECT_TRUE(in.eof());
+}
+
+TEST(InputStream_Test, T02_PipeBulkAndCharacters)
+{
+	const std::string data = patternData(300001);
+	PipeWriter writer(data);
+
+	std::unique_ptr<Input> input = Input::fromDescriptor(writer.readFd(), true);
+	InputStream in(*input);
+	std::string head(3, '\0'), body(200000, '\0');
+	in.read(&head[0], head.size());
+	EXPECT_EQ(3, in.tellg());
+	in.read(&body[0], body.size());
+	const std::string tail((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+	EXPECT_EQ(data, head + body + tail);
+}
+
+TEST(InputStream_Test, T03_HeaderReadThroughStreamIsConsumed)
+{
+	TempFile source;
+	const std::string body = lines(100);
+	source.write("header\n" + body);
+
+	std::unique_ptr<Input> input = Input::open(source.path());
+	std::string header;
+	{
+		InputStream in(*input);
+		std::getline(in, header);
+	}
+	const InputView rest = input->peek();
+
+	EXPECT_EQ("header", header);
+	EXPECT_EQ(body, std::string(rest.begin(), rest.end()));
+}
+
+TEST(InputStream_Test, T04_SyncConsumesExtracted)
+{
+	const std::string data = patternData(1000);
+	PipeWriter writer(data);
+
+	std::unique_ptr<Input> input = Input::fromDescriptor(writer.readFd(), true);
+	InputStream in(*input);
+	in.get();
+	in.get();
+	EXPECT_EQ(0, in.sync());
+	EXPECT_EQ(2, in.tellg());
+
+	std::string rest(data.size() - 2, '\0');
+	EXPECT_EQ(rest.size(), input->read(OutputView(reinterpret_cast<std::uint8_t*>(&rest[0]), rest.size())));
+	EXPECT_EQ(data.substr(2), rest);
+}
+
+TEST(OutputStream_Test, T01_MappedFormattedAndBulk)
+{
+	TempFile target;
+	const std::string data = lines(10000);
+	const std::string bulk = patternData(3 << 20);
+	{
+		std::unique_ptr<Output> output = Output::open(target.path());
+		OutputStream out(*output);
+		out << data << 42 << ' ';
+		out.write(bulk.data(), bulk.size());
+		out << "end";
+		EXPECT_EQ(std::streamoff(data.size() + 3 + bulk.size() + 3), std::streamoff(out.tellp()));
+		out.flush();
+		output->close();
+		EXPECT_TRUE(out.good());
+	}
+
+	EXPECT_EQ(data + "42 " + bulk + "end", target.read());
+}
+
+TEST(OutputStream_Test, T02_GatheredLines)
+{
+	TempFile target;
+	const std::string data = lines(100000);
+	{
+		// write only descriptor can not be mapped
+		std::unique_ptr<Output> output = Output::fromDescriptor(
+				::open(target.path().c_str(), O_WRONLY | O_TRUNC), true);
+		OutputStream out(*output);
+		std::istringstream in(data);
+		for (std::string line; std::getline(in, line); )
+			out << line << '\n';
+		out.flush();
+		output->close();
+	}
+
+	EXPECT_EQ(data, target.read());
+}
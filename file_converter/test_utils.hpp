@@ -0,0 +1,192 @@
+/**
+ * @file test_utils.hpp
+ * @brief Helpers shared by unit tests
+ *
+ * @author Krzysztof Lasota
+ */
+
+#ifndef TEST_UTILS_HPP_
+#define TEST_UTILS_HPP_
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <ftw.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "converter.hpp"
+
+
+namespace test {
+
+inline std::string patternData(std::size_t size)
+{
+	std::string data(size, '\0');
+	for (std::size_t idx = 0; idx < size; ++idx)
+		data[idx] = 'a' + (idx * 7 + idx / 26) % 26;
+	return data;
+}
+
+/// Temporary file removed with the object.
+class TempFile
+{
+public:
+	TempFile()
+	{
+		char name[] = "/tmp/file_converter_test_XXXXXX";
+		const int fd = mkstemp(name);
+		::close(fd);
+		mPath = name;
+	}
+
+	~TempFile()
+	{
+		unlink(mPath.c_str());
+	}
+
+	const std::string& path() const { return mPath; }
+
+	void write(const std::string& data) const
+	{
+		std::ofstream(mPath, std::ios::binary) << data;
+	}
+
+	std::string read() const
+	{
+		std::ostringstream sout;
+		sout << std::ifstream(mPath, std::ios::binary).rdbuf();
+		return sout.str();
+	}
+
+private:
+	std::string mPath;
+};
+
+/// Temporary directory removed with its content.
+class TempDir
+{
+public:
+	TempDir()
+	{
+		char name[] = "/tmp/file_converter_test_XXXXXX";
+		mPath = mkdtemp(name);
+	}
+
+	~TempDir()
+	{
+		nftw(mPath.c_str(), [](const char* path, const struct stat*, int, FTW*) { return ::remove(path); },
+				16, FTW_DEPTH | FTW_PHYS);
+	}
+
+	const std::string& path() const { return mPath; }
+
+	/// Writes file at path relative to directory, parent directories must exist.
+	void write(const std::string& file, const std::string& data) const
+	{
+		std::ofstream(mPath + '/' + file, std::ios::binary) << data;
+	}
+
+	void makeDir(const std::string& dir) const
+	{
+		mkdir((mPath + '/' + dir).c_str(), 0777);
+	}
+
+	std::string read(const std::string& file) const
+	{
+		std::ostringstream sout;
+		sout << std::ifstream(mPath + '/' + file, std::ios::binary).rdbuf();
+		return sout.str();
+	}
+
+private:
+	std::string mPath;
+};
+
+/// Writes data into pipe from separate thread, reading end is given away.
+class PipeWriter
+{
+public:
+	explicit
+	PipeWriter(const std::string& data)
+	{
+		// reader may stop early, write error is expected then
+		signal(SIGPIPE, SIG_IGN);
+
+		int fds[2];
+		if (pipe(fds) != 0)
+			throw std::runtime_error("pipe");
+		mReadFd = fds[0];
+		mThread = std::thread([data](int fd) {
+			for (std::size_t done = 0; done < data.size(); ) {
+				// odd sized writes make reader see partial data
+				const ssize_t written = ::write(fd, data.data() + done, std::min<std::size_t>(data.size() - done, 5003));
+				if (written <= 0)
+					break;
+				done += written;
+			}
+			::close(fd);
+		}, fds[1]);
+	}
+
+	~PipeWriter()
+	{
+		mThread.join();
+	}
+
+	int readFd() const { return mReadFd; }
+
+private:
+	int mReadFd;
+	std::thread mThread;
+};
+
+/// Converts only whole 4 bytes groups, swapping their order.
+class SwapConverter : public Converter
+{
+public:
+	Result convert(InputView in, OutputView out, bool last) override
+	{
+		std::size_t size = std::min(in.size(), out.size()) / 4 * 4;
+		for (std::size_t idx = 0; idx < size; idx += 4)
+			for (std::size_t byte = 0; byte < 4; ++byte)
+				out[idx + byte] = in[idx + 3 - byte];
+		if (last && size < 4 && in.size() < 4 && in.size() <= out.size()) {
+			std::copy(in.begin(), in.end(), out.begin());
+			size = in.size();
+		}
+		return Result{size, size};
+	}
+};
+
+/// Reference conversion of whole data in memory.
+inline std::string convertString(Converter& converter, const std::string& data)
+{
+	InputView in(reinterpret_cast<const std::uint8_t*>(data.data()), data.size());
+	std::string result(converter.outputBound(data.size()), '\0');
+	OutputView out(reinterpret_cast<std::uint8_t*>(&result[0]), result.size());
+
+	Converter::Result done;
+	do {
+		done = converter.convert(in, out, true);
+		in = in.subspan(done.consumed);
+		out = out.subspan(done.produced);
+	} while (done.consumed > 0 || done.produced > 0);
+
+	EXPECT_TRUE(in.empty());
+	result.resize(result.size() - out.size());
+	return result;
+}
+
+} // namespace test
+
+#endif /* TEST_UTILS_HPP_ */
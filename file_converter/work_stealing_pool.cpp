@@ -0,0 +1,133 @@
+/**
+ * @file work_stealing_pool.cpp
+ * @brief Thread pool balancing tasks by stealing between worker queues
+ *
+ * @author Krzysztof Lasota
+ */
+
+#include "work_stealing_pool.hpp"
+
+#include <algorithm>
+
+
+namespace {
+
+/// Pool and worker index of the calling thread.
+thread_local const WorkStealingPool* tlsPool = nullptr;
+thread_local std::size_t tlsWorker = WorkStealingPool::NoWorker;
+
+} // namespace
+
+
+const std::size_t WorkStealingPool::NoWorker;
+
+
+WorkStealingPool::WorkStealingPool(std::size_t threads_)
+ : mQueued(0)
+ , mNextWorker(0)
+ , mStop(false)
+{
+	if (threads_ == 0)
+		threads_ = std::max(1u, std::thread::hardware_concurrency());
+
+	for (std::size_t idx = 0; idx < threads_; ++idx)
+		mWorkers.emplace_back(new Worker());
+	for (std::size_t idx = 0; idx < threads_; ++idx)
+		mThreads.emplace_back(&WorkStealingPool::run, this, idx);
+}
+
+
+WorkStealingPool::~WorkStealingPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mWakeMutex);
+		mStop = true;
+	}
+	mWake.notify_all();
+	for (std::thread& thread : mThreads)
+		thread.join();
+}
+
+
+std::size_t WorkStealingPool::size() const
+{
+	return mWorkers.size();
+}
+
+
+void WorkStealingPool::submit(Task task)
+{
+	std::size_t idx;
+	if (tlsPool == this) {
+		idx = tlsWorker;
+	}
+	else {
+		std::lock_guard<std::mutex> lock(mWakeMutex);
+		idx = mNextWorker++ % mWorkers.size();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mWorkers[idx]->mutex);
+		mWorkers[idx]->tasks.push_back(std::move(task));
+	}
+	{
+		std::lock_guard<std::mutex> lock(mWakeMutex);
+		++mQueued;
+	}
+	mWake.notify_one();
+}
+
+
+std::size_t WorkStealingPool::currentWorker()
+{
+	return tlsWorker;
+}
+
+
+void WorkStealingPool::run(std::size_t idx)
+{
+	tlsPool = this;
+	tlsWorker = idx;
+
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(mWakeMutex);
+			mWake.wait(lock, [this]() { return mQueued > 0 || mStop; });
+			if (mQueued == 0)
+				return;    // stopped and drained
+			--mQueued;
+		}
+
+		// task counted above is in some deque, search until it is found
+		Task task;
+		while (!take(idx, task))
+			std::this_thread::yield();
+		task();
+	}
+}
+
+
+/// Newest own task, otherwise oldest task of the next busy worker.
+bool WorkStealingPool::take(std::size_t idx, Task& task)
+{
+	{
+		Worker& own = *mWorkers[idx];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (!own.tasks.empty()) {
+			task = std::move(own.tasks.back());
+			own.tasks.pop_back();
+			return true;
+		}
+	}
+
+	for (std::size_t step = 1; step < mWorkers.size(); ++step) {
+		Worker& victim = *mWorkers[(idx + step) % mWorkers.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.tasks.empty()) {
+			task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
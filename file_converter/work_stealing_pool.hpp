@@ -0,0 +1,74 @@
+/**
+ * @file work_stealing_pool.hpp
+ * @brief Thread pool balancing tasks by stealing between worker queues
+ *
+ * @author Krzysztof Lasota
+ */
+
+#ifndef WORK_STEALING_POOL_HPP_
+#define WORK_STEALING_POOL_HPP_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/**
+ * @brief Fixed number of workers, each with own task deque.
+ *
+ * Worker takes newest task of its own deque (warm caches), idle worker
+ * steals oldest task of another one. Tasks submitted by a worker go to its
+ * own deque, other submissions are spread round robin.
+ */
+class WorkStealingPool
+{
+public:
+	typedef std::function<void()> Task;
+
+	/// Not a valid worker index, see currentWorker().
+	static const std::size_t NoWorker = std::size_t(-1);
+
+	/// @param threads_ number of workers, 0 for hardware concurrency
+	explicit
+	WorkStealingPool(std::size_t threads_ = 0);
+
+	/// Runs all submitted tasks before workers finish.
+	~WorkStealingPool();
+
+	WorkStealingPool(const WorkStealingPool&) = delete;
+	WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+	std::size_t size() const;
+
+	/// Queue task; task must not throw.
+	void submit(Task task);
+
+	/// Index of pool worker running the caller, NoWorker outside of pools.
+	static std::size_t currentWorker();
+
+private:
+	struct Worker
+	{
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+
+	void run(std::size_t idx);
+	bool take(std::size_t idx, Task& task);
+
+	std::vector<std::unique_ptr<Worker>> mWorkers;
+	std::vector<std::thread> mThreads;
+
+	std::mutex mWakeMutex;
+	std::condition_variable mWake;
+	std::size_t mQueued;    ///< tasks in all deques, guarded by mWakeMutex
+	std::size_t mNextWorker;
+	bool mStop;
+};
+
+#endif /* WORK_STEALING_POOL_HPP_ */
@@ -0,0 +1,277 @@
+/**
+ ******************************************************************************
+ * @file      BinaryHeap_bench.cpp
+ *
+ * @brief     Insert and Pop timings of BinaryHeap for timer-like elements,
+ *            one by one and in bulk
+ ******************************************************************************
+ */
+
+/*
+ ------------------------------------------------------------------------------
+ Include files
+ ------------------------------------------------------------------------------
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+extern "C" {
+#include "IBinaryHeap.h"
+}
+
+#include "microbench.hpp"
+
+
+/*
+ ------------------------------------------------------------------------------
+ Private types and functions
+ ------------------------------------------------------------------------------
+ */
+
+namespace {
+
+/* Timer entry: due time as key and payload. */
+template<std::size_t Size>
+struct Entry
+{
+    uint64_t due;
+    uint8_t payload[Size - sizeof(uint64_t)];
+};
+
+template<>
+struct Entry<sizeof(uint64_t)>
+{
+    uint64_t due;
+};
+
+template<std::size_t Size>
+bool Earlier( const void *a, const void *b )
+{
+    return static_cast<const Entry<Size> *>(a)->due < static_cast<const Entry<Size> *>(b)->due;
+}
+
+/* Random due times, the same for every run. */
+template<std::size_t Size>
+std::vector<Entry<Size>> Entries( std::size_t count )
+{
+    std::mt19937_64 random(count);
+    std::vector<Entry<Size>> entries(count);
+    for ( Entry<Size> &entry : entries )
+    {
+        entry.due = random();
+    }
+    return entries;
+}
+
+/* Fills empty heap with count elements per iteration. */
+template<std::size_t Size>
+void BM_Insert( microbench::State &state )
+{
+    const std::vector<Entry<Size>> entries = Entries<Size>(state.range());
+    std::vector<Entry<Size>> buffer(entries.size());
+    tIBinaryHeap heap;
+    IBinaryHeap_Init(&heap, buffer.data(), entries.size(), Size, Earlier<Size>);
+
+    for ( auto _ : state )
+    {
+        heap.size = 0;
+        for ( const Entry<Size> &entry : entries )
+        {
+            IBinaryHeap_Insert(&heap, &entry);
+        }
+        microbench::clobberMemory();
+    }
+    state.setItemsProcessed(state.iterations() * entries.size());
+}
+
+/* Empties full heap, count pops per iteration. */
+template<std::size_t Size>
+void BM_Pop( microbench::State &state )
+{
+    const std::vector<Entry<Size>> entries = Entries<Size>(state.range());
+    std::vector<Entry<Size>> buffer(entries.size());
+    tIBinaryHeap heap;
+    IBinaryHeap_Init(&heap, buffer.data(), entries.size(), Size, Earlier<Size>);
+
+    for ( auto _ : state )
+    {
+        state.pauseTiming();
+        for ( const Entry<Size> &entry : entries )
+        {
+            IBinaryHeap_Insert(&heap, &entry);
+        }
+        state.resumeTiming();
+
+        while ( !IBinaryHeap_IsEmpty(&heap) )
+        {
+            microbench::doNotOptimize(*static_cast<Entry<Size> *>(IBinaryHeap_Top(&heap)));
+            IBinaryHeap_Pop(&heap);
+        }
+    }
+    state.setItemsProcessed(state.iterations() * entries.size());
+}
+
+/* Builds heap of count elements by IBinaryHeap_InitFromArray, compare with
+   BM_Insert. */
+template<std::size_t Size>
+void BM_InitFromArray( microbench::State &state )
+{
+    const std::vector<Entry<Size>> entries = Entries<Size>(state.range());
+    std::vector<Entry<Size>> buffer(entries.size());
+    tIBinaryHeap heap;
+
+    for ( auto _ : state )
+    {
+        state.pauseTiming();
+        buffer = entries;
+        state.resumeTiming();
+
+        IBinaryHeap_InitFromArray(&heap, buffer.data(), buffer.size(), buffer.size(), Size, Earlier<Size>);
+        microbench::clobberMemory();
+    }
+    state.setItemsProcessed(state.iterations() * entries.size());
+}
+
+/* Adds the second half of count elements to heap of the first half, one by
+   one or by IBinaryHeap_InsertBatch. */
+template<std::size_t Size, bool Batch>
+void InsertHalf( microbench::State &state )
+{
+    const std::vector<Entry<Size>> entries = Entries<Size>(state.range());
+    const std::size_t half = entries.size() / 2;
+    std::vector<Entry<Size>> buffer(entries.size());
+    tIBinaryHeap heap;
+
+    for ( auto _ : state )
+    {
+        state.pauseTiming();
+        std::copy(entries.begin(), entries.begin() + half, buffer.begin());
+        IBinaryHeap_InitFromArray(&heap, buffer.data(), buffer.size(), half, Size, Earlier<Size>);
+        state.resumeTiming();
+
+        if ( Batch )
+        {
+            IBinaryHeap_InsertBatch(&heap, &entries[half], entries.size() - half);
+        }
+        else
+        {
+            for ( std::size_t idx = half; idx < entries.size(); ++idx )
+            {
+                IBinaryHeap_Insert(&heap, &entries[idx]);
+            }
+        }
+        microbench::clobberMemory();
+    }
+    state.setItemsProcessed(state.iterations() * (entries.size() - half));
+}
+
+template<std::size_t Size>
+void BM_InsertHalf( microbench::State &state )
+{
+    InsertHalf<Size, false>(state);
+}
+
+template<std::size_t Size>
+void BM_InsertBatch( microbench::State &state )
+{
+    InsertHalf<Size, true>(state);
+}
+
+/* Empties full heap by IBinaryHeap_PopN, compare with BM_Pop. */
+template<std::size_t Size>
+void BM_PopN( microbench::State &state )
+{
+    const std::vector<Entry<Size>> entries = Entries<Size>(state.range());
+    std::vector<Entry<Size>> buffer(entries.size());
+    std::vector<Entry<Size>> sorted(entries.size());
+    tIBinaryHeap heap;
+
+    for ( auto _ : state )
+    {
+        state.pauseTiming();
+        buffer = entries;
+        IBinaryHeap_InitFromArray(&heap, buffer.data(), buffer.size(), buffer.size(), Size, Earlier<Size>);
+        state.resumeTiming();
+
+        IBinaryHeap_PopN(&heap, sorted.data(), sorted.size());
+        microbench::doNotOptimize(sorted.front());
+    }
+    state.setItemsProcessed(state.iterations() * entries.size());
+}
+
+/* Growable 32-bit heap, the buffer grows during the first iteration. */
+template<std::size_t Size>
+void BM_Insert32( microbench::State &state )
+{
+    const std::vector<Entry<Size>> entries = Entries<Size>(state.range());
+    tIBinaryHeap32 heap;
+    IBinaryHeap32_InitGrowable(&heap, Size, Earlier<Size>, realloc);
+
+    for ( auto _ : state )
+    {
+        heap.size = 0;
+        for ( const Entry<Size> &entry : entries )
+        {
+            IBinaryHeap32_Insert(&heap, &entry);
+        }
+        microbench::clobberMemory();
+    }
+    IBinaryHeap32_Release(&heap);
+    state.setItemsProcessed(state.iterations() * entries.size());
+}
+
+template<std::size_t Size>
+void BM_Pop32( microbench::State &state )
+{
+    const std::vector<Entry<Size>> entries = Entries<Size>(state.range());
+    tIBinaryHeap32 heap;
+    IBinaryHeap32_InitGrowable(&heap, Size, Earlier<Size>, realloc);
+    IBinaryHeap32_Reserve(&heap, entries.size());
+
+    for ( auto _ : state )
+    {
+        state.pauseTiming();
+        for ( const Entry<Size> &entry : entries )
+        {
+            IBinaryHeap32_Insert(&heap, &entry);
+        }
+        state.resumeTiming();
+
+        while ( !IBinaryHeap32_IsEmpty(&heap) )
+        {
+            microbench::doNotOptimize(*static_cast<Entry<Size> *>(IBinaryHeap32_Top(&heap)));
+            IBinaryHeap32_Pop(&heap);
+        }
+    }
+    IBinaryHeap32_Release(&heap);
+    state.setItemsProcessed(state.iterations() * entries.size());
+}
+
+} // namespace
+
+
+/*
+ ------------------------------------------------------------------------------
+ Benchmarks
+ ------------------------------------------------------------------------------
+ */
+
+/* capacity of heap is 16-bit */
+MICROBENCH(BM_Insert<8>)->arg(1 << 10)->arg(UINT16_MAX);
+MICROBENCH(BM_Insert<16>)->arg(1 << 10)->arg(UINT16_MAX);
+MICROBENCH(BM_Pop<8>)->arg(1 << 10)->arg(UINT16_MAX);
+MICROBENCH(BM_Pop<16>)->arg(1 << 10)->arg(UINT16_MAX);
+MICROBENCH(BM_InitFromArray<8>)->arg(1 << 10)->arg(UINT16_MAX);
+MICROBENCH(BM_InitFromArray<16>)->arg(1 << 10)->arg(UINT16_MAX);
+MICROBENCH(BM_InsertHalf<8>)->arg(1 << 10)->arg(UINT16_MAX);
+MICROBENCH(BM_InsertBatch<8>)->arg(1 << 10)->arg(UINT16_MAX);
+MICROBENCH(BM_PopN<8>)->arg(1 << 10)->arg(UINT16_MAX);
+MICROBENCH(BM_PopN<16>)->arg(1 << 10)->arg(UINT16_MAX);
+MICROBENCH(BM_Insert32<8>)->arg(1 << 10)->arg(1 << 20);
+MICROBENCH(BM_Insert32<16>)->arg(1 << 10)->arg(1 << 20);
+MICROBENCH(BM_Pop32<8>)->arg(1 << 10)->arg(1 << 20);
+MICROBENCH(BM_Pop32<16>)->arg(1 << 10)->arg(1 << 20);
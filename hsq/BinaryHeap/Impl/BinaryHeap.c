@@ -18,26 +18,65 @@
 #include "ISoftwareException.h"
 
 
+/*
+ ------------------------------------------------------------------------------
+ Private type definitions
+ ------------------------------------------------------------------------------
+ */
+
+/* Copy of one element outside of the heap, aligned for any element type. */
+typedef union
+{
+    uint8 bytes[ UINT8_MAX ];
+    uint64 alignInteger;
+    double alignFloat;
+    void *alignPointer;
+
+} tBinaryHeapElement;
+
+
 /*
  ------------------------------------------------------------------------------
  Private function prototypes
  ------------------------------------------------------------------------------
  */
 
-/* Index of left child. */
-static inline uint16 Left( int idx );
+/* Index of left child, 32-bit so that children of 16-bit indices do not wrap. */
+static inline uint32 Left( uint32 idx );
 
 /* Index of right child. */
-static inline uint16 Right( int idx );
+static inline uint32 Right( uint32 idx );
 
 /* Index of parent. */
-static inline uint16 Parent( int idx );
+static inline uint32 Parent( uint32 idx );
 
 /* Return first position of element in the heap. */
-static inline void * At( tIBinaryHeap *pHeap, uint16 idx );
+static inline void * At( tIBinaryHeap *pHeap, uint32 idx );
+
+/* Move hole at idx up until pElem fits, store pElem there. */
+static void SiftUp( uint8 *data, uint8 elementSize, tIBinaryHeap_ComparisonFun compare,
+                    uint32 idx, const void *pElem );
 
-/* Swap elements at indices i and j in the heap. */
-static inline void Swap( tIBinaryHeap *pHeap, uint16 i, uint16 j );
+/* Move hole at idx of heap of size elements down until pElem fits, store
+   pElem there. pElem must not be inside the first size elements. */
+static void SiftDown( uint8 *data, uint8 elementSize, tIBinaryHeap_ComparisonFun compare,
+                      uint32 idx, uint32 size, const void *pElem );
+
+/* Sift element at idx of heap of size elements down. */
+static void SiftDownAt( uint8 *data, uint8 elementSize, tIBinaryHeap_ComparisonFun compare,
+                        uint32 idx, uint32 size );
+
+/* Restore heap order of size elements, of which the ones before first
+   already form a heap. */
+static void Heapify( uint8 *data, uint8 elementSize, tIBinaryHeap_ComparisonFun compare,
+                     uint32 first, uint32 size );
+
+/* Move count top elements of heap of size elements to pOut, in order. */
+static void Drain( uint8 *data, uint8 elementSize, tIBinaryHeap_ComparisonFun compare,
+                   uint32 size, uint8 *pOut, uint32 count );
+
+/* Resize growable buffer to at least capacity elements. */
+static bool Grow( tIBinaryHeap32 *pHeap, uint32 capacity );
 
 
 /*
@@ -102,38 +141,259 @@ void IBinaryHeap_Pop( tIBinaryHeap *pHeap )
 {
     SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL );
 
-    memcpy( At(pHeap, 0), At(pHeap, pHeap->size - 1), pHeap->elementSize );
     --pHeap->size;
 
-    uint16 idx = 0;
-    bool isDone = false;
+    // last element, now just behind the heap, fills the hole left by the top
+    SiftDown( pHeap->data, pHeap->elementSize, pHeap->compare, 0, pHeap->size, At( pHeap, pHeap->size ) );
+}
 
-    while ( !isDone )
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+bool IBinaryHeap_Insert( tIBinaryHeap *pHeap, const void *pElem )
+{
+    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL && pHeap->data != NULL && pElem != NULL );
+
+    if ( pHeap->size >= pHeap->capacity )
     {
-        uint16 minidx = idx;
+        return false;
+    }
 
-        if ( Left(idx) < pHeap->size &&
-             pHeap->compare( At(pHeap, Left( idx )), At(pHeap, minidx )) )
-        {
-            minidx = Left(idx);
-        }
+    SiftUp( pHeap->data, pHeap->elementSize, pHeap->compare, pHeap->size++, pElem );
 
-        if ( Right(idx) < pHeap->size &&
-                pHeap->compare( At(pHeap, Right(idx) ), At(pHeap, minidx) ) )
-        {
-            minidx = Right(idx);
-        }
+    return true;
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+void IBinaryHeap_Apply( tIBinaryHeap *pHeap, tIBinaryHeap_ApplyFun function )
+{
+    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL && pHeap->data != NULL && function != NULL );
+
+    for ( int idx = 0; idx < pHeap->size; ++idx )
+    {
+        function( At(pHeap, idx) );
+    }
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+void IBinaryHeap_InitFromArray( tIBinaryHeap *pHeap,
+                                void *pBuffer,
+                                uint16 capacity,
+                                uint16 size,
+                                uint8 elementSize,
+                                tIBinaryHeap_ComparisonFun compare )
+{
+    if ( size > capacity )
+    {
+        SOFTWARE_EXCEPTION();
+    }
+
+    IBinaryHeap_Init( pHeap, pBuffer, capacity, elementSize, compare );
+
+    pHeap->size = size;
+    Heapify( pHeap->data, pHeap->elementSize, pHeap->compare, 0, pHeap->size );
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+bool IBinaryHeap_InsertBatch( tIBinaryHeap *pHeap, const void *pElems, uint16 count )
+{
+    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL && pHeap->data != NULL && ( pElems != NULL || count == 0 ) );
+
+    if ( count > pHeap->capacity - pHeap->size )
+    {
+        return false;
+    }
+
+    uint16 first = pHeap->size;
+    if ( count > 0 )
+    {
+        memcpy( At( pHeap, first ), pElems, (size_t) count * pHeap->elementSize );
+    }
+    pHeap->size += count;
+    Heapify( pHeap->data, pHeap->elementSize, pHeap->compare, first, pHeap->size );
+
+    return true;
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+uint16 IBinaryHeap_PopN( tIBinaryHeap *pHeap, void *pOut, uint16 count )
+{
+    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL && ( pOut != NULL || count == 0 ) );
+
+    if ( count > pHeap->size )
+    {
+        count = pHeap->size;
+    }
+
+    Drain( pHeap->data, pHeap->elementSize, pHeap->compare, pHeap->size, pOut, count );
+    pHeap->size -= count;
 
-        if ( minidx != idx )
+    return count;
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+void IBinaryHeap32_Init( tIBinaryHeap32 *pHeap,
+                         void *pBuffer,
+                         uint32 capacity,
+                         uint8 elementSize,
+                         tIBinaryHeap_ComparisonFun compare )
+{
+    if ( pHeap == NULL || pBuffer == NULL || capacity == 0 || capacity > IBINARYHEAP32_MAX_CAPACITY ||
+         elementSize == 0 || compare == NULL )
+    {
+        SOFTWARE_EXCEPTION();
+    }
+
+    pHeap->size = 0;
+    pHeap->capacity = capacity;
+    pHeap->elementSize = elementSize;
+    pHeap->data = pBuffer;
+    pHeap->compare = compare;
+    pHeap->reallocate = NULL;
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+void IBinaryHeap32_InitGrowable( tIBinaryHeap32 *pHeap,
+                                 uint8 elementSize,
+                                 tIBinaryHeap_ComparisonFun compare,
+                                 tIBinaryHeap_ReallocFun reallocate )
+{
+    if ( pHeap == NULL || elementSize == 0 || compare == NULL || reallocate == NULL )
+    {
+        SOFTWARE_EXCEPTION();
+    }
+
+    pHeap->size = 0;
+    pHeap->capacity = 0;
+    pHeap->elementSize = elementSize;
+    pHeap->data = NULL;
+    pHeap->compare = compare;
+    pHeap->reallocate = reallocate;
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+bool IBinaryHeap32_Reserve( tIBinaryHeap32 *pHeap, uint32 capacity )
+{
+    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL );
+
+    return capacity <= pHeap->capacity || Grow( pHeap, capacity );
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+void IBinaryHeap32_Release( tIBinaryHeap32 *pHeap )
+{
+    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL );
+
+    if ( pHeap->reallocate != NULL )
+    {
+        if ( pHeap->data != NULL )
         {
-            Swap(pHeap, minidx, idx);
-            idx = minidx;
+            (void) pHeap->reallocate( pHeap->data, 0 );
         }
-        else
+        pHeap->data = NULL;
+        pHeap->capacity = 0;
+    }
+    pHeap->size = 0;
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+bool IBinaryHeap32_IsEmpty( tIBinaryHeap32 *pHeap )
+{
+    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL );
+
+    return pHeap->size == 0;
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+void * IBinaryHeap32_Top( tIBinaryHeap32 *pHeap )
+{
+    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL );
+
+    return pHeap->data;
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+void IBinaryHeap32_Pop( tIBinaryHeap32 *pHeap )
+{
+    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL );
+
+    --pHeap->size;
+
+    // last element, now just behind the heap, fills the hole left by the top
+    SiftDown( pHeap->data, pHeap->elementSize, pHeap->compare, 0, pHeap->size,
+              (uint8 *) pHeap->data + (size_t) pHeap->size * pHeap->elementSize );
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+bool IBinaryHeap32_Insert( tIBinaryHeap32 *pHeap, const void *pElem )
+{
+    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL && pElem != NULL );
+
+    if ( pHeap->size >= pHeap->capacity )
+    {
+        // double capacity, up to the limit
+        uint32 capacity = ( pHeap->capacity == 0 ) ? IBINARYHEAP32_INITIAL_CAPACITY :
+                          ( pHeap->capacity > IBINARYHEAP32_MAX_CAPACITY / 2 ) ? IBINARYHEAP32_MAX_CAPACITY :
+                          2 * pHeap->capacity;
+        if ( pHeap->size == capacity || !Grow( pHeap, capacity ) )
         {
-            isDone = true;
+            return false;
         }
     }
+
+    SiftUp( pHeap->data, pHeap->elementSize, pHeap->compare, pHeap->size++, pElem );
+
+    return true;
 }
 
 /*
@@ -141,24 +401,76 @@ void IBinaryHeap_Pop( tIBinaryHeap *pHeap )
  * Function
  ******************************************************************************
  */
-bool IBinaryHeap_Insert( tIBinaryHeap *pHeap, const void *pElem )
+void IBinaryHeap32_Apply( tIBinaryHeap32 *pHeap, tIBinaryHeap_ApplyFun function )
 {
-    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL && pHeap->data != NULL && pElem != NULL );
+    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL && function != NULL );
 
-    if ( pHeap->size >= pHeap->capacity )
+    for ( uint32 idx = 0; idx < pHeap->size; ++idx )
+    {
+        function( (uint8 *) pHeap->data + (size_t) idx * pHeap->elementSize );
+    }
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+void IBinaryHeap32_InitFromArray( tIBinaryHeap32 *pHeap,
+                                  void *pBuffer,
+                                  uint32 capacity,
+                                  uint32 size,
+                                  uint8 elementSize,
+                                  tIBinaryHeap_ComparisonFun compare )
+{
+    if ( size > capacity )
+    {
+        SOFTWARE_EXCEPTION();
+    }
+
+    IBinaryHeap32_Init( pHeap, pBuffer, capacity, elementSize, compare );
+
+    pHeap->size = size;
+    Heapify( pHeap->data, pHeap->elementSize, pHeap->compare, 0, pHeap->size );
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+bool IBinaryHeap32_InsertBatch( tIBinaryHeap32 *pHeap, const void *pElems, uint32 count )
+{
+    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL && ( pElems != NULL || count == 0 ) );
+
+    if ( count > IBINARYHEAP32_MAX_CAPACITY - pHeap->size )
     {
         return false;
     }
 
-    int idx = pHeap->size++;
-    memcpy( At(pHeap, idx), pElem, pHeap->elementSize );
+    uint32 first = pHeap->size;
+    if ( first + count > pHeap->capacity )
+    {
+        // double capacity like Insert, or more for a large batch
+        uint32 capacity = ( pHeap->capacity > IBINARYHEAP32_MAX_CAPACITY / 2 ) ? IBINARYHEAP32_MAX_CAPACITY :
+                          2 * pHeap->capacity;
+        if ( capacity < first + count )
+        {
+            capacity = first + count;
+        }
+        if ( !Grow( pHeap, capacity ) )
+        {
+            return false;
+        }
+    }
 
-    while ( idx != 0 &&
-            pHeap->compare( At(pHeap, idx), At(pHeap, Parent(idx)) ) )
+    if ( count > 0 )
     {
-        Swap(pHeap, idx, Parent(idx));
-        idx = Parent(idx);
+        memcpy( (uint8 *) pHeap->data + (size_t) first * pHeap->elementSize, pElems,
+                (size_t) count * pHeap->elementSize );
     }
+    pHeap->size += count;
+    Heapify( pHeap->data, pHeap->elementSize, pHeap->compare, first, pHeap->size );
 
     return true;
 }
@@ -168,14 +480,19 @@ bool IBinaryHeap_Insert( tIBinaryHeap *pHeap, const void *pElem )
  * Function
  ******************************************************************************
  */
-void IBinaryHeap_Apply( tIBinaryHeap *pHeap, tIBinaryHeap_ApplyFun function )
+uint32 IBinaryHeap32_PopN( tIBinaryHeap32 *pHeap, void *pOut, uint32 count )
 {
-    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL && pHeap->data != NULL && function != NULL );
+    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL && ( pOut != NULL || count == 0 ) );
 
-    for ( int idx = 0; idx < pHeap->size; ++idx )
+    if ( count > pHeap->size )
     {
-        function( At(pHeap, idx) );
+        count = pHeap->size;
     }
+
+    Drain( pHeap->data, pHeap->elementSize, pHeap->compare, pHeap->size, pOut, count );
+    pHeap->size -= count;
+
+    return count;
 }
 
 /*
@@ -196,7 +513,7 @@ void IBinaryHeap_Apply( tIBinaryHeap *pHeap, tIBinaryHeap_ApplyFun function )
  * Function
  ******************************************************************************
  */
-static inline uint16 Left( int idx )
+static inline uint32 Left( uint32 idx )
 {
     return ( 2 * idx ) + 1;
 }
@@ -206,7 +523,7 @@ static inline uint16 Left( int idx )
  * Function
  ******************************************************************************
  */
-static inline uint16 Right( int idx )
+static inline uint32 Right( uint32 idx )
 {
     return ( 2 * idx ) + 2;
 }
@@ -216,7 +533,7 @@ static inline uint16 Right( int idx )
  * Function
  ******************************************************************************
  */
-static inline uint16 Parent( int idx )
+static inline uint32 Parent( uint32 idx )
 {
     return ( idx - 1 ) / 2;
 }
@@ -226,23 +543,271 @@ static inline uint16 Parent( int idx )
  * Function
  ******************************************************************************
  */
-static inline void * At( tIBinaryHeap *pHeap, uint16 idx )
+static inline void * At( tIBinaryHeap *pHeap, uint32 idx )
 {
     return (void *) ( (uint8 *) pHeap->data + idx * pHeap->elementSize );
 }
 
+/*
+ ******************************************************************************
+ * Sift functions
+ *
+ * Elements are not swapped: the hole travels along the path and each level
+ * costs one move of an element, the sifted element is stored once at the
+ * end. With constant SIZE memcpy compiles to one or two word moves, safe
+ * also for unaligned user buffers. Shared by 16-bit and 32-bit heaps.
+ *
+ * Drain pops with SiftDownToLeaf, the bottom-up variant of SiftDown: the
+ * element taken from the end of the heap mostly belongs near the leaves, so
+ * the hole goes to a leaf with one comparison per level and the element rises
+ * from there by a level or two, instead of two comparisons per level on the
+ * way down.
+ ******************************************************************************
+ */
+#define BINARYHEAP_SIFT_FUNCTIONS( SUFFIX, SIZE ) \
+static void SiftUp##SUFFIX( uint8 *data, uint8 elementSize, tIBinaryHeap_ComparisonFun compare, \
+                            uint32 idx, const void *pElem ) \
+{ \
+    (void) elementSize; \
+    while ( idx != 0 ) \
+    { \
+        uint32 parent = Parent( idx ); \
+        if ( !compare( pElem, data + (size_t) parent * (SIZE) ) ) \
+        { \
+            break; \
+        } \
+        memcpy( data + (size_t) idx * (SIZE), data + (size_t) parent * (SIZE), (SIZE) ); \
+        idx = parent; \
+    } \
+    memcpy( data + (size_t) idx * (SIZE), pElem, (SIZE) ); \
+} \
+\
+static void SiftDown##SUFFIX( uint8 *data, uint8 elementSize, tIBinaryHeap_ComparisonFun compare, \
+                              uint32 idx, uint32 size, const void *pElem ) \
+{ \
+    (void) elementSize; \
+    uint32 child; \
+    while ( ( child = Left( idx ) ) < size ) \
+    { \
+        if ( child + 1 < size && \
+             compare( data + (size_t) ( child + 1 ) * (SIZE), data + (size_t) child * (SIZE) ) ) \
+        { \
+            ++child; \
+        } \
+        if ( !compare( data + (size_t) child * (SIZE), pElem ) ) \
+        { \
+            break; \
+        } \
+        memcpy( data + (size_t) idx * (SIZE), data + (size_t) child * (SIZE), (SIZE) ); \
+        idx = child; \
+    } \
+    if ( idx != size ) \
+    { \
+        memcpy( data + (size_t) idx * (SIZE), pElem, (SIZE) ); \
+    } \
+} \
+\
+static void SiftDownAt##SUFFIX( uint8 *data, uint8 elementSize, tIBinaryHeap_ComparisonFun compare, \
+                                uint32 idx, uint32 size ) \
+{ \
+    tBinaryHeapElement elem; \
+    memcpy( elem.bytes, data + (size_t) idx * (SIZE), (SIZE) ); \
+    SiftDown##SUFFIX( data, elementSize, compare, idx, size, elem.bytes ); \
+} \
+\
+static void SiftDownToLeaf##SUFFIX( uint8 *data, uint8 elementSize, tIBinaryHeap_ComparisonFun compare, \
+                                    uint32 size, const void *pElem ) \
+{ \
+    uint32 idx = 0; \
+    uint32 child; \
+    while ( ( child = Left( idx ) ) < size ) \
+    { \
+        if ( child + 1 < size && \
+             compare( data + (size_t) ( child + 1 ) * (SIZE), data + (size_t) child * (SIZE) ) ) \
+        { \
+            ++child; \
+        } \
+        memcpy( data + (size_t) idx * (SIZE), data + (size_t) child * (SIZE), (SIZE) ); \
+        idx = child; \
+    } \
+    SiftUp##SUFFIX( data, elementSize, compare, idx, pElem ); \
+} \
+\
+static void Drain##SUFFIX( uint8 *data, uint8 elementSize, tIBinaryHeap_ComparisonFun compare, \
+                           uint32 size, uint8 *pOut, uint32 count ) \
+{ \
+    for ( uint32 idx = 0; idx < count; ++idx ) \
+    { \
+        memcpy( pOut + (size_t) idx * (SIZE), data, (SIZE) ); \
+        if ( --size > 0 ) \
+        { \
+            SiftDownToLeaf##SUFFIX( data, elementSize, compare, size, data + (size_t) size * (SIZE) ); \
+        } \
+    } \
+}
+
+BINARYHEAP_SIFT_FUNCTIONS( 4, 4u )
+BINARYHEAP_SIFT_FUNCTIONS( 8, 8u )
+BINARYHEAP_SIFT_FUNCTIONS( 16, 16u )
+BINARYHEAP_SIFT_FUNCTIONS( Any, elementSize )
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+static void SiftUp( uint8 *data, uint8 elementSize, tIBinaryHeap_ComparisonFun compare,
+                    uint32 idx, const void *pElem )
+{
+    switch ( elementSize )
+    {
+        case 4:
+            SiftUp4( data, elementSize, compare, idx, pElem );
+            break;
+        case 8:
+            SiftUp8( data, elementSize, compare, idx, pElem );
+            break;
+        case 16:
+            SiftUp16( data, elementSize, compare, idx, pElem );
+            break;
+        default:
+            SiftUpAny( data, elementSize, compare, idx, pElem );
+            break;
+    }
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+static void SiftDown( uint8 *data, uint8 elementSize, tIBinaryHeap_ComparisonFun compare,
+                      uint32 idx, uint32 size, const void *pElem )
+{
+    switch ( elementSize )
+    {
+        case 4:
+            SiftDown4( data, elementSize, compare, idx, size, pElem );
+            break;
+        case 8:
+            SiftDown8( data, elementSize, compare, idx, size, pElem );
+            break;
+        case 16:
+            SiftDown16( data, elementSize, compare, idx, size, pElem );
+            break;
+        default:
+            SiftDownAny( data, elementSize, compare, idx, size, pElem );
+            break;
+    }
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+static void SiftDownAt( uint8 *data, uint8 elementSize, tIBinaryHeap_ComparisonFun compare,
+                        uint32 idx, uint32 size )
+{
+    switch ( elementSize )
+    {
+        case 4:
+            SiftDownAt4( data, elementSize, compare, idx, size );
+            break;
+        case 8:
+            SiftDownAt8( data, elementSize, compare, idx, size );
+            break;
+        case 16:
+            SiftDownAt16( data, elementSize, compare, idx, size );
+            break;
+        default:
+            SiftDownAtAny( data, elementSize, compare, idx, size );
+            break;
+    }
+}
+
+/*
+ ******************************************************************************
+ * Function
+ *
+ * Floyd's construction: parents are sifted down from the last one to the
+ * root, O(size) in total. Only ancestors of the new elements can be out of
+ * order, they form one range of indices per iteration: the parents of the
+ * previous range, up to the root. Nodes of a range are sifted in decreasing
+ * order, so children are always heaps when their parent is sifted.
+ ******************************************************************************
+ */
+static void Heapify( uint8 *data, uint8 elementSize, tIBinaryHeap_ComparisonFun compare,
+                     uint32 first, uint32 size )
+{
+    if ( first >= size || size < 2 )
+    {
+        return;
+    }
+
+    uint32 low = ( first == 0 ) ? 0 : Parent( first );
+    uint32 high = Parent( size - 1 );
+    for ( ;; )
+    {
+        for ( uint32 idx = high + 1; idx-- > low; )
+        {
+            SiftDownAt( data, elementSize, compare, idx, size );
+        }
+
+        if ( low == 0 )
+        {
+            break;
+        }
+        low = Parent( low );
+        high = Parent( high );
+    }
+}
+
 /*
  ******************************************************************************
  * Function
  ******************************************************************************
  */
-static inline void Swap( tIBinaryHeap *pHeap, uint16 i, uint16 j )
+static void Drain( uint8 *data, uint8 elementSize, tIBinaryHeap_ComparisonFun compare,
+                   uint32 size, uint8 *pOut, uint32 count )
 {
-    for ( int byte = 0; byte < pHeap->elementSize; ++byte )
+    switch ( elementSize )
     {
-        uint8 temp = *( (uint8* ) At(pHeap, i) + byte );
-        *( (uint8* ) At(pHeap, i) + byte ) = *( (uint8* ) At(pHeap, j) + byte );
-        *( (uint8* ) At(pHeap, j) + byte ) = temp;
+        case 4:
+            Drain4( data, elementSize, compare, size, pOut, count );
+            break;
+        case 8:
+            Drain8( data, elementSize, compare, size, pOut, count );
+            break;
+        case 16:
+            Drain16( data, elementSize, compare, size, pOut, count );
+            break;
+        default:
+            DrainAny( data, elementSize, compare, size, pOut, count );
+            break;
     }
 }
 
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+static bool Grow( tIBinaryHeap32 *pHeap, uint32 capacity )
+{
+    if ( pHeap->reallocate == NULL || capacity > IBINARYHEAP32_MAX_CAPACITY ||
+         capacity > (size_t) -1 / pHeap->elementSize )
+    {
+        return false;
+    }
+
+    void *pBuffer = pHeap->reallocate( pHeap->data, (size_t) capacity * pHeap->elementSize );
+    if ( pBuffer == NULL )
+    {
+        return false;
+    }
+
+    pHeap->data = pBuffer;
+    pHeap->capacity = capacity;
+    return true;
+}
@@ -15,6 +15,8 @@
  ------------------------------------------------------------------------------
  */
 
+#include <stddef.h>
+
 #include "RoboticTypes.h"
 
 
@@ -24,6 +26,12 @@
  ------------------------------------------------------------------------------
  */
 
+// max number of elements of tIBinaryHeap32, children indices stay 32-bit
+#define IBINARYHEAP32_MAX_CAPACITY      0x7FFFFFFFu
+
+// capacity of the first buffer of growable tIBinaryHeap32
+#define IBINARYHEAP32_INITIAL_CAPACITY  16u
+
 
 /*
  ------------------------------------------------------------------------------
@@ -49,6 +57,22 @@ typedef struct
 
 } tIBinaryHeap;
 
+// resizes buffer like realloc(): returns NULL on failure and keeps pBuffer,
+// pBuffer == NULL allocates, size == 0 frees (return value ignored)
+typedef void * (*tIBinaryHeap_ReallocFun)( void *pBuffer, size_t size );
+
+// 32-bit indexed variant, for heaps above 65535 elements
+typedef struct
+{
+    uint32 size;
+    uint32 capacity;
+    uint8 elementSize;
+    void *data;
+    tIBinaryHeap_ComparisonFun compare;
+    tIBinaryHeap_ReallocFun reallocate;     // NULL for fixed buffer
+
+} tIBinaryHeap32;
+
 
 /*
  ------------------------------------------------------------------------------
@@ -136,5 +160,249 @@ bool IBinaryHeap_Insert( tIBinaryHeap *pHeap, const void *pElem );
  */
 void IBinaryHeap_Apply( tIBinaryHeap *pHeap, tIBinaryHeap_ApplyFun function );
 
+/**
+ ******************************************************************************
+ * @brief   Initialize the module on a buffer already holding elements, which
+ *          are reordered into a heap in O(size), cheaper than size inserts.
+ *          NOTE: SOFTWARE EXCEPTION if input params are not valid
+ * @param   pHeap
+ *          pointer to heap struct
+ * @param   pBuffer
+ *          user allocated buffer for heap data, with size elements
+ * @param   capacity
+ *          max number of elements to store in the heap
+ * @param   size
+ *          number of elements in pBuffer, at most capacity
+ * @param   elementSize
+ *          size of element to store in the heap
+ * @param   compare
+ *          pointer to function for comparing two elements in the heap
+ ******************************************************************************
+ */
+void IBinaryHeap_InitFromArray( tIBinaryHeap *pHeap,
+                                void *pBuffer,
+                                uint16 capacity,
+                                uint16 size,
+                                uint8 elementSize,
+                                tIBinaryHeap_ComparisonFun compare );
+
+/**
+ ******************************************************************************
+ * @brief   Insert count elements in the heap. Elements are appended and the
+ *          heap order is restored once, bottom-up, for all of them.
+ *          NOTE: SOFTWARE EXCEPTION if input params == NULL
+ * @param   pHeap
+ *          pointer to heap struct
+ * @param   pElems
+ *          pointer to array of elements to insert
+ * @param   count
+ *          number of elements in pElems
+ * @returns true if successful, false if they do not fit (nothing inserted)
+ ******************************************************************************
+ */
+bool IBinaryHeap_InsertBatch( tIBinaryHeap *pHeap, const void *pElems, uint16 count );
+
+/**
+ ******************************************************************************
+ * @brief   Remove up to count top elements from the heap, copying them in
+ *          order to pOut (the count smallest ones of a min heap).
+ *          NOTE: SOFTWARE EXCEPTION if input params == NULL
+ * @param   pHeap
+ *          pointer to heap struct
+ * @param   pOut
+ *          pointer to array for count elements
+ * @param   count
+ *          max number of elements to remove
+ * @returns number of removed elements, less than count if heap got empty
+ ******************************************************************************
+ */
+uint16 IBinaryHeap_PopN( tIBinaryHeap *pHeap, void *pOut, uint16 count );
+
+/**
+ ******************************************************************************
+ * @brief   Initialize 32-bit indexed heap on fixed buffer (embedded mode).
+ *          Other functions behave as IBinaryHeap_ ones.
+ *          NOTE: SOFTWARE EXCEPTION if input params are not valid
+ * @param   pHeap
+ *          pointer to heap struct
+ * @param   pBuffer
+ *          user allocated buffer for heap data
+ * @param   capacity
+ *          max number of elements to store in the heap, at most
+ *          IBINARYHEAP32_MAX_CAPACITY
+ * @param   elementSize
+ *          size of element to store in the heap
+ * @param   compare
+ *          pointer to function for comparing two elements in the heap
+ ******************************************************************************
+ */
+void IBinaryHeap32_Init( tIBinaryHeap32 *pHeap,
+                         void *pBuffer,
+                         uint32 capacity,
+                         uint8 elementSize,
+                         tIBinaryHeap_ComparisonFun compare );
+
+/**
+ ******************************************************************************
+ * @brief   Initialize 32-bit indexed heap with buffer owned by the heap.
+ *          Buffer is allocated on first insert and doubled when full;
+ *          free it with IBinaryHeap32_Release().
+ *          NOTE: SOFTWARE EXCEPTION if input params are not valid
+ * @param   pHeap
+ *          pointer to heap struct
+ * @param   elementSize
+ *          size of element to store in the heap
+ * @param   compare
+ *          pointer to function for comparing two elements in the heap
+ * @param   reallocate
+ *          pointer to function resizing buffer, e.g. realloc
+ ******************************************************************************
+ */
+void IBinaryHeap32_InitGrowable( tIBinaryHeap32 *pHeap,
+                                 uint8 elementSize,
+                                 tIBinaryHeap_ComparisonFun compare,
+                                 tIBinaryHeap_ReallocFun reallocate );
+
+/**
+ ******************************************************************************
+ * @brief   Grow buffer of growable heap to hold at least capacity elements.
+ *          NOTE: SOFTWARE EXCEPTION if pHeap == NULL
+ * @param   pHeap
+ *          pointer to heap struct
+ * @param   capacity
+ *          number of elements
+ * @returns true if heap holds capacity elements without growing, false
+ *          for fixed buffer which is too small or failed allocation
+ ******************************************************************************
+ */
+bool IBinaryHeap32_Reserve( tIBinaryHeap32 *pHeap, uint32 capacity );
+
+/**
+ ******************************************************************************
+ * @brief   Remove all elements, free buffer of growable heap.
+ *          NOTE: SOFTWARE EXCEPTION if pHeap == NULL
+ * @param   pHeap
+ *          pointer to heap struct
+ ******************************************************************************
+ */
+void IBinaryHeap32_Release( tIBinaryHeap32 *pHeap );
+
+/**
+ ******************************************************************************
+ * @brief   Check if heap is empty.
+ *          NOTE: SOFTWARE EXCEPTION if pHeap == NULL
+ * @param   pHeap
+ *          pointer to heap struct
+ * @returns true if empty, false otherwise
+ ******************************************************************************
+ */
+bool IBinaryHeap32_IsEmpty( tIBinaryHeap32 *pHeap );
+
+/**
+ ******************************************************************************
+ * @brief   Get a pointer to the top element in the heap.
+ *          NOTE: SOFTWARE EXCEPTION if pHeap == NULL
+ * @param   pHeap
+ *          pointer to heap struct
+ * @returns pointer to the top element in the heap
+ ******************************************************************************
+ */
+void * IBinaryHeap32_Top( tIBinaryHeap32 *pHeap );
+
+/**
+ ******************************************************************************
+ * @brief   Remove the top element in the heap.
+ *          NOTE: SOFTWARE EXCEPTION if pHeap == NULL
+ * @param   pHeap
+ *          pointer to heap struct
+ ******************************************************************************
+ */
+void IBinaryHeap32_Pop( tIBinaryHeap32 *pHeap );
+
+/**
+ ******************************************************************************
+ * @brief   Insert an element in the heap, growing buffer of growable heap.
+ *          NOTE: SOFTWARE EXCEPTION if input params == NULL
+ * @param   pHeap
+ *          pointer to heap struct
+ * @param   pElem
+ *          pointer to element to insert
+ * @returns true if successful, false when full or allocation failed
+ ******************************************************************************
+ */
+bool IBinaryHeap32_Insert( tIBinaryHeap32 *pHeap, const void *pElem );
+
+/**
+ ******************************************************************************
+ * @brief   Apply a function to each element in the heap.
+ *          NOTE: SOFTWARE EXCEPTION if input params == NULL
+ * @param   pHeap
+ *          pointer to heap struct
+ * @param   function
+ *          pointer to function to apply
+ ******************************************************************************
+ */
+void IBinaryHeap32_Apply( tIBinaryHeap32 *pHeap, tIBinaryHeap_ApplyFun function );
+
+/**
+ ******************************************************************************
+ * @brief   Initialize 32-bit indexed heap on fixed buffer already holding
+ *          elements, which are reordered into a heap in O(size).
+ *          NOTE: SOFTWARE EXCEPTION if input params are not valid
+ * @param   pHeap
+ *          pointer to heap struct
+ * @param   pBuffer
+ *          user allocated buffer for heap data, with size elements
+ * @param   capacity
+ *          max number of elements to store in the heap, at most
+ *          IBINARYHEAP32_MAX_CAPACITY
+ * @param   size
+ *          number of elements in pBuffer, at most capacity
+ * @param   elementSize
+ *          size of element to store in the heap
+ * @param   compare
+ *          pointer to function for comparing two elements in the heap
+ ******************************************************************************
+ */
+void IBinaryHeap32_InitFromArray( tIBinaryHeap32 *pHeap,
+                                  void *pBuffer,
+                                  uint32 capacity,
+                                  uint32 size,
+                                  uint8 elementSize,
+                                  tIBinaryHeap_ComparisonFun compare );
+
+/**
+ ******************************************************************************
+ * @brief   Insert count elements in the heap, growing buffer of growable heap
+ *          once. Heap order is restored once, bottom-up, for all of them.
+ *          NOTE: SOFTWARE EXCEPTION if input params == NULL
+ * @param   pHeap
+ *          pointer to heap struct
+ * @param   pElems
+ *          pointer to array of elements to insert
+ * @param   count
+ *          number of elements in pElems
+ * @returns true if successful, false when they do not fit or allocation
+ *          failed (nothing inserted)
+ ******************************************************************************
+ */
+bool IBinaryHeap32_InsertBatch( tIBinaryHeap32 *pHeap, const void *pElems, uint32 count );
+
+/**
+ ******************************************************************************
+ * @brief   Remove up to count top elements from the heap, copying them in
+ *          order to pOut.
+ *          NOTE: SOFTWARE EXCEPTION if input params == NULL
+ * @param   pHeap
+ *          pointer to heap struct
+ * @param   pOut
+ *          pointer to array for count elements
+ * @param   count
+ *          max number of elements to remove
+ * @returns number of removed elements, less than count if heap got empty
+ ******************************************************************************
+ */
+uint32 IBinaryHeap32_PopN( tIBinaryHeap32 *pHeap, void *pOut, uint32 count );
+
 
 #endif /* IBINARYHEAP_H */
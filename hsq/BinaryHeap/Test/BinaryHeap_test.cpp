@@ -0,0 +1,408 @@
+/**
+ ******************************************************************************
+ * @file      BinaryHeap_test.cpp
+ *
+ * @brief     Host unit tests of BinaryHeap against a sorted reference
+ ******************************************************************************
+ */
+
+/*
+ ------------------------------------------------------------------------------
+ Include files
+ ------------------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+extern "C" {
+#include "IBinaryHeap.h"
+}
+
+#include "HeapTestFixture.hpp"
+
+using namespace heaptest;
+
+
+/*
+ ------------------------------------------------------------------------------
+ Private types and functions
+ ------------------------------------------------------------------------------
+ */
+
+namespace {
+
+/* tIBinaryHeap for CheckRandomOperations. */
+struct BinaryHeap
+{
+    tIBinaryHeap heap;
+
+    bool insert( const void *pElem ) { return IBinaryHeap_Insert(&heap, pElem); }
+    const void * top() { return IBinaryHeap_Top(&heap); }
+    void pop() { IBinaryHeap_Pop(&heap); }
+    uint32 size() const { return heap.size; }
+};
+
+/* Random operations on heap of capacity Size byte elements. */
+template<std::size_t Size>
+void CheckHoleSifts( uint16 capacity )
+{
+    // odd offset, hole moves must not rely on alignment of the buffer
+    std::vector<uint8_t> buffer(capacity * Size + 1);
+    BinaryHeap heap;
+    IBinaryHeap_Init(&heap.heap, buffer.data() + 1, capacity, Size, Less<Size>);
+    CheckRandomOperations<Size>(heap, capacity, capacity, 20000);
+}
+
+bool Less64( const void *a, const void *b )
+{
+    return *static_cast<const uint64_t *>(a) < *static_cast<const uint64_t *>(b);
+}
+
+/* Random bulk operations on 16-bit heap of capacity elements: built from
+   array, then batches (some too large) and PopN of up to size + 2
+   elements, all compared with the sorted reference. */
+template<std::size_t Size>
+void CheckBulkOperations( uint16 capacity, unsigned seed )
+{
+    std::mt19937 random(seed);
+    std::vector<Entry<Size>> buffer(capacity);
+    std::vector<uint32_t> reference;
+    const uint16 initial = random() % ( capacity + 1 );
+    for ( uint16 idx = 0; idx < initial; ++idx )
+    {
+        buffer[idx] = Entry<Size>(random() % 500);
+        reference.push_back(buffer[idx].key());
+    }
+    tIBinaryHeap heap;
+    IBinaryHeap_InitFromArray(&heap, buffer.data(), capacity, initial, Size, Less<Size>);
+    ASSERT_EQ(initial, heap.size);
+
+    for ( int step = 0; step < 6; ++step )
+    {
+        // mixes random keys with a descending run, the worst case of Insert
+        const uint16 count = random() % 4 == 0 ? random() % 4 : random() % ( capacity + 2 );
+        std::vector<Entry<Size>> batch;
+        for ( uint16 idx = 0; idx < count; ++idx )
+        {
+            batch.push_back(Entry<Size>(random() % 2 ? random() % 500 : 1000 - idx));
+        }
+        const bool fits = reference.size() + count <= capacity;
+        ASSERT_EQ(fits, IBinaryHeap_InsertBatch(&heap, batch.data(), count));
+        if ( fits )
+        {
+            for ( const Entry<Size> &entry : batch )
+            {
+                reference.push_back(entry.key());
+            }
+        }
+        ASSERT_EQ(reference.size(), heap.size);
+
+        std::sort(reference.begin(), reference.end());
+        const uint16 requested = random() % ( reference.size() + 3 );
+        const uint16 expected = std::min<std::size_t>(requested, reference.size());
+        // one element more, PopN must not write past what it returns
+        std::vector<Entry<Size>> out(requested + 1, Entry<Size>(0xdead));
+        ASSERT_EQ(expected, IBinaryHeap_PopN(&heap, out.data(), requested));
+        for ( uint16 idx = 0; idx < expected; ++idx )
+        {
+            ASSERT_EQ(reference[idx], out[idx].key()) << "  idx is: " << idx;
+            ASSERT_TRUE(out[idx].intact()) << "  idx is: " << idx;
+        }
+        ASSERT_EQ(0xdeadu, out[expected].key());
+        reference.erase(reference.begin(), reference.begin() + expected);
+    }
+
+    for ( uint32_t key : reference )
+    {
+        ASSERT_EQ(key, static_cast<Entry<Size> *>(IBinaryHeap_Top(&heap))->key());
+        IBinaryHeap_Pop(&heap);
+    }
+}
+
+/* Calls of CountingRealloc growing and freeing buffer. */
+unsigned reallocations;
+unsigned releases;
+
+void * CountingRealloc( void *pBuffer, size_t size )
+{
+    if ( size == 0 )
+    {
+        ++releases;
+        std::free(pBuffer);
+        return NULL;
+    }
+    ++reallocations;
+    return std::realloc(pBuffer, size);
+}
+
+void * FailingRealloc( void *, size_t )
+{
+    return NULL;
+}
+
+} // namespace
+
+
+/*
+ ------------------------------------------------------------------------------
+ Tests
+ ------------------------------------------------------------------------------
+ */
+
+/* Sizes 4, 8 and 16 use the constant size sift functions, others memcpy. */
+TEST(BinaryHeap_Test, T01_HoleSiftsOfEveryElementSize)
+{
+    for ( uint16 capacity : {1, 2, 7, 100, 2000} )
+    {
+        SCOPED_TRACE(capacity);
+        CheckHoleSifts<4>(capacity);
+        CheckHoleSifts<8>(capacity);
+        CheckHoleSifts<16>(capacity);
+        CheckHoleSifts<5>(capacity);
+        CheckHoleSifts<24>(capacity);
+    }
+}
+
+TEST(BinaryHeap_Test, T02_FullAndEmpty)
+{
+    uint32_t buffer[2];
+    tIBinaryHeap heap;
+    IBinaryHeap_Init(&heap, buffer, 2, sizeof(uint32_t), Less32);
+
+    const uint32_t keys[] = {5, 3, 4};
+    EXPECT_TRUE(IBinaryHeap_IsEmpty(&heap));
+    EXPECT_TRUE(IBinaryHeap_Insert(&heap, &keys[0]));
+    EXPECT_TRUE(IBinaryHeap_Insert(&heap, &keys[1]));
+    EXPECT_FALSE(IBinaryHeap_Insert(&heap, &keys[2]));
+    EXPECT_EQ(3u, *static_cast<uint32_t *>(IBinaryHeap_Top(&heap)));
+    IBinaryHeap_Pop(&heap);
+    EXPECT_EQ(5u, *static_cast<uint32_t *>(IBinaryHeap_Top(&heap)));
+    IBinaryHeap_Pop(&heap);
+    EXPECT_TRUE(IBinaryHeap_IsEmpty(&heap));
+}
+
+/* Children of indices above 32767 do not fit 16 bits. */
+TEST(BinaryHeap_Test, T03_FullSixteenBitCapacity)
+{
+    const uint16 capacity = UINT16_MAX;
+    std::vector<uint32_t> buffer(capacity);
+    tIBinaryHeap heap;
+    IBinaryHeap_Init(&heap, buffer.data(), capacity, sizeof(uint32_t), Less32);
+
+    // descending keys, every insert sifts up to the root
+    for ( uint32_t key = capacity; key > 0; --key )
+    {
+        ASSERT_TRUE(IBinaryHeap_Insert(&heap, &key));
+    }
+    for ( uint32_t key = 1; key <= capacity; ++key )
+    {
+        ASSERT_EQ(key, *static_cast<uint32_t *>(IBinaryHeap_Top(&heap)));
+        IBinaryHeap_Pop(&heap);
+    }
+    EXPECT_TRUE(IBinaryHeap_IsEmpty(&heap));
+}
+
+
+TEST(BinaryHeap32_Test, T01_GrowableDoublesAndReleases)
+{
+    reallocations = 0;
+    releases = 0;
+    tIBinaryHeap32 heap;
+    IBinaryHeap32_InitGrowable(&heap, sizeof(uint64_t), Less64, CountingRealloc);
+
+    std::mt19937_64 random(1);
+    std::vector<uint64_t> keys(300000);
+    for ( uint64_t &key : keys )
+    {
+        key = random();
+        ASSERT_TRUE(IBinaryHeap32_Insert(&heap, &key));
+    }
+    EXPECT_EQ(keys.size(), heap.size);
+    EXPECT_GE(heap.capacity, heap.size);
+    // doubling from IBINARYHEAP32_INITIAL_CAPACITY
+    EXPECT_GE(20u, reallocations);
+
+    std::sort(keys.begin(), keys.end());
+    for ( uint64_t key : keys )
+    {
+        ASSERT_EQ(key, *static_cast<uint64_t *>(IBinaryHeap32_Top(&heap)));
+        IBinaryHeap32_Pop(&heap);
+    }
+    EXPECT_TRUE(IBinaryHeap32_IsEmpty(&heap));
+
+    IBinaryHeap32_Release(&heap);
+    EXPECT_EQ(1u, releases);
+    EXPECT_EQ(NULL, heap.data);
+    EXPECT_EQ(0u, heap.capacity);
+}
+
+TEST(BinaryHeap32_Test, T02_ReserveAllocatesOnce)
+{
+    reallocations = 0;
+    tIBinaryHeap32 heap;
+    IBinaryHeap32_InitGrowable(&heap, sizeof(uint64_t), Less64, CountingRealloc);
+
+    ASSERT_TRUE(IBinaryHeap32_Reserve(&heap, 1000));
+    EXPECT_EQ(1000u, heap.capacity);
+    for ( uint64_t key = 0; key < 1000; ++key )
+    {
+        ASSERT_TRUE(IBinaryHeap32_Insert(&heap, &key));
+    }
+    EXPECT_EQ(1u, reallocations);
+    IBinaryHeap32_Release(&heap);
+}
+
+TEST(BinaryHeap32_Test, T03_FailedAllocationKeepsHeap)
+{
+    tIBinaryHeap32 heap;
+    IBinaryHeap32_InitGrowable(&heap, sizeof(uint64_t), Less64, FailingRealloc);
+
+    const uint64_t key = 5;
+    EXPECT_FALSE(IBinaryHeap32_Insert(&heap, &key));
+    EXPECT_FALSE(IBinaryHeap32_Reserve(&heap, 10));
+    EXPECT_TRUE(IBinaryHeap32_IsEmpty(&heap));
+}
+
+/* Fixed buffer above 16-bit size, never grown nor freed. */
+TEST(BinaryHeap32_Test, T04_FixedBufferAboveSixteenBits)
+{
+    const uint32 capacity = 100000;
+    std::vector<uint64_t> buffer(capacity);
+    tIBinaryHeap32 heap;
+    IBinaryHeap32_Init(&heap, buffer.data(), capacity, sizeof(uint64_t), Less64);
+
+    for ( uint64_t key = capacity; key > 0; --key )
+    {
+        ASSERT_TRUE(IBinaryHeap32_Insert(&heap, &key));
+    }
+    const uint64_t extra = 0;
+    EXPECT_FALSE(IBinaryHeap32_Insert(&heap, &extra));
+    EXPECT_FALSE(IBinaryHeap32_Reserve(&heap, capacity + 1));
+    EXPECT_TRUE(IBinaryHeap32_Reserve(&heap, capacity));
+
+    for ( uint64_t key = 1; key <= capacity; ++key )
+    {
+        ASSERT_EQ(key, *static_cast<uint64_t *>(IBinaryHeap32_Top(&heap)));
+        IBinaryHeap32_Pop(&heap);
+    }
+    IBinaryHeap32_Release(&heap);
+    EXPECT_EQ(buffer.data(), heap.data);
+}
+
+
+/* Heapify, Drain and SiftDownToLeaf exist per constant element size. */
+TEST(BinaryHeapBulk_Test, T01_RandomBulkOperationsOfEveryElementSize)
+{
+    for ( unsigned trial = 0; trial < 200; ++trial )
+    {
+        const uint16 capacity = 1 + trial * 7;
+        SCOPED_TRACE(capacity);
+        CheckBulkOperations<4>(capacity, trial);
+        CheckBulkOperations<8>(capacity, trial);
+        CheckBulkOperations<16>(capacity, trial);
+        CheckBulkOperations<12>(capacity, trial);
+        if ( HasFatalFailure() )
+        {
+            return;
+        }
+    }
+}
+
+TEST(BinaryHeapBulk_Test, T02_BatchOntoNonEmptyHeap)
+{
+    uint32_t buffer[8];
+    tIBinaryHeap heap;
+    IBinaryHeap_Init(&heap, buffer, 8, sizeof(uint32_t), Less32);
+    const uint32_t first[] = {5, 9, 7};
+    const uint32_t second[] = {8, 1, 6, 3};
+    ASSERT_TRUE(IBinaryHeap_InsertBatch(&heap, first, 3));
+    ASSERT_TRUE(IBinaryHeap_InsertBatch(&heap, second, 4));
+
+    uint32_t out[7];
+    EXPECT_EQ(7u, IBinaryHeap_PopN(&heap, out, 7));
+    EXPECT_EQ(std::vector<uint32_t>({1, 3, 5, 6, 7, 8, 9}), std::vector<uint32_t>(out, out + 7));
+}
+
+TEST(BinaryHeapBulk_Test, T03_OverflowingBatchInsertsNothing)
+{
+    uint32_t buffer[4] = {4, 2, 3, 0};
+    tIBinaryHeap heap;
+    IBinaryHeap_InitFromArray(&heap, buffer, 4, 3, sizeof(uint32_t), Less32);
+    const uint32_t batch[] = {1, 0};
+
+    EXPECT_FALSE(IBinaryHeap_InsertBatch(&heap, batch, 2));
+    EXPECT_EQ(3u, heap.size);
+    EXPECT_EQ(2u, *static_cast<uint32_t *>(IBinaryHeap_Top(&heap)));
+    // the free slot is not written either
+    EXPECT_EQ(0u, buffer[3]);
+}
+
+TEST(BinaryHeapBulk_Test, T04_PopNLargerThanHeap)
+{
+    uint32_t buffer[3] = {3, 1, 2};
+    tIBinaryHeap heap;
+    IBinaryHeap_InitFromArray(&heap, buffer, 3, 3, sizeof(uint32_t), Less32);
+
+    uint32_t out[5] = {0, 0, 0, 0, 0};
+    EXPECT_EQ(3u, IBinaryHeap_PopN(&heap, out, 5));
+    EXPECT_EQ(std::vector<uint32_t>({1, 2, 3, 0, 0}), std::vector<uint32_t>(out, out + 5));
+    EXPECT_TRUE(IBinaryHeap_IsEmpty(&heap));
+    EXPECT_EQ(0u, IBinaryHeap_PopN(&heap, out, 1));
+}
+
+TEST(BinaryHeapBulk_Test, T05_ThirtyTwoBitBulkOperations)
+{
+    std::mt19937 random(7);
+    tIBinaryHeap32 growable;
+    IBinaryHeap32_InitGrowable(&growable, sizeof(Entry<12>), Less<12>, std::realloc);
+    std::vector<uint32_t> reference;
+    for ( int step = 0; step < 8; ++step )
+    {
+        const uint32 count = random() % 5000;
+        std::vector<Entry<12>> batch;
+        for ( uint32 idx = 0; idx < count; ++idx )
+        {
+            batch.push_back(Entry<12>(random()));
+            reference.push_back(batch.back().key());
+        }
+        ASSERT_TRUE(IBinaryHeap32_InsertBatch(&growable, batch.data(), count));
+
+        std::sort(reference.begin(), reference.end());
+        const uint32 requested = random() % 3000;
+        std::vector<Entry<12>> out(requested);
+        const uint32 popped = IBinaryHeap32_PopN(&growable, out.data(), requested);
+        ASSERT_EQ(std::min<std::size_t>(requested, reference.size()), popped);
+        for ( uint32 idx = 0; idx < popped; ++idx )
+        {
+            ASSERT_EQ(reference[idx], out[idx].key());
+            ASSERT_TRUE(out[idx].intact());
+        }
+        reference.erase(reference.begin(), reference.begin() + popped);
+    }
+    IBinaryHeap32_Release(&growable);
+
+    // full fixed heap from array, then one more and more popped than held
+    const uint32 capacity = 200000;
+    std::vector<uint64_t> buffer(capacity);
+    for ( uint64_t &key : buffer )
+    {
+        key = random();
+    }
+    std::vector<uint64_t> sorted(buffer);
+    std::sort(sorted.begin(), sorted.end());
+    tIBinaryHeap32 fixed;
+    IBinaryHeap32_InitFromArray(&fixed, buffer.data(), capacity, capacity, sizeof(uint64_t), Less64);
+
+    const uint64_t extra = 1;
+    EXPECT_FALSE(IBinaryHeap32_InsertBatch(&fixed, &extra, 1));
+    std::vector<uint64_t> out(capacity);
+    EXPECT_EQ(capacity, IBinaryHeap32_PopN(&fixed, out.data(), capacity + 100));
+    EXPECT_EQ(sorted, out);
+}
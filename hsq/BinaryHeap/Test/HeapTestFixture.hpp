@@ -0,0 +1,102 @@
+/**
+ ******************************************************************************
+ * @file      HeapTestFixture.hpp
+ *
+ * @brief     Elements and random operation check shared by host unit tests
+ *            of heap modules (BinaryHeap, DaryHeap)
+ ******************************************************************************
+ */
+
+#ifndef HEAPTESTFIXTURE_HPP
+#define HEAPTESTFIXTURE_HPP
+
+/*
+ ------------------------------------------------------------------------------
+ Include files
+ ------------------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+
+namespace heaptest {
+
+/* Element of Size bytes, any alignment: key in its last 4 bytes and
+   payload derived from the key in the others, so that a torn move is seen. */
+template<std::size_t Size>
+struct Entry
+{
+    uint8_t bytes[Size];
+
+    explicit Entry( uint32_t key = 0 )
+    {
+        for ( std::size_t idx = 0; idx < Size - sizeof(key); ++idx )
+        {
+            bytes[idx] = static_cast<uint8_t>(key + idx);
+        }
+        std::memcpy(bytes + Size - sizeof(key), &key, sizeof(key));
+    }
+
+    uint32_t key() const
+    {
+        uint32_t value;
+        std::memcpy(&value, bytes + Size - sizeof(value), sizeof(value));
+        return value;
+    }
+
+    bool intact() const
+    {
+        return std::memcmp(bytes, Entry(key()).bytes, Size) == 0;
+    }
+};
+
+template<std::size_t Size>
+bool Less( const void *a, const void *b )
+{
+    return static_cast<const Entry<Size> *>(a)->key() < static_cast<const Entry<Size> *>(b)->key();
+}
+
+inline bool Less32( const void *a, const void *b )
+{
+    return *static_cast<const uint32_t *>(a) < *static_cast<const uint32_t *>(b);
+}
+
+/* Random inserts and pops on heap of capacity elements, top compared with
+   the smallest key of the reference after every operation. Heap adapts
+   the module interface: insert( pElem ), top(), pop() and size(). */
+template<std::size_t Size, typename Heap>
+void CheckRandomOperations( Heap &heap, std::size_t capacity, unsigned seed, unsigned operations )
+{
+    std::mt19937 random(seed);
+    std::vector<uint32_t> reference;
+    for ( unsigned op = 0; op < operations; ++op )
+    {
+        if ( reference.size() < capacity && ( reference.empty() || random() % 3 != 0 ) )
+        {
+            const Entry<Size> entry(random() % 1000);
+            ASSERT_TRUE(heap.insert(&entry));
+            reference.push_back(entry.key());
+        }
+        else
+        {
+            Entry<Size> top;
+            std::memcpy(&top, heap.top(), Size);
+            const auto smallest = std::min_element(reference.begin(), reference.end());
+            ASSERT_EQ(*smallest, top.key()) << "  op is: " << op;
+            ASSERT_TRUE(top.intact()) << "  op is: " << op;
+            reference.erase(smallest);
+            heap.pop();
+        }
+        ASSERT_EQ(reference.size(), heap.size());
+    }
+}
+
+} // namespace heaptest
+
+#endif /* HEAPTESTFIXTURE_HPP */
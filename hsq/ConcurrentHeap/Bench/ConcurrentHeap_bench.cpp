@@ -0,0 +1,163 @@
+/**
+ ******************************************************************************
+ * @file      ConcurrentHeap_bench.cpp
+ *
+ * @brief     Deadlines pushed by producer threads, against a single
+ *            mutex-protected BinaryHeap (one shard)
+ ******************************************************************************
+ */
+
+/*
+ ------------------------------------------------------------------------------
+ Include files
+ ------------------------------------------------------------------------------
+ */
+
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include "IConcurrentHeap.h"
+}
+
+#include "microbench.hpp"
+
+
+/*
+ ------------------------------------------------------------------------------
+ Private types and functions
+ ------------------------------------------------------------------------------
+ */
+
+namespace {
+
+/* Deadlines pushed per iteration, by all producers together. */
+const uint16 DEADLINES = 1u << 15;
+
+/* Deadline entry: due time and id of its task. */
+struct Deadline
+{
+    uint64_t due;
+    uint32_t task;
+    uint32_t producer;
+};
+
+bool Earlier( const void *a, const void *b )
+{
+    return static_cast<const Deadline *>(a)->due < static_cast<const Deadline *>(b)->due;
+}
+
+/* Heap of shards shards, created once as its mutexes are never deleted. */
+tIConcurrentHeap & SharedHeap( uint8 shards )
+{
+    static tIConcurrentHeap heaps[ICONCURRENTHEAP_MAX_SHARDS + 1];
+    static std::vector<uint8_t> buffers[ICONCURRENTHEAP_MAX_SHARDS + 1];
+
+    if ( buffers[shards].empty() )
+    {
+        buffers[shards].resize(ICONCURRENTHEAP_BUFFER_SIZE(shards, DEADLINES, sizeof(Deadline)));
+        IConcurrentHeap_Init(&heaps[shards], buffers[shards].data(), DEADLINES, shards,
+                             sizeof(Deadline), Earlier);
+    }
+    return heaps[shards];
+}
+
+/* Empties heap, no thread may use it. */
+void Clear( tIConcurrentHeap &heap )
+{
+    for ( uint8 idx = 0; idx < heap.shardCount; ++idx )
+    {
+        heap.shards[idx].shard.heap.size = 0;
+    }
+}
+
+/* Random deadlines of every producer, the same for every run. */
+std::vector<std::vector<Deadline>> Deadlines( uint32 producers )
+{
+    std::mt19937_64 random(producers);
+    std::vector<std::vector<Deadline>> deadlines(producers);
+    for ( uint32 producer = 0; producer < producers; ++producer )
+    {
+        for ( uint32 task = 0; task < DEADLINES / producers; ++task )
+        {
+            deadlines[producer].push_back(Deadline{random(), task, producer});
+        }
+    }
+    return deadlines;
+}
+
+/* range(0) producer threads push DEADLINES deadlines to heap of range(1)
+   shards, thread start included. */
+void BM_Insert( microbench::State &state )
+{
+    const uint32 producers = state.range(0);
+    const std::vector<std::vector<Deadline>> deadlines = Deadlines(producers);
+    tIConcurrentHeap &heap = SharedHeap(state.range(1));
+
+    for ( auto _ : state )
+    {
+        state.pauseTiming();
+        Clear(heap);
+        state.resumeTiming();
+
+        std::vector<std::thread> threads;
+        for ( uint32 producer = 0; producer < producers; ++producer )
+        {
+            threads.emplace_back([&heap, &deadlines, producer]() {
+                for ( const Deadline &deadline : deadlines[producer] )
+                {
+                    IConcurrentHeap_Insert(&heap, producer, &deadline);
+                }
+            });
+        }
+        for ( std::thread &thread : threads )
+        {
+            thread.join();
+        }
+    }
+    state.setItemsProcessed(state.iterations() * DEADLINES);
+}
+
+/* Scheduler pops all deadlines from heap of range() shards, each pop looks
+   at the top of every shard. */
+void BM_Pop( microbench::State &state )
+{
+    const std::vector<std::vector<Deadline>> deadlines = Deadlines(state.range());
+    tIConcurrentHeap &heap = SharedHeap(state.range());
+
+    for ( auto _ : state )
+    {
+        state.pauseTiming();
+        Clear(heap);
+        for ( uint32 producer = 0; producer < deadlines.size(); ++producer )
+        {
+            for ( const Deadline &deadline : deadlines[producer] )
+            {
+                IConcurrentHeap_Insert(&heap, producer, &deadline);
+            }
+        }
+        state.resumeTiming();
+
+        Deadline deadline;
+        while ( IConcurrentHeap_Pop(&heap, &deadline) )
+        {
+            microbench::doNotOptimize(deadline);
+        }
+    }
+    state.setItemsProcessed(state.iterations() * DEADLINES);
+}
+
+} // namespace
+
+
+/*
+ ------------------------------------------------------------------------------
+ Benchmarks
+ ------------------------------------------------------------------------------
+ */
+
+/* {producers, shards}, one shard is a single mutex around BinaryHeap */
+MICROBENCH(BM_Insert)->args({1, 1})->args({2, 1})->args({4, 1})->args({2, 2})->args({4, 4});
+MICROBENCH(BM_Pop)->arg(1)->arg(2)->arg(4)->arg(8);
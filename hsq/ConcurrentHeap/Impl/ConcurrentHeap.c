@@ -0,0 +1,289 @@
+/**
+ ******************************************************************************
+ * @file      ConcurrentHeap.c
+ *
+ * @brief     Implementation file for ConcurrentHeap
+ ******************************************************************************
+ */
+
+/*
+ ------------------------------------------------------------------------------
+ Include files
+ ------------------------------------------------------------------------------
+ */
+
+#include "ConcurrentHeap.h"
+#include "IConcurrentHeap.h"
+
+#include "IBinaryHeap.h"
+#include "IOs.h"
+#include "ISoftwareException.h"
+
+
+/*
+ ------------------------------------------------------------------------------
+ Defines
+ ------------------------------------------------------------------------------
+ */
+
+// lock timeout of a try, IOs_MutexLock does not wait
+#define CONCURRENTHEAP_NO_WAIT          ( 0 )
+
+
+/*
+ ------------------------------------------------------------------------------
+ Private function prototypes
+ ------------------------------------------------------------------------------
+ */
+
+/* Shard of index idx. */
+static inline tIConcurrentHeapShard * Shard( tIConcurrentHeap *pHeap, uint8 idx );
+
+/* Wait for mutex of shard. */
+static void Lock( tIConcurrentHeapShard *pShard );
+
+/* Release mutex of shard. */
+static void Unlock( tIConcurrentHeapShard *pShard );
+
+/* Copy top element of all shards to pOut, return index of its shard or
+   shardCount if all are empty. */
+static uint8 FindTop( tIConcurrentHeap *pHeap, void *pOut );
+
+
+/*
+ ------------------------------------------------------------------------------
+ Interface functions
+ ------------------------------------------------------------------------------
+ */
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+void IConcurrentHeap_Init( tIConcurrentHeap *pHeap,
+                           void *pBuffer,
+                           uint16 capacity,
+                           uint8 shardCount,
+                           uint8 elementSize,
+                           tIBinaryHeap_ComparisonFun compare )
+{
+    if ( pHeap == NULL || pBuffer == NULL || capacity == 0 ||
+         shardCount == 0 || shardCount > ICONCURRENTHEAP_MAX_SHARDS ||
+         elementSize == 0 || compare == NULL ||
+         ( (size_t) pHeap % ICONCURRENTHEAP_SHARD_SIZE ) != 0 )
+    {
+        SOFTWARE_EXCEPTION();
+    }
+
+    pHeap->shardCount = shardCount;
+    pHeap->elementSize = elementSize;
+    pHeap->compare = compare;
+
+    for ( uint8 idx = 0; idx < shardCount; ++idx )
+    {
+        tIConcurrentHeapShard *pShard = Shard( pHeap, idx );
+
+        IBinaryHeap_Init( &pShard->shard.heap,
+                          (uint8 *) pBuffer + (size_t) idx * capacity * elementSize,
+                          capacity, elementSize, compare );
+
+        bool mutexCreated = IOs_MutexCreate( &pShard->shard.mutex );
+        SOFTWARE_EXCEPTION_ASSERT( true == mutexCreated );
+    }
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+bool IConcurrentHeap_Insert( tIConcurrentHeap *pHeap, uint8 producer, const void *pElem )
+{
+    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL && pElem != NULL );
+
+    const uint8 home = producer % pHeap->shardCount;
+
+    // any free shard, starting with the home one, is as good as the home one
+    for ( uint8 step = 0; step < pHeap->shardCount; ++step )
+    {
+        tIConcurrentHeapShard *pShard = Shard( pHeap, ( home + step ) % pHeap->shardCount );
+
+        if ( IOs_MutexLock( pShard->shard.mutex, CONCURRENTHEAP_NO_WAIT ) )
+        {
+            bool inserted = IBinaryHeap_Insert( &pShard->shard.heap, pElem );
+            Unlock( pShard );
+            if ( inserted )
+            {
+                return true;
+            }
+        }
+    }
+
+    // all shards busy or full, wait for each in turn
+    for ( uint8 step = 0; step < pHeap->shardCount; ++step )
+    {
+        tIConcurrentHeapShard *pShard = Shard( pHeap, ( home + step ) % pHeap->shardCount );
+
+        Lock( pShard );
+        bool inserted = IBinaryHeap_Insert( &pShard->shard.heap, pElem );
+        Unlock( pShard );
+        if ( inserted )
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+bool IConcurrentHeap_Top( tIConcurrentHeap *pHeap, void *pOut )
+{
+    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL && pOut != NULL );
+
+    return FindTop( pHeap, pOut ) < pHeap->shardCount;
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+bool IConcurrentHeap_Pop( tIConcurrentHeap *pHeap, void *pOut )
+{
+    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL && pOut != NULL );
+
+    for ( ;; )
+    {
+        uint8 idx = FindTop( pHeap, pOut );
+        if ( idx >= pHeap->shardCount )
+        {
+            return false;
+        }
+
+        // top of the shard may have changed since FindTop: a producer only
+        // makes it better, but another consumer may have taken the chosen
+        // one, then a top of other shard can be better and needs a new search
+        tIConcurrentHeapShard *pShard = Shard( pHeap, idx );
+        Lock( pShard );
+        if ( !IBinaryHeap_IsEmpty( &pShard->shard.heap ) )
+        {
+            const void *pTop = IBinaryHeap_Top( &pShard->shard.heap );
+            if ( !pHeap->compare( pOut, pTop ) )
+            {
+                memcpy( pOut, pTop, pHeap->elementSize );
+                IBinaryHeap_Pop( &pShard->shard.heap );
+                Unlock( pShard );
+                return true;
+            }
+        }
+        Unlock( pShard );
+    }
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+bool IConcurrentHeap_IsEmpty( tIConcurrentHeap *pHeap )
+{
+    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL );
+
+    for ( uint8 idx = 0; idx < pHeap->shardCount; ++idx )
+    {
+        tIConcurrentHeapShard *pShard = Shard( pHeap, idx );
+
+        Lock( pShard );
+        bool empty = IBinaryHeap_IsEmpty( &pShard->shard.heap );
+        Unlock( pShard );
+        if ( !empty )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+ ------------------------------------------------------------------------------
+ Public functions
+ ------------------------------------------------------------------------------
+ */
+
+
+/*
+ ------------------------------------------------------------------------------
+ Private functions
+ ------------------------------------------------------------------------------
+ */
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+static inline tIConcurrentHeapShard * Shard( tIConcurrentHeap *pHeap, uint8 idx )
+{
+    return &pHeap->shards[idx];
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+static void Lock( tIConcurrentHeapShard *pShard )
+{
+    bool locked = IOs_MutexLock( pShard->shard.mutex, IOS_TIMEOUT_FOREVER );
+    SOFTWARE_EXCEPTION_ASSERT( true == locked );
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+static void Unlock( tIConcurrentHeapShard *pShard )
+{
+    bool unlocked = IOs_MutexUnlock( pShard->shard.mutex );
+    SOFTWARE_EXCEPTION_ASSERT( true == unlocked );
+}
+
+/*
+ ******************************************************************************
+ * Function
+ *
+ * Tournament of shard tops: each shard is locked only to compare its top
+ * with the best one so far, producers on other shards go on meanwhile.
+ ******************************************************************************
+ */
+static uint8 FindTop( tIConcurrentHeap *pHeap, void *pOut )
+{
+    uint8 best = pHeap->shardCount;
+
+    for ( uint8 idx = 0; idx < pHeap->shardCount; ++idx )
+    {
+        tIConcurrentHeapShard *pShard = Shard( pHeap, idx );
+
+        Lock( pShard );
+        if ( !IBinaryHeap_IsEmpty( &pShard->shard.heap ) )
+        {
+            const void *pTop = IBinaryHeap_Top( &pShard->shard.heap );
+            if ( best == pHeap->shardCount || pHeap->compare( pTop, pOut ) )
+            {
+                memcpy( pOut, pTop, pHeap->elementSize );
+                best = idx;
+            }
+        }
+        Unlock( pShard );
+    }
+
+    return best;
+}
@@ -0,0 +1,43 @@
+/**
+ ******************************************************************************
+ * @file      ConcurrentHeap.h
+ * 
+ * @brief     Header file for ConcurrentHeap implementation
+ ******************************************************************************
+ */
+
+#ifndef CONCURRENTHEAP_H
+#define CONCURRENTHEAP_H
+
+
+/*
+ ------------------------------------------------------------------------------
+    Include files
+ ------------------------------------------------------------------------------
+ */
+
+#include "IConcurrentHeap.h"
+
+
+/*
+ ------------------------------------------------------------------------------
+    Defines
+ ------------------------------------------------------------------------------
+ */
+
+
+/*
+ ------------------------------------------------------------------------------
+    Type definitions
+ ------------------------------------------------------------------------------
+ */
+
+
+/*
+ ------------------------------------------------------------------------------
+    Public function prototypes
+ ------------------------------------------------------------------------------
+ */
+
+
+#endif /* CONCURRENTHEAP */
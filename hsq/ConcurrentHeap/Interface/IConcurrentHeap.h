@@ -0,0 +1,167 @@
+/**
+ ******************************************************************************
+ * @file      IConcurrentHeap.h
+ *
+ * @brief     ConcurrentHeap interface
+ ******************************************************************************
+ */
+
+#ifndef ICONCURRENTHEAP_H
+#define ICONCURRENTHEAP_H
+
+/*
+ ------------------------------------------------------------------------------
+    Include files
+ ------------------------------------------------------------------------------
+ */
+
+#include "RoboticTypes.h"
+#include "IOs.h"
+#include "IBinaryHeap.h"
+
+
+/*
+ ------------------------------------------------------------------------------
+    Defines
+ ------------------------------------------------------------------------------
+ */
+
+// max number of shards, each a BinaryHeap behind its own mutex
+#define ICONCURRENTHEAP_MAX_SHARDS      8u
+
+// bytes of shard struct, one cache line so that producers on different
+// shards do not share lines; also alignment of shards and of the heap struct
+#define ICONCURRENTHEAP_SHARD_SIZE      64u
+
+// bytes of buffer for shardCount shards of capacity elements each
+#define ICONCURRENTHEAP_BUFFER_SIZE( shardCount, capacity, elementSize ) \
+    ( (shardCount) * (capacity) * (elementSize) )
+
+
+/*
+ ------------------------------------------------------------------------------
+    Type definitions
+ ------------------------------------------------------------------------------
+ */
+
+typedef union
+{
+    struct
+    {
+        tIBinaryHeap heap;
+        tIOs_MutexId mutex;
+    } shard;
+    uint8 padding[ ICONCURRENTHEAP_SHARD_SIZE ];
+
+} __attribute__(( aligned( ICONCURRENTHEAP_SHARD_SIZE ) )) tIConcurrentHeapShard;
+
+// shards first, each on its own cache line; compiler aligns static and
+// automatic heaps, allocated ones need aligned allocation
+typedef struct
+{
+    tIConcurrentHeapShard shards[ ICONCURRENTHEAP_MAX_SHARDS ];
+    uint8 shardCount;
+    uint8 elementSize;
+    tIBinaryHeap_ComparisonFun compare;
+
+} tIConcurrentHeap;
+
+
+/*
+ ------------------------------------------------------------------------------
+    Interface functions
+ ------------------------------------------------------------------------------
+ */
+
+/**
+ ******************************************************************************
+ * @brief   Initialize the module, create mutex of every shard. Must not run
+ *          concurrently with other functions.
+ *          NOTE: SOFTWARE EXCEPTION if input params are not valid, pHeap is
+ *          not aligned or mutex can not be created
+ * @param   pHeap
+ *          pointer to heap struct, aligned to ICONCURRENTHEAP_SHARD_SIZE
+ *          bytes (as the compiler places tIConcurrentHeap; use aligned
+ *          allocation for heaps not declared as variables)
+ * @param   pBuffer
+ *          user allocated buffer for heap data, of
+ *          ICONCURRENTHEAP_BUFFER_SIZE( shardCount, capacity, elementSize )
+ *          bytes
+ * @param   capacity
+ *          max number of elements of one shard
+ * @param   shardCount
+ *          number of shards, 1 .. ICONCURRENTHEAP_MAX_SHARDS, typically the
+ *          number of producer threads
+ * @param   elementSize
+ *          size of element to store in the heap
+ * @param   compare
+ *          pointer to function for comparing two elements in the heap, as
+ *          for IBinaryHeap; called with a shard mutex held
+ ******************************************************************************
+ */
+void IConcurrentHeap_Init( tIConcurrentHeap *pHeap,
+                           void *pBuffer,
+                           uint16 capacity,
+                           uint8 shardCount,
+                           uint8 elementSize,
+                           tIBinaryHeap_ComparisonFun compare );
+
+/**
+ ******************************************************************************
+ * @brief   Insert an element in the heap. Goes to the home shard of producer
+ *          when free, else to any free shard, else waits for the home shard;
+ *          full shards are skipped.
+ *          NOTE: SOFTWARE EXCEPTION if input params == NULL
+ * @param   pHeap
+ *          pointer to heap struct
+ * @param   producer
+ *          id of calling thread, e.g. 0 .. shardCount - 1, selects home shard
+ * @param   pElem
+ *          pointer to element to insert
+ * @returns true if successful, false if all shards are full
+ ******************************************************************************
+ */
+bool IConcurrentHeap_Insert( tIConcurrentHeap *pHeap, uint8 producer, const void *pElem );
+
+/**
+ ******************************************************************************
+ * @brief   Copy the top element of the heap, without removing it.
+ *          NOTE: SOFTWARE EXCEPTION if input params == NULL
+ * @param   pHeap
+ *          pointer to heap struct
+ * @param   pOut
+ *          pointer to copy of element
+ * @returns true if successful, false if heap is empty
+ ******************************************************************************
+ */
+bool IConcurrentHeap_Top( tIConcurrentHeap *pHeap, void *pOut );
+
+/**
+ ******************************************************************************
+ * @brief   Remove the top element of the heap and copy it to pOut.
+ *          The element is the top of all elements inserted before the call
+ *          and not removed by other consumers meanwhile; an element inserted
+ *          during the call may be returned by the next one.
+ *          NOTE: SOFTWARE EXCEPTION if input params == NULL
+ * @param   pHeap
+ *          pointer to heap struct
+ * @param   pOut
+ *          pointer to copy of element
+ * @returns true if successful, false if heap is empty
+ ******************************************************************************
+ */
+bool IConcurrentHeap_Pop( tIConcurrentHeap *pHeap, void *pOut );
+
+/**
+ ******************************************************************************
+ * @brief   Check if heap is empty.
+ *          NOTE: SOFTWARE EXCEPTION if pHeap == NULL
+ * @param   pHeap
+ *          pointer to heap struct
+ * @returns true if all shards were empty, false otherwise
+ ******************************************************************************
+ */
+bool IConcurrentHeap_IsEmpty( tIConcurrentHeap *pHeap );
+
+
+#endif /* ICONCURRENTHEAP_H */
@@ -0,0 +1,262 @@
+/**
+ ******************************************************************************
+ * @file      ConcurrentHeap_test.cpp
+ *
+ * @brief     Host unit tests of ConcurrentHeap: order, spill of full shards
+ *            and producer and consumer threads
+ ******************************************************************************
+ */
+
+/*
+ ------------------------------------------------------------------------------
+ Include files
+ ------------------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include "IConcurrentHeap.h"
+}
+
+
+/*
+ ------------------------------------------------------------------------------
+ Private types and functions
+ ------------------------------------------------------------------------------
+ */
+
+namespace {
+
+/* Deadline entry: due time, producer and its sequence number. */
+struct Deadline
+{
+    uint64_t due;
+    uint32_t producer;
+    uint32_t sequence;
+};
+
+bool Earlier( const void *a, const void *b )
+{
+    return static_cast<const Deadline *>(a)->due < static_cast<const Deadline *>(b)->due;
+}
+
+/* Buffer of shardCount shards of capacity deadlines. */
+std::vector<uint8_t> Buffer( uint8 shardCount, uint16 capacity )
+{
+    return std::vector<uint8_t>(ICONCURRENTHEAP_BUFFER_SIZE(shardCount, capacity, sizeof(Deadline)));
+}
+
+} // namespace
+
+
+/*
+ ------------------------------------------------------------------------------
+ Tests
+ ------------------------------------------------------------------------------
+ */
+
+TEST(ConcurrentHeap_Test, T01_SingleConsumerDrainsSorted)
+{
+    for ( uint8 shards = 1; shards <= ICONCURRENTHEAP_MAX_SHARDS; ++shards )
+    {
+        SCOPED_TRACE(int(shards));
+        std::vector<uint8_t> buffer = Buffer(shards, 1000);
+        tIConcurrentHeap heap;
+        IConcurrentHeap_Init(&heap, buffer.data(), 1000, shards, sizeof(Deadline), Earlier);
+
+        Deadline deadline;
+        EXPECT_TRUE(IConcurrentHeap_IsEmpty(&heap));
+        EXPECT_FALSE(IConcurrentHeap_Top(&heap, &deadline));
+        EXPECT_FALSE(IConcurrentHeap_Pop(&heap, &deadline));
+
+        std::mt19937_64 random(shards);
+        std::vector<uint64_t> reference;
+        for ( uint32_t sequence = 0; sequence < 1000u * shards; ++sequence )
+        {
+            const Deadline inserted{random() % 5000, 0, sequence};
+            ASSERT_TRUE(IConcurrentHeap_Insert(&heap, random() % 3, &inserted));
+            reference.push_back(inserted.due);
+        }
+        std::sort(reference.begin(), reference.end());
+
+        for ( uint64_t due : reference )
+        {
+            Deadline top;
+            ASSERT_TRUE(IConcurrentHeap_Top(&heap, &top));
+            ASSERT_TRUE(IConcurrentHeap_Pop(&heap, &deadline));
+            ASSERT_EQ(due, top.due);
+            ASSERT_EQ(due, deadline.due);
+        }
+        EXPECT_TRUE(IConcurrentHeap_IsEmpty(&heap));
+    }
+}
+
+/* Full home shard spills to the others, Insert fails only when all are full. */
+TEST(ConcurrentHeap_Test, T02_FullShardSpillsThenAllFullFails)
+{
+    std::vector<uint8_t> buffer = Buffer(3, 2);
+    tIConcurrentHeap heap;
+    IConcurrentHeap_Init(&heap, buffer.data(), 2, 3, sizeof(Deadline), Earlier);
+
+    for ( uint32_t sequence = 0; sequence < 6; ++sequence )
+    {
+        const Deadline inserted{100 - sequence, 0, sequence};
+        ASSERT_TRUE(IConcurrentHeap_Insert(&heap, 0, &inserted));
+    }
+    for ( uint8 idx = 0; idx < 3; ++idx )
+    {
+        EXPECT_EQ(2u, heap.shards[idx].shard.heap.size) << "  shard is: " << int(idx);
+    }
+
+    const Deadline extra{1, 1, 0};
+    EXPECT_FALSE(IConcurrentHeap_Insert(&heap, 1, &extra));
+
+    Deadline deadline;
+    ASSERT_TRUE(IConcurrentHeap_Pop(&heap, &deadline));
+    EXPECT_EQ(95u, deadline.due);
+    // the freed slot takes a new element again
+    EXPECT_TRUE(IConcurrentHeap_Insert(&heap, 2, &extra));
+}
+
+/* Every element pushed by producers is popped exactly once by consumers. */
+TEST(ConcurrentHeap_Test, T03_ProducersAndConsumersLoseNothing)
+{
+    const uint32_t producers = 4;
+    const uint32_t consumers = 3;
+    const uint32_t perProducer = 20000;
+    std::vector<uint8_t> buffer = Buffer(producers, perProducer);
+    tIConcurrentHeap heap;
+    IConcurrentHeap_Init(&heap, buffer.data(), perProducer, producers, sizeof(Deadline), Earlier);
+
+    std::atomic<uint32_t> running(producers);
+    std::atomic<bool> insertFailed(false);
+    std::vector<std::vector<Deadline>> popped(consumers);
+    std::vector<std::thread> threads;
+    for ( uint32_t producer = 0; producer < producers; ++producer )
+    {
+        threads.emplace_back([&, producer]() {
+            std::mt19937_64 random(producer);
+            for ( uint32_t sequence = 0; sequence < perProducer; ++sequence )
+            {
+                const Deadline inserted{random() % 100000, producer, sequence};
+                if ( !IConcurrentHeap_Insert(&heap, producer, &inserted) )
+                {
+                    insertFailed = true;
+                }
+            }
+            --running;
+        });
+    }
+    for ( uint32_t consumer = 0; consumer < consumers; ++consumer )
+    {
+        threads.emplace_back([&, consumer]() {
+            Deadline deadline;
+            for ( ;; )
+            {
+                // producers finished before the check, empty heap stays empty
+                const bool producing = running > 0;
+                if ( IConcurrentHeap_Pop(&heap, &deadline) )
+                {
+                    popped[consumer].push_back(deadline);
+                }
+                else if ( !producing )
+                {
+                    break;
+                }
+            }
+        });
+    }
+    for ( std::thread &thread : threads )
+    {
+        thread.join();
+    }
+
+    EXPECT_FALSE(insertFailed);
+    std::vector<std::vector<uint32_t>> seen(producers, std::vector<uint32_t>(perProducer, 0));
+    for ( const std::vector<Deadline> &deadlines : popped )
+    {
+        for ( const Deadline &deadline : deadlines )
+        {
+            ASSERT_LT(deadline.producer, producers);
+            ASSERT_LT(deadline.sequence, perProducer);
+            ++seen[deadline.producer][deadline.sequence];
+        }
+    }
+    for ( uint32_t producer = 0; producer < producers; ++producer )
+    {
+        for ( uint32_t sequence = 0; sequence < perProducer; ++sequence )
+        {
+            ASSERT_EQ(1u, seen[producer][sequence])
+                << "  producer is: " << producer << "  sequence is: " << sequence;
+        }
+    }
+    EXPECT_TRUE(IConcurrentHeap_IsEmpty(&heap));
+}
+
+/* Without producers every consumer gets a sorted sequence, also when
+   another consumer takes the top its tournament chose. */
+TEST(ConcurrentHeap_Test, T04_ConsumersPopInOrder)
+{
+    const uint8 shards = 4;
+    const uint16 capacity = 20000;
+    const uint32_t consumers = 3;
+    std::vector<uint8_t> buffer = Buffer(shards, capacity);
+
+    for ( unsigned round = 0; round < 20; ++round )
+    {
+        tIConcurrentHeap heap;
+        IConcurrentHeap_Init(&heap, buffer.data(), capacity, shards, sizeof(Deadline), Earlier);
+        std::mt19937_64 random(round);
+        for ( uint32_t sequence = 0; sequence < capacity; ++sequence )
+        {
+            const Deadline inserted{random() % 3000, 0, sequence};
+            ASSERT_TRUE(IConcurrentHeap_Insert(&heap, sequence % shards, &inserted));
+        }
+
+        std::atomic<uint32_t> total(0);
+        std::atomic<uint32_t> inversions(0);
+        std::vector<std::thread> threads;
+        for ( uint32_t consumer = 0; consumer < consumers; ++consumer )
+        {
+            threads.emplace_back([&]() {
+                Deadline deadline;
+                uint64_t last = 0;
+                uint32_t count = 0;
+                while ( IConcurrentHeap_Pop(&heap, &deadline) )
+                {
+                    if ( deadline.due < last )
+                    {
+                        ++inversions;
+                    }
+                    last = deadline.due;
+                    ++count;
+                }
+                total += count;
+            });
+        }
+        for ( std::thread &thread : threads )
+        {
+            thread.join();
+        }
+
+        ASSERT_EQ(capacity, total) << "  round is: " << round;
+        ASSERT_EQ(0u, inversions) << "  round is: " << round;
+    }
+}
+
+TEST(ConcurrentHeapDeathTest, T05_InitRejectsUnalignedHeap)
+{
+    alignas(ICONCURRENTHEAP_SHARD_SIZE) static uint8_t storage[sizeof(tIConcurrentHeap) + ICONCURRENTHEAP_SHARD_SIZE];
+    tIConcurrentHeap *pHeap = reinterpret_cast<tIConcurrentHeap *>(storage + 8);
+    std::vector<uint8_t> buffer = Buffer(1, 1);
+
+    EXPECT_DEATH(IConcurrentHeap_Init(pHeap, buffer.data(), 1, 1, sizeof(Deadline), Earlier), "");
+}
@@ -0,0 +1,75 @@
+/**
+ ******************************************************************************
+ * @file      IOs.c
+ *
+ * @brief     Host stub of IOs mutex functions, on pthread mutexes
+ ******************************************************************************
+ */
+
+/*
+ ------------------------------------------------------------------------------
+ Include files
+ ------------------------------------------------------------------------------
+ */
+
+#include "IOs.h"
+
+#include <pthread.h>
+
+
+/*
+ ------------------------------------------------------------------------------
+ Private variables
+ ------------------------------------------------------------------------------
+ */
+
+static pthread_mutex_t mutexes[ IOS_STUB_MAX_MUTEXES ];
+static uint32 mutexCount;
+
+
+/*
+ ------------------------------------------------------------------------------
+ Interface functions
+ ------------------------------------------------------------------------------
+ */
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+bool IOs_MutexCreate( tIOs_MutexId *pId )
+{
+    uint32 id = __atomic_fetch_add( &mutexCount, 1, __ATOMIC_RELAXED );
+
+    if ( id >= IOS_STUB_MAX_MUTEXES )
+    {
+        return false;
+    }
+    *pId = id;
+    return pthread_mutex_init( &mutexes[id], NULL ) == 0;
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+bool IOs_MutexLock( tIOs_MutexId id, uint32 timeout )
+{
+    if ( timeout == 0 )
+    {
+        return pthread_mutex_trylock( &mutexes[id] ) == 0;
+    }
+    return pthread_mutex_lock( &mutexes[id] ) == 0;
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+bool IOs_MutexUnlock( tIOs_MutexId id )
+{
+    return pthread_mutex_unlock( &mutexes[id] ) == 0;
+}
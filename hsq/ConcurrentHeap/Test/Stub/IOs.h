@@ -0,0 +1,68 @@
+/**
+ ******************************************************************************
+ * @file      IOs.h
+ *
+ * @brief     Host stub of IOs mutex interface used by ConcurrentHeap, on
+ *            pthread mutexes; for host tests only
+ ******************************************************************************
+ */
+
+#ifndef IOS_H
+#define IOS_H
+
+/*
+ ------------------------------------------------------------------------------
+    Include files
+ ------------------------------------------------------------------------------
+ */
+
+#include "RoboticTypes.h"
+
+
+/*
+ ------------------------------------------------------------------------------
+    Defines
+ ------------------------------------------------------------------------------
+ */
+
+// wait for mutex without timeout
+#define IOS_TIMEOUT_FOREVER         0xFFFFFFFFu
+
+// max number of mutexes created by all tests, never deleted
+#define IOS_STUB_MAX_MUTEXES        1024u
+
+
+/*
+ ------------------------------------------------------------------------------
+    Type definitions
+ ------------------------------------------------------------------------------
+ */
+
+typedef uint32 tIOs_MutexId;
+
+
+/*
+ ------------------------------------------------------------------------------
+    Interface functions
+ ------------------------------------------------------------------------------
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Create mutex, false when IOS_STUB_MAX_MUTEXES exist. */
+bool IOs_MutexCreate( tIOs_MutexId *pId );
+
+/* Lock mutex; timeout 0 only tries, any other waits forever. */
+bool IOs_MutexLock( tIOs_MutexId id, uint32 timeout );
+
+/* Unlock mutex. */
+bool IOs_MutexUnlock( tIOs_MutexId id );
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* IOS_H */
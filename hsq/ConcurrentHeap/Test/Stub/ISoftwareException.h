@@ -0,0 +1,19 @@
+/**
+ ******************************************************************************
+ * @file      ISoftwareException.h
+ *
+ * @brief     Host stub of software exception, aborts so that tests can
+ *            expect it; for host tests only
+ ******************************************************************************
+ */
+
+#ifndef ISOFTWAREEXCEPTION_H
+#define ISOFTWAREEXCEPTION_H
+
+#include <stdlib.h>
+
+#define SOFTWARE_EXCEPTION()                abort()
+
+#define SOFTWARE_EXCEPTION_ASSERT( cond )   do { if ( !( cond ) ) { abort(); } } while ( 0 )
+
+#endif /* ISOFTWAREEXCEPTION_H */
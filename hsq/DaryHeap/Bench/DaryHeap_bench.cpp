@@ -0,0 +1,208 @@
+/**
+ ******************************************************************************
+ * @file      DaryHeap_bench.cpp
+ *
+ * @brief     Insert and Pop timings of DaryHeap by arity, against BinaryHeap
+ ******************************************************************************
+ */
+
+/*
+ ------------------------------------------------------------------------------
+ Include files
+ ------------------------------------------------------------------------------
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+extern "C" {
+#include "IBinaryHeap.h"
+#include "IDaryHeap.h"
+}
+
+#include "microbench.hpp"
+
+
+/*
+ ------------------------------------------------------------------------------
+ Private types and functions
+ ------------------------------------------------------------------------------
+ */
+
+namespace {
+
+const std::size_t CacheLine = 64;
+
+/* Timer entry: due time as key and payload. */
+template<std::size_t Size>
+struct Entry
+{
+    uint64_t due;
+    uint8_t payload[Size - sizeof(uint64_t)];
+};
+
+template<>
+struct Entry<sizeof(uint64_t)>
+{
+    uint64_t due;
+};
+
+template<std::size_t Size>
+bool Earlier( const void *a, const void *b )
+{
+    return static_cast<const Entry<Size> *>(a)->due < static_cast<const Entry<Size> *>(b)->due;
+}
+
+/* Random due times, the same for every run. */
+template<std::size_t Size>
+std::vector<Entry<Size>> Entries( std::size_t count )
+{
+    std::mt19937_64 random(count);
+    std::vector<Entry<Size>> entries(count);
+    for ( Entry<Size> &entry : entries )
+    {
+        entry.due = random();
+    }
+    return entries;
+}
+
+/* Cache line aligned heap buffer. */
+struct FreeBuffer
+{
+    void operator()( void *pBuffer ) const { std::free(pBuffer); }
+};
+typedef std::unique_ptr<void, FreeBuffer> tBuffer;
+
+tBuffer AlignedBuffer( std::size_t size )
+{
+    void *pBuffer = nullptr;
+    if ( posix_memalign(&pBuffer, CacheLine, size) != 0 )
+    {
+        throw std::bad_alloc();
+    }
+    return tBuffer(pBuffer);
+}
+
+/* Heap operations of both modules behind one interface. */
+template<std::size_t Size>
+struct DaryHeap
+{
+    tIDaryHeap heap;
+    tBuffer buffer;
+
+    DaryHeap( uint8 arity, uint32 capacity )
+     : buffer(AlignedBuffer(IDARYHEAP_BUFFER_ELEMENTS(capacity, arity) * Size))
+    {
+        IDaryHeap_InitArity(&heap, buffer.get(), capacity, Size, arity, Earlier<Size>);
+    }
+
+    void Clear() { heap.size = 0; }
+    bool IsEmpty() { return IDaryHeap_IsEmpty(&heap); }
+    void * Top() { return IDaryHeap_Top(&heap); }
+    void Pop() { IDaryHeap_Pop(&heap); }
+    void Insert( const void *pElem ) { IDaryHeap_Insert(&heap, pElem); }
+};
+
+template<std::size_t Size>
+struct BinaryHeap
+{
+    tIBinaryHeap heap;
+    tBuffer buffer;
+
+    BinaryHeap( uint8 /* arity */, uint32 capacity )
+     : buffer(AlignedBuffer(capacity * Size))
+    {
+        IBinaryHeap_Init(&heap, buffer.get(), capacity, Size, Earlier<Size>);
+    }
+
+    void Clear() { heap.size = 0; }
+    bool IsEmpty() { return IBinaryHeap_IsEmpty(&heap); }
+    void * Top() { return IBinaryHeap_Top(&heap); }
+    void Pop() { IBinaryHeap_Pop(&heap); }
+    void Insert( const void *pElem ) { IBinaryHeap_Insert(&heap, pElem); }
+};
+
+/* Fills empty heap of range(1) elements per iteration, arity range(0). */
+template<typename Heap, std::size_t Size>
+void BM_Insert( microbench::State &state )
+{
+    const std::vector<Entry<Size>> entries = Entries<Size>(state.range(1));
+    Heap heap(state.range(0), entries.size());
+
+    for ( auto _ : state )
+    {
+        heap.Clear();
+        for ( const Entry<Size> &entry : entries )
+        {
+            heap.Insert(&entry);
+        }
+        microbench::clobberMemory();
+    }
+    state.setItemsProcessed(state.iterations() * entries.size());
+}
+
+/* Empties full heap of range(1) elements per iteration, arity range(0). */
+template<typename Heap, std::size_t Size>
+void BM_Pop( microbench::State &state )
+{
+    const std::vector<Entry<Size>> entries = Entries<Size>(state.range(1));
+    Heap heap(state.range(0), entries.size());
+
+    for ( auto _ : state )
+    {
+        state.pauseTiming();
+        for ( const Entry<Size> &entry : entries )
+        {
+            heap.Insert(&entry);
+        }
+        state.resumeTiming();
+
+        while ( !heap.IsEmpty() )
+        {
+            microbench::doNotOptimize(*static_cast<Entry<Size> *>(heap.Top()));
+            heap.Pop();
+        }
+    }
+    state.setItemsProcessed(state.iterations() * entries.size());
+}
+
+/* Arities 2, 4 and 8 at 1k, 64k and 1M elements. */
+void DaryArgs( microbench::Benchmark *pBenchmark )
+{
+    for ( int64_t arity : {2, 4, 8} )
+    {
+        for ( int64_t count : {1 << 10, 1 << 16, 1 << 20} )
+        {
+            pBenchmark->args({arity, count});
+        }
+    }
+}
+
+/* BinaryHeap capacity is 16-bit. */
+void BinaryArgs( microbench::Benchmark *pBenchmark )
+{
+    pBenchmark->args({2, 1 << 10})->args({2, UINT16_MAX});
+}
+
+} // namespace
+
+
+/*
+ ------------------------------------------------------------------------------
+ Benchmarks
+ ------------------------------------------------------------------------------
+ */
+
+#define HEAP_BENCHMARKS( HEAP, SIZE, ARGS ) \
+    static int HEAP##SIZE##_registered __attribute__((unused)) = ( \
+        ARGS( microbench::registerBenchmark(#HEAP "_Insert<" #SIZE ">", BM_Insert<HEAP<SIZE>, SIZE>) ), \
+        ARGS( microbench::registerBenchmark(#HEAP "_Pop<" #SIZE ">", BM_Pop<HEAP<SIZE>, SIZE>) ), \
+        0 )
+
+HEAP_BENCHMARKS( BinaryHeap, 8, BinaryArgs );
+HEAP_BENCHMARKS( BinaryHeap, 16, BinaryArgs );
+HEAP_BENCHMARKS( DaryHeap, 8, DaryArgs );
+HEAP_BENCHMARKS( DaryHeap, 16, DaryArgs );
@@ -0,0 +1,319 @@
+/**
+ ******************************************************************************
+ * @file      DaryHeap.c
+ *
+ * @brief     Implementation file for DaryHeap
+ ******************************************************************************
+ */
+
+/*
+ ------------------------------------------------------------------------------
+ Include files
+ ------------------------------------------------------------------------------
+ */
+
+#include "DaryHeap.h"
+#include "IDaryHeap.h"
+
+#include "ISoftwareException.h"
+
+
+/*
+ ------------------------------------------------------------------------------
+ Private function prototypes
+ ------------------------------------------------------------------------------
+ */
+
+/* Index of first child, the others follow it. */
+static inline uint32 FirstChild( tIDaryHeap *pHeap, uint32 idx );
+
+/* Index of parent. */
+static inline uint32 Parent( tIDaryHeap *pHeap, uint32 idx );
+
+/* First element of the heap, behind padding. */
+static inline uint8 * Base( tIDaryHeap *pHeap );
+
+/* Return first position of element in the heap. */
+static inline void * At( tIDaryHeap *pHeap, uint32 idx );
+
+/* Move hole at idx up until pElem fits, store pElem there. */
+static void SiftUp4( tIDaryHeap *pHeap, uint32 idx, const void *pElem );
+static void SiftUp8( tIDaryHeap *pHeap, uint32 idx, const void *pElem );
+static void SiftUp16( tIDaryHeap *pHeap, uint32 idx, const void *pElem );
+static void SiftUpAny( tIDaryHeap *pHeap, uint32 idx, const void *pElem );
+
+/* Move hole at the top down until pElem fits, store pElem there.
+   pElem must not be inside the first pHeap->size elements. */
+static void SiftDown4( tIDaryHeap *pHeap, const void *pElem );
+static void SiftDown8( tIDaryHeap *pHeap, const void *pElem );
+static void SiftDown16( tIDaryHeap *pHeap, const void *pElem );
+static void SiftDownAny( tIDaryHeap *pHeap, const void *pElem );
+
+
+/*
+ ------------------------------------------------------------------------------
+ Interface functions
+ ------------------------------------------------------------------------------
+ */
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+void IDaryHeap_Init( tIDaryHeap *pHeap,
+                     void *pBuffer,
+                     uint32 capacity,
+                     uint8 elementSize,
+                     tIDaryHeap_ComparisonFun compare )
+{
+    IDaryHeap_InitArity( pHeap, pBuffer, capacity, elementSize, IDARYHEAP_DEFAULT_ARITY, compare );
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+void IDaryHeap_InitArity( tIDaryHeap *pHeap,
+                          void *pBuffer,
+                          uint32 capacity,
+                          uint8 elementSize,
+                          uint8 arity,
+                          tIDaryHeap_ComparisonFun compare )
+{
+    if ( pHeap == NULL || pBuffer == NULL || capacity == 0 || elementSize == 0 || arity < 2 ||
+         compare == NULL || capacity > ( 0xFFFFFFFFu - arity ) / arity )
+    {
+        SOFTWARE_EXCEPTION();
+    }
+
+    pHeap->size = 0;
+    pHeap->capacity = capacity;
+    pHeap->elementSize = elementSize;
+    pHeap->arity = arity;
+    pHeap->data = pBuffer;
+    pHeap->compare = compare;
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+bool IDaryHeap_IsEmpty( tIDaryHeap *pHeap )
+{
+    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL );
+
+    return pHeap->size == 0;
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+void * IDaryHeap_Top( tIDaryHeap *pHeap )
+{
+    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL );
+
+    return Base( pHeap );
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+void IDaryHeap_Pop( tIDaryHeap *pHeap )
+{
+    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL );
+
+    --pHeap->size;
+
+    // last element, now just behind the heap, fills the hole left by the top
+    const void *pLast = At( pHeap, pHeap->size );
+
+    switch ( pHeap->elementSize )
+    {
+        case 4:
+            SiftDown4( pHeap, pLast );
+            break;
+        case 8:
+            SiftDown8( pHeap, pLast );
+            break;
+        case 16:
+            SiftDown16( pHeap, pLast );
+            break;
+        default:
+            SiftDownAny( pHeap, pLast );
+            break;
+    }
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+bool IDaryHeap_Insert( tIDaryHeap *pHeap, const void *pElem )
+{
+    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL && pHeap->data != NULL && pElem != NULL );
+
+    if ( pHeap->size >= pHeap->capacity )
+    {
+        return false;
+    }
+
+    uint32 idx = pHeap->size++;
+
+    switch ( pHeap->elementSize )
+    {
+        case 4:
+            SiftUp4( pHeap, idx, pElem );
+            break;
+        case 8:
+            SiftUp8( pHeap, idx, pElem );
+            break;
+        case 16:
+            SiftUp16( pHeap, idx, pElem );
+            break;
+        default:
+            SiftUpAny( pHeap, idx, pElem );
+            break;
+    }
+
+    return true;
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+void IDaryHeap_Apply( tIDaryHeap *pHeap, tIDaryHeap_ApplyFun function )
+{
+    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL && pHeap->data != NULL && function != NULL );
+
+    for ( uint32 idx = 0; idx < pHeap->size; ++idx )
+    {
+        function( At(pHeap, idx) );
+    }
+}
+
+/*
+ ------------------------------------------------------------------------------
+ Public functions
+ ------------------------------------------------------------------------------
+ */
+
+
+/*
+ ------------------------------------------------------------------------------
+ Private functions
+ ------------------------------------------------------------------------------
+ */
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+static inline uint32 FirstChild( tIDaryHeap *pHeap, uint32 idx )
+{
+    return ( pHeap->arity * idx ) + 1;
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+static inline uint32 Parent( tIDaryHeap *pHeap, uint32 idx )
+{
+    return ( idx - 1 ) / pHeap->arity;
+}
+
+/*
+ ******************************************************************************
+ * Function
+ * Children of idx are at arity * ( idx + 1 ) counting from buffer start, so
+ * every group of siblings starts at multiple of arity elements.
+ ******************************************************************************
+ */
+static inline uint8 * Base( tIDaryHeap *pHeap )
+{
+    return (uint8 *) pHeap->data + ( pHeap->arity - 1 ) * pHeap->elementSize;
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+static inline void * At( tIDaryHeap *pHeap, uint32 idx )
+{
+    return (void *) ( Base( pHeap ) + (size_t) idx * pHeap->elementSize );
+}
+
+/*
+ ******************************************************************************
+ * Sift functions
+ *
+ * As in BinaryHeap the hole travels along the path, one element move per
+ * level, and constant SIZE turns moves into word moves. Sift down reads
+ * all children of a node from one group of siblings. Byte offsets are
+ * size_t, capacity * elementSize may exceed 32 bits.
+ ******************************************************************************
+ */
+#define DARYHEAP_SIFT_FUNCTIONS( SUFFIX, SIZE ) \
+static void SiftUp##SUFFIX( tIDaryHeap *pHeap, uint32 idx, const void *pElem ) \
+{ \
+    uint8 *base = Base( pHeap ); \
+    while ( idx != 0 ) \
+    { \
+        uint32 parent = Parent( pHeap, idx ); \
+        if ( !pHeap->compare( pElem, base + (size_t) parent * (SIZE) ) ) \
+        { \
+            break; \
+        } \
+        memcpy( base + (size_t) idx * (SIZE), base + (size_t) parent * (SIZE), (SIZE) ); \
+        idx = parent; \
+    } \
+    memcpy( base + (size_t) idx * (SIZE), pElem, (SIZE) ); \
+} \
+\
+static void SiftDown##SUFFIX( tIDaryHeap *pHeap, const void *pElem ) \
+{ \
+    uint8 *base = Base( pHeap ); \
+    uint32 size = pHeap->size; \
+    uint32 idx = 0; \
+    uint32 first; \
+    while ( ( first = FirstChild( pHeap, idx ) ) < size ) \
+    { \
+        uint32 last = ( size - first > pHeap->arity ) ? first + pHeap->arity : size; \
+        uint32 best = first; \
+        for ( uint32 child = first + 1; child < last; ++child ) \
+        { \
+            if ( pHeap->compare( base + (size_t) child * (SIZE), base + (size_t) best * (SIZE) ) ) \
+            { \
+                best = child; \
+            } \
+        } \
+        if ( !pHeap->compare( base + (size_t) best * (SIZE), pElem ) ) \
+        { \
+            break; \
+        } \
+        memcpy( base + (size_t) idx * (SIZE), base + (size_t) best * (SIZE), (SIZE) ); \
+        idx = best; \
+    } \
+    if ( idx != size ) \
+    { \
+        memcpy( base + (size_t) idx * (SIZE), pElem, (SIZE) ); \
+    } \
+}
+
+DARYHEAP_SIFT_FUNCTIONS( 4, 4u )
+DARYHEAP_SIFT_FUNCTIONS( 8, 8u )
+DARYHEAP_SIFT_FUNCTIONS( 16, 16u )
+DARYHEAP_SIFT_FUNCTIONS( Any, pHeap->elementSize )
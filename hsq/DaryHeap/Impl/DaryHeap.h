@@ -0,0 +1,43 @@
+/**
+ ******************************************************************************
+ * @file      DaryHeap.h
+ * 
+ * @brief     Header file for DaryHeap implementation
+ ******************************************************************************
+ */
+
+#ifndef DARYHEAP_H
+#define DARYHEAP_H
+
+
+/*
+ ------------------------------------------------------------------------------
+    Include files
+ ------------------------------------------------------------------------------
+ */
+
+#include "IDaryHeap.h"
+
+
+/*
+ ------------------------------------------------------------------------------
+    Defines
+ ------------------------------------------------------------------------------
+ */
+
+
+/*
+ ------------------------------------------------------------------------------
+    Type definitions
+ ------------------------------------------------------------------------------
+ */
+
+
+/*
+ ------------------------------------------------------------------------------
+    Public function prototypes
+ ------------------------------------------------------------------------------
+ */
+
+
+#endif /* DARYHEAP */
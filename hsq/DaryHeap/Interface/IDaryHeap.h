@@ -0,0 +1,180 @@
+/**
+ ******************************************************************************
+ * @file      IDaryHeap.h
+ *
+ * @brief     DaryHeap interface
+ ******************************************************************************
+ */
+
+#ifndef IDARYHEAP_H
+#define IDARYHEAP_H
+
+/*
+ ------------------------------------------------------------------------------
+    Include files
+ ------------------------------------------------------------------------------
+ */
+
+#include "RoboticTypes.h"
+
+
+/*
+ ------------------------------------------------------------------------------
+    Defines
+ ------------------------------------------------------------------------------
+ */
+
+// number of children of every node, used by IDaryHeap_Init
+#define IDARYHEAP_DEFAULT_ARITY     4
+
+// number of elements of buffer for heap of capacity elements, the first
+// arity - 1 elements are padding which aligns groups of siblings
+#define IDARYHEAP_BUFFER_ELEMENTS( capacity, arity )   ( (capacity) + (arity) - 1 )
+
+
+/*
+ ------------------------------------------------------------------------------
+    Type definitions
+ ------------------------------------------------------------------------------
+ */
+
+// comparison function for two elements in the heap
+// for a min heap (aka min priority queue), return true if a < b
+// for a max heap (aka max priority queue), return true if a > b
+typedef bool (*tIDaryHeap_ComparisonFun)( const void *a, const void *b );
+
+// function to apply to each element in the queue
+typedef void (*tIDaryHeap_ApplyFun)( const void *elem );
+
+typedef struct
+{
+    uint32 size;
+    uint32 capacity;
+    uint8 elementSize;
+    uint8 arity;
+    void *data;
+    tIDaryHeap_ComparisonFun compare;
+
+} tIDaryHeap;
+
+
+/*
+ ------------------------------------------------------------------------------
+    Interface functions
+ ------------------------------------------------------------------------------
+ */
+
+/**
+ ******************************************************************************
+ * @brief   Initialize the module with IDARYHEAP_DEFAULT_ARITY children per node.
+ *          NOTE: SOFTWARE EXCEPTION if input params are not valid
+ * @param   pHeap
+ *          pointer to heap struct
+ * @param   pBuffer
+ *          user allocated buffer for heap data, of
+ *          IDARYHEAP_BUFFER_ELEMENTS( capacity, IDARYHEAP_DEFAULT_ARITY )
+ *          elements
+ * @param   capacity
+ *          max number of elements to store in the heap
+ * @param   elementSize
+ *          size of element to store in the heap
+ * @param   compare
+ *          pointer to function for comparing two elements in the heap
+ ******************************************************************************
+ */
+void IDaryHeap_Init( tIDaryHeap *pHeap,
+                     void *pBuffer,
+                     uint32 capacity,
+                     uint8 elementSize,
+                     tIDaryHeap_ComparisonFun compare );
+
+/**
+ ******************************************************************************
+ * @brief   Initialize the module with given number of children per node.
+ *          Children of a node are stored next to each other; when
+ *          arity * elementSize is the cache line size (4 x 16 bytes,
+ *          8 x 8 bytes for 64 byte lines) and pBuffer is aligned to it,
+ *          all children of a node share one cache line.
+ *          NOTE: SOFTWARE EXCEPTION if input params are not valid
+ * @param   pHeap
+ *          pointer to heap struct
+ * @param   pBuffer
+ *          user allocated buffer for heap data, of
+ *          IDARYHEAP_BUFFER_ELEMENTS( capacity, arity ) elements
+ * @param   capacity
+ *          max number of elements to store in the heap
+ * @param   elementSize
+ *          size of element to store in the heap
+ * @param   arity
+ *          number of children of every node, at least 2
+ * @param   compare
+ *          pointer to function for comparing two elements in the heap
+ ******************************************************************************
+ */
+void IDaryHeap_InitArity( tIDaryHeap *pHeap,
+                          void *pBuffer,
+                          uint32 capacity,
+                          uint8 elementSize,
+                          uint8 arity,
+                          tIDaryHeap_ComparisonFun compare );
+
+/**
+ ******************************************************************************
+ * @brief   Check if heap is empty.
+ *          NOTE: SOFTWARE EXCEPTION if pHeap == NULL
+ * @param   pHeap
+ *          pointer to heap struct
+ * @returns true if empty, false otherwise
+ ******************************************************************************
+ */
+bool IDaryHeap_IsEmpty( tIDaryHeap *pHeap );
+
+/**
+ ******************************************************************************
+ * @brief   Get a pointer to the top element in the heap.
+ *          NOTE: SOFTWARE EXCEPTION if pHeap == NULL
+ * @param   pHeap
+ *          pointer to heap struct
+ * @returns pointer to the top element in the heap
+ ******************************************************************************
+ */
+void * IDaryHeap_Top( tIDaryHeap *pHeap );
+
+/**
+ ******************************************************************************
+ * @brief   Remove the top element in the heap.
+ *          NOTE: SOFTWARE EXCEPTION if pHeap == NULL
+ * @param   pHeap
+ *          pointer to heap struct
+ ******************************************************************************
+ */
+void IDaryHeap_Pop( tIDaryHeap *pHeap );
+
+/**
+ ******************************************************************************
+ * @brief   Insert an element in the heap.
+ *          NOTE: SOFTWARE EXCEPTION if input params == NULL
+ * @param   pHeap
+ *          pointer to heap struct
+ * @param   pElem
+ *          pointer to element to insert
+ * @returns true if successful, false otherwise
+ ******************************************************************************
+ */
+bool IDaryHeap_Insert( tIDaryHeap *pHeap, const void *pElem );
+
+/**
+ ******************************************************************************
+ * @brief   Apply a function to each element in the heap. A typical case is to
+ *          print out an element.
+ *          NOTE: SOFTWARE EXCEPTION if input params == NULL
+ * @param   pHeap
+ *          pointer to heap struct
+ * @param   function
+ *          pointer to function to apply
+ ******************************************************************************
+ */
+void IDaryHeap_Apply( tIDaryHeap *pHeap, tIDaryHeap_ApplyFun function );
+
+
+#endif /* IDARYHEAP_H */
@@ -0,0 +1,153 @@
+/**
+ ******************************************************************************
+ * @file      DaryHeap_test.cpp
+ *
+ * @brief     Host unit tests of DaryHeap against a sorted reference
+ ******************************************************************************
+ */
+
+/*
+ ------------------------------------------------------------------------------
+ Include files
+ ------------------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+extern "C" {
+#include "IDaryHeap.h"
+}
+
+#include "HeapTestFixture.hpp"
+
+using namespace heaptest;
+
+
+/*
+ ------------------------------------------------------------------------------
+ Private types and functions
+ ------------------------------------------------------------------------------
+ */
+
+namespace {
+
+/* Fill byte around the heap buffer, must stay untouched. */
+const uint8_t GUARD = 0x5a;
+
+/* tIDaryHeap for CheckRandomOperations. */
+struct DaryHeap
+{
+    tIDaryHeap heap;
+
+    bool insert( const void *pElem ) { return IDaryHeap_Insert(&heap, pElem); }
+    const void * top() { return IDaryHeap_Top(&heap); }
+    void pop() { IDaryHeap_Pop(&heap); }
+    uint32 size() const { return heap.size; }
+};
+
+/* Random operations on heap of capacity Size byte elements and given
+   arity, whose buffer is surrounded by guard bytes. */
+template<std::size_t Size>
+void CheckArity( uint32 capacity, uint8 arity )
+{
+    // guard element on both sides, odd offset for unaligned moves
+    const std::size_t bytes = IDARYHEAP_BUFFER_ELEMENTS(capacity, arity) * Size;
+    std::vector<uint8_t> buffer(bytes + 2 * Size + 1, GUARD);
+    DaryHeap heap;
+    IDaryHeap_InitArity(&heap.heap, buffer.data() + Size + 1, capacity, Size, arity, Less<Size>);
+    CheckRandomOperations<Size>(heap, capacity, capacity * arity, 10000);
+
+    for ( std::size_t idx = 0; idx < Size; ++idx )
+    {
+        ASSERT_EQ(GUARD, buffer[idx + 1]);
+        ASSERT_EQ(GUARD, buffer[buffer.size() - 1 - idx]);
+    }
+}
+
+/* Sum of elements seen by IDaryHeap_Apply. */
+uint32_t appliedSum;
+
+void AddToSum( const void *elem )
+{
+    appliedSum += *static_cast<const uint32_t *>(elem);
+}
+
+} // namespace
+
+
+/*
+ ------------------------------------------------------------------------------
+ Tests
+ ------------------------------------------------------------------------------
+ */
+
+TEST(DaryHeap_Test, T01_EveryArityAndElementSize)
+{
+    for ( uint8 arity : {2, 3, 4, 8} )
+    {
+        for ( uint32 capacity : {1, 2, 7, 100, 2000} )
+        {
+            SCOPED_TRACE(testing::Message() << "arity " << int(arity) << " capacity " << capacity);
+            CheckArity<4>(capacity, arity);
+            CheckArity<8>(capacity, arity);
+            CheckArity<16>(capacity, arity);
+            CheckArity<5>(capacity, arity);
+            CheckArity<24>(capacity, arity);
+        }
+    }
+}
+
+TEST(DaryHeap_Test, T02_DefaultArityFullAndEmpty)
+{
+    uint32_t buffer[IDARYHEAP_BUFFER_ELEMENTS(3, IDARYHEAP_DEFAULT_ARITY)];
+    tIDaryHeap heap;
+    IDaryHeap_Init(&heap, buffer, 3, sizeof(uint32_t), Less32);
+
+    const uint32_t keys[] = {7, 2, 9, 1};
+    EXPECT_EQ(IDARYHEAP_DEFAULT_ARITY, heap.arity);
+    EXPECT_TRUE(IDaryHeap_IsEmpty(&heap));
+    EXPECT_TRUE(IDaryHeap_Insert(&heap, &keys[0]));
+    EXPECT_TRUE(IDaryHeap_Insert(&heap, &keys[1]));
+    EXPECT_TRUE(IDaryHeap_Insert(&heap, &keys[2]));
+    EXPECT_FALSE(IDaryHeap_Insert(&heap, &keys[3]));
+
+    appliedSum = 0;
+    IDaryHeap_Apply(&heap, AddToSum);
+    EXPECT_EQ(18u, appliedSum);
+
+    for ( uint32_t key : {2u, 7u, 9u} )
+    {
+        EXPECT_EQ(key, *static_cast<uint32_t *>(IDaryHeap_Top(&heap)));
+        IDaryHeap_Pop(&heap);
+    }
+    EXPECT_TRUE(IDaryHeap_IsEmpty(&heap));
+}
+
+TEST(DaryHeap_Test, T03_LargeHeapSorts)
+{
+    const uint32 capacity = 100000;
+    std::vector<uint32_t> buffer(IDARYHEAP_BUFFER_ELEMENTS(capacity, 8));
+    tIDaryHeap heap;
+    IDaryHeap_InitArity(&heap, buffer.data(), capacity, sizeof(uint32_t), 8, Less32);
+
+    std::mt19937 random(1);
+    std::vector<uint32_t> keys(capacity);
+    for ( uint32_t &key : keys )
+    {
+        key = random();
+        ASSERT_TRUE(IDaryHeap_Insert(&heap, &key));
+    }
+    std::sort(keys.begin(), keys.end());
+    for ( uint32_t key : keys )
+    {
+        ASSERT_EQ(key, *static_cast<uint32_t *>(IDaryHeap_Top(&heap)));
+        IDaryHeap_Pop(&heap);
+    }
+    EXPECT_TRUE(IDaryHeap_IsEmpty(&heap));
+}
@@ -0,0 +1,163 @@
+/**
+ ******************************************************************************
+ * @file      IndexedHeap_bench.cpp
+ *
+ * @brief     Rescheduling and cancelling timers by handle, against rebuilding
+ *            BinaryHeap
+ ******************************************************************************
+ */
+
+/*
+ ------------------------------------------------------------------------------
+ Include files
+ ------------------------------------------------------------------------------
+ */
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+extern "C" {
+#include "IBinaryHeap.h"
+#include "IIndexedHeap.h"
+}
+
+#include "microbench.hpp"
+
+
+/*
+ ------------------------------------------------------------------------------
+ Private types and functions
+ ------------------------------------------------------------------------------
+ */
+
+namespace {
+
+/* Timer entry: due time and id. */
+struct Timer
+{
+    uint64_t due;
+    uint32_t id;
+    uint32_t flags;
+};
+
+bool Earlier( const void *a, const void *b )
+{
+    return static_cast<const Timer *>(a)->due < static_cast<const Timer *>(b)->due;
+}
+
+/* Heap of range() timers with random due times. */
+class TimerHeap
+{
+public:
+    explicit TimerHeap( uint32 count )
+     : buffer(IINDEXEDHEAP_BUFFER_SIZE(count, sizeof(Timer)) / sizeof(uint64_t) + 1)
+     , random(count)
+    {
+        IIndexedHeap_Init(&heap, buffer.data(), count, sizeof(Timer), Earlier);
+        for ( uint32 id = 0; id < count; ++id )
+        {
+            const Timer timer = {random(), id, 0};
+            IIndexedHeap_Insert(&heap, id, &timer);
+        }
+    }
+
+    tIIndexedHeap heap;
+    std::vector<uint64_t> buffer;
+    std::mt19937_64 random;
+};
+
+/* New due time of random timer, earlier or later. */
+void BM_Reschedule( microbench::State &state )
+{
+    TimerHeap timers(state.range());
+    tIIndexedHeap *pHeap = &timers.heap;
+
+    for ( auto _ : state )
+    {
+        const uint32 id = timers.random() % pHeap->capacity;
+        Timer *pTimer = static_cast<Timer *>(IIndexedHeap_Get(pHeap, id));
+        const uint64_t due = timers.random();
+        if ( due < pTimer->due )
+        {
+            pTimer->due = due;
+            IIndexedHeap_DecreaseKey(pHeap, id, NULL);
+        }
+        else
+        {
+            pTimer->due = due;
+            IIndexedHeap_IncreaseKey(pHeap, id, NULL);
+        }
+    }
+    state.setItemsProcessed(state.iterations());
+}
+
+/* Cancel random timer and start it again. */
+void BM_CancelRestart( microbench::State &state )
+{
+    TimerHeap timers(state.range());
+    tIIndexedHeap *pHeap = &timers.heap;
+
+    for ( auto _ : state )
+    {
+        const uint32 id = timers.random() % pHeap->capacity;
+        IIndexedHeap_Remove(pHeap, id);
+        const Timer timer = {timers.random(), id, 0};
+        IIndexedHeap_Insert(pHeap, id, &timer);
+    }
+    state.setItemsProcessed(state.iterations());
+}
+
+/* Cancel of random timer without handles: rebuild heap without it. */
+void BM_RebuildCancel( microbench::State &state )
+{
+    const uint32 count = state.range();
+    std::mt19937_64 random(count);
+    std::vector<Timer> buffer(count), timers(count);
+    tIBinaryHeap32 heap;
+    IBinaryHeap32_Init(&heap, buffer.data(), count, sizeof(Timer), Earlier);
+    for ( uint32 id = 0; id < count; ++id )
+    {
+        const Timer timer = {random(), id, 0};
+        IBinaryHeap32_Insert(&heap, &timer);
+    }
+
+    for ( auto _ : state )
+    {
+        const uint32 id = random() % count;
+        uint32 kept = 0;
+        Timer cancelled = {0, id, 0};
+        while ( !IBinaryHeap32_IsEmpty(&heap) )
+        {
+            const Timer *pTop = static_cast<const Timer *>(IBinaryHeap32_Top(&heap));
+            if ( pTop->id != id )
+            {
+                timers[kept++] = *pTop;
+            }
+            else
+            {
+                cancelled = *pTop;
+            }
+            IBinaryHeap32_Pop(&heap);
+        }
+        for ( uint32 idx = 0; idx < kept; ++idx )
+        {
+            IBinaryHeap32_Insert(&heap, &timers[idx]);
+        }
+        IBinaryHeap32_Insert(&heap, &cancelled);
+    }
+    state.setItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+
+/*
+ ------------------------------------------------------------------------------
+ Benchmarks
+ ------------------------------------------------------------------------------
+ */
+
+MICROBENCH(BM_Reschedule)->arg(1 << 10)->arg(1 << 16)->arg(1 << 20);
+MICROBENCH(BM_CancelRestart)->arg(1 << 10)->arg(1 << 16)->arg(1 << 20);
+MICROBENCH(BM_RebuildCancel)->arg(1 << 10)->arg(1 << 16);
@@ -0,0 +1,367 @@
+/**
+ ******************************************************************************
+ * @file      IndexedHeap.c
+ *
+ * @brief     Implementation file for IndexedHeap
+ ******************************************************************************
+ */
+
+/*
+ ------------------------------------------------------------------------------
+ Include files
+ ------------------------------------------------------------------------------
+ */
+
+#include "IndexedHeap.h"
+#include "IIndexedHeap.h"
+
+#include "ISoftwareException.h"
+
+
+/*
+ ------------------------------------------------------------------------------
+ Private function prototypes
+ ------------------------------------------------------------------------------
+ */
+
+/* Index of parent. */
+static inline uint32 Parent( uint32 slot );
+
+/* Element of handle. */
+static inline const void * Element( tIIndexedHeap *pHeap, uint32 handle );
+
+/* Store handle at slot and update its position. */
+static inline void Place( tIIndexedHeap *pHeap, uint32 slot, uint32 handle );
+
+/* Move hole at slot up until element of handle fits, store handle there. */
+static void SiftUp( tIIndexedHeap *pHeap, uint32 slot, uint32 handle );
+
+/* Move hole at slot down until element of handle fits, store handle there. */
+static void SiftDown( tIIndexedHeap *pHeap, uint32 slot, uint32 handle );
+
+/* Fill slot, emptied by removal, with the last handle. */
+static void FillSlot( tIIndexedHeap *pHeap, uint32 slot );
+
+
+/*
+ ------------------------------------------------------------------------------
+ Interface functions
+ ------------------------------------------------------------------------------
+ */
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+void IIndexedHeap_Init( tIIndexedHeap *pHeap,
+                        void *pBuffer,
+                        uint32 capacity,
+                        uint8 elementSize,
+                        tIIndexedHeap_ComparisonFun compare )
+{
+    if ( pHeap == NULL || pBuffer == NULL || capacity == 0 || capacity > IINDEXEDHEAP_MAX_CAPACITY ||
+         elementSize == 0 || compare == NULL )
+    {
+        SOFTWARE_EXCEPTION();
+    }
+
+    pHeap->size = 0;
+    pHeap->capacity = capacity;
+    pHeap->elementSize = elementSize;
+    pHeap->heap = (uint32 *) pBuffer;
+    pHeap->position = pHeap->heap + capacity;
+    pHeap->elements = (uint8 *) ( pHeap->position + capacity );
+    pHeap->compare = compare;
+
+    for ( uint32 handle = 0; handle < capacity; ++handle )
+    {
+        pHeap->position[handle] = IINDEXEDHEAP_INVALID_SLOT;
+    }
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+bool IIndexedHeap_IsEmpty( tIIndexedHeap *pHeap )
+{
+    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL );
+
+    return pHeap->size == 0;
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+bool IIndexedHeap_Contains( tIIndexedHeap *pHeap, uint32 handle )
+{
+    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL && handle < pHeap->capacity );
+
+    return pHeap->position[handle] != IINDEXEDHEAP_INVALID_SLOT;
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+void * IIndexedHeap_Get( tIIndexedHeap *pHeap, uint32 handle )
+{
+    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL && handle < pHeap->capacity );
+
+    return pHeap->elements + (size_t) handle * pHeap->elementSize;
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+void * IIndexedHeap_Top( tIIndexedHeap *pHeap )
+{
+    return IIndexedHeap_Get( pHeap, IIndexedHeap_TopHandle( pHeap ) );
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+uint32 IIndexedHeap_TopHandle( tIIndexedHeap *pHeap )
+{
+    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL && pHeap->size > 0 );
+
+    return pHeap->heap[0];
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+void IIndexedHeap_Pop( tIIndexedHeap *pHeap )
+{
+    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL && pHeap->size > 0 );
+
+    pHeap->position[pHeap->heap[0]] = IINDEXEDHEAP_INVALID_SLOT;
+    FillSlot( pHeap, 0 );
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+bool IIndexedHeap_Insert( tIIndexedHeap *pHeap, uint32 handle, const void *pElem )
+{
+    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL && pElem != NULL && handle < pHeap->capacity );
+
+    if ( pHeap->position[handle] != IINDEXEDHEAP_INVALID_SLOT )
+    {
+        return false;
+    }
+
+    memcpy( IIndexedHeap_Get( pHeap, handle ), pElem, pHeap->elementSize );
+    SiftUp( pHeap, pHeap->size++, handle );
+
+    return true;
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+bool IIndexedHeap_DecreaseKey( tIIndexedHeap *pHeap, uint32 handle, const void *pElem )
+{
+    if ( !IIndexedHeap_Contains( pHeap, handle ) )
+    {
+        return false;
+    }
+
+    if ( pElem != NULL )
+    {
+        memcpy( IIndexedHeap_Get( pHeap, handle ), pElem, pHeap->elementSize );
+    }
+    SiftUp( pHeap, pHeap->position[handle], handle );
+
+    return true;
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+bool IIndexedHeap_IncreaseKey( tIIndexedHeap *pHeap, uint32 handle, const void *pElem )
+{
+    if ( !IIndexedHeap_Contains( pHeap, handle ) )
+    {
+        return false;
+    }
+
+    if ( pElem != NULL )
+    {
+        memcpy( IIndexedHeap_Get( pHeap, handle ), pElem, pHeap->elementSize );
+    }
+    SiftDown( pHeap, pHeap->position[handle], handle );
+
+    return true;
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+bool IIndexedHeap_Remove( tIIndexedHeap *pHeap, uint32 handle )
+{
+    if ( !IIndexedHeap_Contains( pHeap, handle ) )
+    {
+        return false;
+    }
+
+    uint32 slot = pHeap->position[handle];
+    pHeap->position[handle] = IINDEXEDHEAP_INVALID_SLOT;
+    FillSlot( pHeap, slot );
+
+    return true;
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+void IIndexedHeap_Apply( tIIndexedHeap *pHeap, tIIndexedHeap_ApplyFun function )
+{
+    SOFTWARE_EXCEPTION_ASSERT( pHeap != NULL && function != NULL );
+
+    for ( uint32 slot = 0; slot < pHeap->size; ++slot )
+    {
+        function( pHeap->heap[slot], Element( pHeap, pHeap->heap[slot] ) );
+    }
+}
+
+/*
+ ------------------------------------------------------------------------------
+ Public functions
+ ------------------------------------------------------------------------------
+ */
+
+
+/*
+ ------------------------------------------------------------------------------
+ Private functions
+ ------------------------------------------------------------------------------
+ */
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+static inline uint32 Parent( uint32 slot )
+{
+    return ( slot - 1 ) / 2;
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+static inline const void * Element( tIIndexedHeap *pHeap, uint32 handle )
+{
+    return pHeap->elements + (size_t) handle * pHeap->elementSize;
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+static inline void Place( tIIndexedHeap *pHeap, uint32 slot, uint32 handle )
+{
+    pHeap->heap[slot] = handle;
+    pHeap->position[handle] = slot;
+}
+
+/*
+ ******************************************************************************
+ * Function
+ * Elements stay in place, only 32-bit handles move along the path.
+ ******************************************************************************
+ */
+static void SiftUp( tIIndexedHeap *pHeap, uint32 slot, uint32 handle )
+{
+    const void *pElem = Element( pHeap, handle );
+
+    while ( slot != 0 )
+    {
+        uint32 parent = Parent( slot );
+        if ( !pHeap->compare( pElem, Element( pHeap, pHeap->heap[parent] ) ) )
+        {
+            break;
+        }
+        Place( pHeap, slot, pHeap->heap[parent] );
+        slot = parent;
+    }
+    Place( pHeap, slot, handle );
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+static void SiftDown( tIIndexedHeap *pHeap, uint32 slot, uint32 handle )
+{
+    const void *pElem = Element( pHeap, handle );
+    uint32 child;
+
+    while ( ( child = 2 * slot + 1 ) < pHeap->size )
+    {
+        if ( child + 1 < pHeap->size &&
+             pHeap->compare( Element( pHeap, pHeap->heap[child + 1] ), Element( pHeap, pHeap->heap[child] ) ) )
+        {
+            ++child;
+        }
+        if ( !pHeap->compare( Element( pHeap, pHeap->heap[child] ), pElem ) )
+        {
+            break;
+        }
+        Place( pHeap, slot, pHeap->heap[child] );
+        slot = child;
+    }
+    Place( pHeap, slot, handle );
+}
+
+/*
+ ******************************************************************************
+ * Function
+ ******************************************************************************
+ */
+static void FillSlot( tIIndexedHeap *pHeap, uint32 slot )
+{
+    uint32 last = pHeap->heap[--pHeap->size];
+
+    if ( slot == pHeap->size )
+    {
+        return;
+    }
+
+    // last handle may belong above or below the emptied slot
+    if ( slot != 0 && pHeap->compare( Element( pHeap, last ), Element( pHeap, pHeap->heap[Parent( slot )] ) ) )
+    {
+        SiftUp( pHeap, slot, last );
+    }
+    else
+    {
+        SiftDown( pHeap, slot, last );
+    }
+}
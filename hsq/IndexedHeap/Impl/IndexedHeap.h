@@ -0,0 +1,43 @@
+/**
+ ******************************************************************************
+ * @file      IndexedHeap.h
+ * 
+ * @brief     Header file for IndexedHeap implementation
+ ******************************************************************************
+ */
+
+#ifndef INDEXEDHEAP_H
+#define INDEXEDHEAP_H
+
+
+/*
+ ------------------------------------------------------------------------------
+    Include files
+ ------------------------------------------------------------------------------
+ */
+
+#include "IIndexedHeap.h"
+
+
+/*
+ ------------------------------------------------------------------------------
+    Defines
+ ------------------------------------------------------------------------------
+ */
+
+
+/*
+ ------------------------------------------------------------------------------
+    Type definitions
+ ------------------------------------------------------------------------------
+ */
+
+
+/*
+ ------------------------------------------------------------------------------
+    Public function prototypes
+ ------------------------------------------------------------------------------
+ */
+
+
+#endif /* INDEXEDHEAP */
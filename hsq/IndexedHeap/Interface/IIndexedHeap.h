@@ -0,0 +1,241 @@
+/**
+ ******************************************************************************
+ * @file      IIndexedHeap.h
+ *
+ * @brief     IndexedHeap interface
+ ******************************************************************************
+ */
+
+#ifndef IINDEXEDHEAP_H
+#define IINDEXEDHEAP_H
+
+/*
+ ------------------------------------------------------------------------------
+    Include files
+ ------------------------------------------------------------------------------
+ */
+
+#include "RoboticTypes.h"
+
+
+/*
+ ------------------------------------------------------------------------------
+    Defines
+ ------------------------------------------------------------------------------
+ */
+
+// max number of handles, heap indices stay 32-bit
+#define IINDEXEDHEAP_MAX_CAPACITY       0x7FFFFFFFu
+
+// position of handle which is not in the heap
+#define IINDEXEDHEAP_INVALID_SLOT       0xFFFFFFFFu
+
+// bytes of buffer for heap of capacity handles: heap order and position map
+// (uint32 each) followed by elements
+#define IINDEXEDHEAP_BUFFER_SIZE( capacity, elementSize ) \
+    ( (capacity) * ( 2 * sizeof( uint32 ) + (elementSize) ) )
+
+
+/*
+ ------------------------------------------------------------------------------
+    Type definitions
+ ------------------------------------------------------------------------------
+ */
+
+// comparison function for two elements in the heap
+// for a min heap (aka min priority queue), return true if a < b
+// for a max heap (aka max priority queue), return true if a > b
+typedef bool (*tIIndexedHeap_ComparisonFun)( const void *a, const void *b );
+
+// function to apply to each element in the queue, with its handle
+typedef void (*tIIndexedHeap_ApplyFun)( uint32 handle, const void *elem );
+
+typedef struct
+{
+    uint32 size;
+    uint32 capacity;            // handles are 0 .. capacity - 1
+    uint8 elementSize;
+    uint32 *heap;               // handles in heap order
+    uint32 *position;           // slot in heap of every handle
+    uint8 *elements;            // element of every handle, never moved
+    tIIndexedHeap_ComparisonFun compare;
+
+} tIIndexedHeap;
+
+
+/*
+ ------------------------------------------------------------------------------
+    Interface functions
+ ------------------------------------------------------------------------------
+ */
+
+/**
+ ******************************************************************************
+ * @brief   Initialize the module.
+ *          NOTE: SOFTWARE EXCEPTION if input params are not valid
+ * @param   pHeap
+ *          pointer to heap struct
+ * @param   pBuffer
+ *          user allocated buffer for heap data, of
+ *          IINDEXEDHEAP_BUFFER_SIZE( capacity, elementSize ) bytes, aligned
+ *          as the element type
+ * @param   capacity
+ *          number of handles, at most IINDEXEDHEAP_MAX_CAPACITY
+ * @param   elementSize
+ *          size of element to store in the heap
+ * @param   compare
+ *          pointer to function for comparing two elements in the heap
+ ******************************************************************************
+ */
+void IIndexedHeap_Init( tIIndexedHeap *pHeap,
+                        void *pBuffer,
+                        uint32 capacity,
+                        uint8 elementSize,
+                        tIIndexedHeap_ComparisonFun compare );
+
+/**
+ ******************************************************************************
+ * @brief   Check if heap is empty.
+ *          NOTE: SOFTWARE EXCEPTION if pHeap == NULL
+ * @param   pHeap
+ *          pointer to heap struct
+ * @returns true if empty, false otherwise
+ ******************************************************************************
+ */
+bool IIndexedHeap_IsEmpty( tIIndexedHeap *pHeap );
+
+/**
+ ******************************************************************************
+ * @brief   Check if element of handle is in the heap.
+ *          NOTE: SOFTWARE EXCEPTION if pHeap == NULL or handle is out of range
+ * @param   pHeap
+ *          pointer to heap struct
+ * @param   handle
+ *          handle of element
+ * @returns true if in the heap, false otherwise
+ ******************************************************************************
+ */
+bool IIndexedHeap_Contains( tIIndexedHeap *pHeap, uint32 handle );
+
+/**
+ ******************************************************************************
+ * @brief   Get a pointer to the element of handle. Element may be modified
+ *          in place and then passed to DecreaseKey/IncreaseKey as NULL.
+ *          It stays valid after the handle leaves the heap.
+ *          NOTE: SOFTWARE EXCEPTION if pHeap == NULL or handle is out of range
+ * @param   pHeap
+ *          pointer to heap struct
+ * @param   handle
+ *          handle of element
+ * @returns pointer to the element
+ ******************************************************************************
+ */
+void * IIndexedHeap_Get( tIIndexedHeap *pHeap, uint32 handle );
+
+/**
+ ******************************************************************************
+ * @brief   Get a pointer to the top element in the heap.
+ *          NOTE: SOFTWARE EXCEPTION if pHeap == NULL or heap is empty
+ * @param   pHeap
+ *          pointer to heap struct
+ * @returns pointer to the top element in the heap
+ ******************************************************************************
+ */
+void * IIndexedHeap_Top( tIIndexedHeap *pHeap );
+
+/**
+ ******************************************************************************
+ * @brief   Get handle of the top element in the heap.
+ *          NOTE: SOFTWARE EXCEPTION if pHeap == NULL or heap is empty
+ * @param   pHeap
+ *          pointer to heap struct
+ * @returns handle of the top element
+ ******************************************************************************
+ */
+uint32 IIndexedHeap_TopHandle( tIIndexedHeap *pHeap );
+
+/**
+ ******************************************************************************
+ * @brief   Remove the top element in the heap.
+ *          NOTE: SOFTWARE EXCEPTION if pHeap == NULL or heap is empty
+ * @param   pHeap
+ *          pointer to heap struct
+ ******************************************************************************
+ */
+void IIndexedHeap_Pop( tIIndexedHeap *pHeap );
+
+/**
+ ******************************************************************************
+ * @brief   Insert an element with given handle in the heap.
+ *          NOTE: SOFTWARE EXCEPTION if input params == NULL or handle is out
+ *          of range
+ * @param   pHeap
+ *          pointer to heap struct
+ * @param   handle
+ *          handle of element
+ * @param   pElem
+ *          pointer to element to insert
+ * @returns true if successful, false if handle is already in the heap
+ ******************************************************************************
+ */
+bool IIndexedHeap_Insert( tIIndexedHeap *pHeap, uint32 handle, const void *pElem );
+
+/**
+ ******************************************************************************
+ * @brief   Move element of handle towards the top, O(log n). New element
+ *          must not compare after the old one (smaller key in a min heap).
+ *          NOTE: SOFTWARE EXCEPTION if pHeap == NULL or handle is out of range
+ * @param   pHeap
+ *          pointer to heap struct
+ * @param   handle
+ *          handle of element
+ * @param   pElem
+ *          pointer to new element, NULL if element was modified in place
+ * @returns true if successful, false if handle is not in the heap
+ ******************************************************************************
+ */
+bool IIndexedHeap_DecreaseKey( tIIndexedHeap *pHeap, uint32 handle, const void *pElem );
+
+/**
+ ******************************************************************************
+ * @brief   Move element of handle away from the top, O(log n). New element
+ *          must not compare before the old one (greater key in a min heap).
+ *          NOTE: SOFTWARE EXCEPTION if pHeap == NULL or handle is out of range
+ * @param   pHeap
+ *          pointer to heap struct
+ * @param   handle
+ *          handle of element
+ * @param   pElem
+ *          pointer to new element, NULL if element was modified in place
+ * @returns true if successful, false if handle is not in the heap
+ ******************************************************************************
+ */
+bool IIndexedHeap_IncreaseKey( tIIndexedHeap *pHeap, uint32 handle, const void *pElem );
+
+/**
+ ******************************************************************************
+ * @brief   Remove element of handle from the heap, O(log n).
+ *          NOTE: SOFTWARE EXCEPTION if pHeap == NULL or handle is out of range
+ * @param   pHeap
+ *          pointer to heap struct
+ * @param   handle
+ *          handle of element
+ * @returns true if successful, false if handle is not in the heap
+ ******************************************************************************
+ */
+bool IIndexedHeap_Remove( tIIndexedHeap *pHeap, uint32 handle );
+
+/**
+ ******************************************************************************
+ * @brief   Apply a function to each element in the heap, in heap order.
+ *          NOTE: SOFTWARE EXCEPTION if input params == NULL
+ * @param   pHeap
+ *          pointer to heap struct
+ * @param   function
+ *          pointer to function to apply
+ ******************************************************************************
+ */
+void IIndexedHeap_Apply( tIIndexedHeap *pHeap, tIIndexedHeap_ApplyFun function );
+
+
+#endif /* IINDEXEDHEAP_H */
@@ -0,0 +1,286 @@
+/**
+ ******************************************************************************
+ * @file      IndexedHeap_test.cpp
+ *
+ * @brief     Host unit tests of IndexedHeap against a reference model
+ ******************************************************************************
+ */
+
+/*
+ ------------------------------------------------------------------------------
+ Include files
+ ------------------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+extern "C" {
+#include "IIndexedHeap.h"
+}
+
+
+/*
+ ------------------------------------------------------------------------------
+ Private types and functions
+ ------------------------------------------------------------------------------
+ */
+
+namespace {
+
+bool Less( const void *a, const void *b )
+{
+    return *static_cast<const uint64_t *>(a) < *static_cast<const uint64_t *>(b);
+}
+
+uint64_t Key( tIIndexedHeap &heap, uint32 handle )
+{
+    return *static_cast<uint64_t *>(IIndexedHeap_Get(&heap, handle));
+}
+
+/* Reference model: keys of handles in the heap, ordered by (key, handle). */
+class Model
+{
+public:
+    explicit Model( uint32 capacity ) : mKey(capacity), mIn(capacity, false) {}
+
+    bool contains( uint32 handle ) const { return mIn[handle]; }
+    uint64_t key( uint32 handle ) const { return mKey[handle]; }
+    std::size_t size() const { return mOrder.size(); }
+    uint64_t topKey() const { return mOrder.begin()->first; }
+
+    void insert( uint32 handle, uint64_t key )
+    {
+        mIn[handle] = true;
+        mKey[handle] = key;
+        mOrder.insert({key, handle});
+    }
+
+    void remove( uint32 handle )
+    {
+        mOrder.erase({mKey[handle], handle});
+        mIn[handle] = false;
+    }
+
+    void change( uint32 handle, uint64_t key )
+    {
+        remove(handle);
+        insert(handle, key);
+    }
+
+private:
+    std::vector<uint64_t> mKey;
+    std::vector<bool> mIn;
+    std::set<std::pair<uint64_t, uint32>> mOrder;
+};
+
+/* Position map is the inverse of heap order, handles out of the heap have
+   no slot, and no element compares before its parent. */
+void CheckInvariants( tIIndexedHeap &heap, const Model &model )
+{
+    ASSERT_EQ(model.size(), heap.size);
+    for ( uint32 slot = 0; slot < heap.size; ++slot )
+    {
+        const uint32 handle = heap.heap[slot];
+        ASSERT_LT(handle, heap.capacity);
+        ASSERT_EQ(slot, heap.position[handle]) << "  handle is: " << handle;
+        if ( slot > 0 )
+        {
+            const uint32 parent = heap.heap[( slot - 1 ) / 2];
+            ASSERT_LE(Key(heap, parent), Key(heap, handle)) << "  slot is: " << slot;
+        }
+    }
+    for ( uint32 handle = 0; handle < heap.capacity; ++handle )
+    {
+        ASSERT_EQ(model.contains(handle), IIndexedHeap_Contains(&heap, handle));
+        if ( !model.contains(handle) )
+        {
+            ASSERT_EQ(IINDEXEDHEAP_INVALID_SLOT, heap.position[handle]);
+        }
+        else
+        {
+            ASSERT_EQ(model.key(handle), Key(heap, handle));
+        }
+    }
+}
+
+/* Handles seen by IIndexedHeap_Apply. */
+std::set<uint32> applied;
+
+void Collect( uint32 handle, const void *elem )
+{
+    applied.insert(handle);
+    (void) elem;
+}
+
+} // namespace
+
+
+/*
+ ------------------------------------------------------------------------------
+ Tests
+ ------------------------------------------------------------------------------
+ */
+
+TEST(IndexedHeap_Test, T01_InsertTopPop)
+{
+    std::vector<uint64_t> buffer(IINDEXEDHEAP_BUFFER_SIZE(4, sizeof(uint64_t)) / sizeof(uint64_t));
+    tIIndexedHeap heap;
+    IIndexedHeap_Init(&heap, buffer.data(), 4, sizeof(uint64_t), Less);
+
+    const uint64_t keys[] = {30, 10, 40, 20};
+    EXPECT_TRUE(IIndexedHeap_IsEmpty(&heap));
+    for ( uint32 handle = 0; handle < 4; ++handle )
+    {
+        EXPECT_TRUE(IIndexedHeap_Insert(&heap, handle, &keys[handle]));
+    }
+    EXPECT_FALSE(IIndexedHeap_Insert(&heap, 2, &keys[0]));
+
+    for ( uint32 handle : {1u, 3u, 0u, 2u} )
+    {
+        EXPECT_EQ(handle, IIndexedHeap_TopHandle(&heap));
+        EXPECT_EQ(keys[handle], *static_cast<uint64_t *>(IIndexedHeap_Top(&heap)));
+        IIndexedHeap_Pop(&heap);
+        EXPECT_FALSE(IIndexedHeap_Contains(&heap, handle));
+    }
+    EXPECT_TRUE(IIndexedHeap_IsEmpty(&heap));
+}
+
+TEST(IndexedHeap_Test, T02_MissingHandle)
+{
+    std::vector<uint64_t> buffer(IINDEXEDHEAP_BUFFER_SIZE(3, sizeof(uint64_t)) / sizeof(uint64_t));
+    tIIndexedHeap heap;
+    IIndexedHeap_Init(&heap, buffer.data(), 3, sizeof(uint64_t), Less);
+
+    const uint64_t key = 7;
+    EXPECT_TRUE(IIndexedHeap_Insert(&heap, 0, &key));
+    EXPECT_FALSE(IIndexedHeap_DecreaseKey(&heap, 1, &key));
+    EXPECT_FALSE(IIndexedHeap_IncreaseKey(&heap, 1, &key));
+    EXPECT_FALSE(IIndexedHeap_Remove(&heap, 1));
+    EXPECT_TRUE(IIndexedHeap_Remove(&heap, 0));
+    EXPECT_FALSE(IIndexedHeap_Remove(&heap, 0));
+    EXPECT_TRUE(IIndexedHeap_IsEmpty(&heap));
+}
+
+/* Element modified through IIndexedHeap_Get, then passed as NULL. */
+TEST(IndexedHeap_Test, T03_KeyChangedInPlace)
+{
+    std::vector<uint64_t> buffer(IINDEXEDHEAP_BUFFER_SIZE(3, sizeof(uint64_t)) / sizeof(uint64_t));
+    tIIndexedHeap heap;
+    IIndexedHeap_Init(&heap, buffer.data(), 3, sizeof(uint64_t), Less);
+
+    const uint64_t keys[] = {10, 20, 30};
+    for ( uint32 handle = 0; handle < 3; ++handle )
+    {
+        IIndexedHeap_Insert(&heap, handle, &keys[handle]);
+    }
+    uint64_t *pKey = static_cast<uint64_t *>(IIndexedHeap_Get(&heap, 2));
+
+    *pKey = 5;
+    EXPECT_TRUE(IIndexedHeap_DecreaseKey(&heap, 2, NULL));
+    EXPECT_EQ(2u, IIndexedHeap_TopHandle(&heap));
+
+    *pKey = 50;
+    EXPECT_TRUE(IIndexedHeap_IncreaseKey(&heap, 2, NULL));
+    EXPECT_EQ(0u, IIndexedHeap_TopHandle(&heap));
+    // elements never move, pointer stays valid
+    EXPECT_EQ(pKey, IIndexedHeap_Get(&heap, 2));
+}
+
+TEST(IndexedHeap_Test, T04_RandomOperationsMatchModel)
+{
+    for ( uint32 capacity : {1u, 5u, 100u, 3000u} )
+    {
+        SCOPED_TRACE(capacity);
+        std::vector<uint64_t> buffer(IINDEXEDHEAP_BUFFER_SIZE(capacity, sizeof(uint64_t)) / sizeof(uint64_t));
+        tIIndexedHeap heap;
+        IIndexedHeap_Init(&heap, buffer.data(), capacity, sizeof(uint64_t), Less);
+        Model model(capacity);
+
+        std::mt19937 random(capacity);
+        for ( unsigned op = 0; op < 30000; ++op )
+        {
+            const uint32 handle = random() % capacity;
+            const uint64_t key = random() % 100000;
+            switch ( random() % 6 )
+            {
+            case 0:
+            case 1:
+                ASSERT_EQ(!model.contains(handle), IIndexedHeap_Insert(&heap, handle, &key));
+                if ( !model.contains(handle) )
+                {
+                    model.insert(handle, key);
+                }
+                break;
+            case 2:
+                if ( model.size() > 0 )
+                {
+                    const uint32 top = IIndexedHeap_TopHandle(&heap);
+                    ASSERT_EQ(model.topKey(), model.key(top));
+                    IIndexedHeap_Pop(&heap);
+                    model.remove(top);
+                }
+                break;
+            case 3:
+                ASSERT_EQ(model.contains(handle), IIndexedHeap_Remove(&heap, handle));
+                if ( model.contains(handle) )
+                {
+                    model.remove(handle);
+                }
+                break;
+            case 4:
+            {
+                const uint64_t smaller = model.key(handle) / 2;
+                ASSERT_EQ(model.contains(handle), IIndexedHeap_DecreaseKey(&heap, handle, &smaller));
+                if ( model.contains(handle) )
+                {
+                    model.change(handle, smaller);
+                }
+                break;
+            }
+            default:
+            {
+                const uint64_t greater = model.key(handle) + key;
+                ASSERT_EQ(model.contains(handle), IIndexedHeap_IncreaseKey(&heap, handle, &greater));
+                if ( model.contains(handle) )
+                {
+                    model.change(handle, greater);
+                }
+                break;
+            }
+            }
+
+            // full check is O(capacity), often enough for large heaps
+            if ( capacity < 1000 || op % 97 == 0 )
+            {
+                CheckInvariants(heap, model);
+                ASSERT_FALSE(HasFatalFailure()) << "  op is: " << op;
+            }
+        }
+        CheckInvariants(heap, model);
+    }
+}
+
+TEST(IndexedHeap_Test, T05_ApplyVisitsHandlesInHeap)
+{
+    std::vector<uint64_t> buffer(IINDEXEDHEAP_BUFFER_SIZE(10, sizeof(uint64_t)) / sizeof(uint64_t));
+    tIIndexedHeap heap;
+    IIndexedHeap_Init(&heap, buffer.data(), 10, sizeof(uint64_t), Less);
+
+    for ( uint32 handle = 0; handle < 10; ++handle )
+    {
+        const uint64_t key = 100 - handle;
+        IIndexedHeap_Insert(&heap, handle, &key);
+    }
+    IIndexedHeap_Remove(&heap, 3);
+    IIndexedHeap_Pop(&heap);
+
+    applied.clear();
+    IIndexedHeap_Apply(&heap, Collect);
+    EXPECT_EQ(std::set<uint32>({0, 1, 2, 4, 5, 6, 7, 8}), applied);
+}
@@ -0,0 +1,428 @@
+/**
+ * @file microbench.cpp
+ * @brief Micro-benchmark harness shared by misc/ projects
+ *
+ * @author Krzysztof Lasota
+ */
+
+#include "microbench.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <ostream>
+#include <regex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include <sched.h>
+
+
+namespace microbench {
+
+namespace {
+
+std::system_error systemError(const std::string& what)
+{
+	return std::system_error(errno, std::generic_category(), what);
+}
+
+double processCpuSeconds()
+{
+	timespec ts;
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+std::vector<std::unique_ptr<Benchmark>>& registry()
+{
+	static std::vector<std::unique_ptr<Benchmark>> benchmarks;
+	return benchmarks;
+}
+
+/// Result of single run.
+struct Run
+{
+	double realSeconds;
+	double cpuSeconds;
+	std::uint64_t bytes;
+	std::uint64_t items;
+	std::string label;
+	std::string error;
+};
+
+Run runOnce(const Benchmark& benchmark, const std::vector<std::int64_t>& args, std::uint64_t iterations)
+{
+	State state(iterations, args);
+	benchmark.function()(state);
+	if (state.error().empty() && state.keepRunning())
+		state.skipWithError("benchmark did not loop over state");
+	return Run{state.realSeconds(), state.cpuSeconds(), state.bytesProcessed(),
+			state.itemsProcessed(), state.label(), state.error()};
+}
+
+std::string instanceName(const Benchmark& benchmark, const std::vector<std::int64_t>& args)
+{
+	std::string name = benchmark.name();
+	for (const std::int64_t arg : args)
+		name += "/" + std::to_string(arg);
+	return name;
+}
+
+/// Characters of JSON string, quotes and control characters escaped.
+std::string jsonString(const std::string& text)
+{
+	std::string quoted = "\"";
+	for (const char ch : text) {
+		if (ch == '"' || ch == '\\') {
+			quoted += '\\';
+			quoted += ch;
+		}
+		else if (static_cast<unsigned char>(ch) < 0x20) {
+			char code[8];
+			std::snprintf(code, sizeof(code), "\\u%04x", ch);
+			quoted += code;
+		}
+		else
+			quoted += ch;
+	}
+	return quoted + "\"";
+}
+
+/// First line of file, empty if not readable.
+std::string readLine(const char* path)
+{
+	std::ifstream file(path);
+	std::string line;
+	std::getline(file, line);
+	return line;
+}
+
+} // namespace
+
+
+State::State(std::uint64_t iterations_, const std::vector<std::int64_t>& args_)
+ : mIterations(iterations_)
+ , mArgs(args_)
+ , mRemaining(iterations_)
+ , mStarted(false)
+ , mRunning(false)
+ , mCpuStart(0)
+ , mRealSeconds(0)
+ , mCpuSeconds(0)
+ , mBytes(0)
+ , mItems(0)
+{
+}
+
+
+bool State::keepRunning()
+{
+	if (!mStarted) {
+		mStarted = true;
+		startTimer();
+	}
+	if (mRemaining > 0 && mError.empty()) {
+		--mRemaining;
+		return true;
+	}
+	if (mRunning)
+		stopTimer();
+	return false;
+}
+
+
+State::Iterator State::begin()
+{
+	return Iterator{this};
+}
+
+
+State::Iterator State::end()
+{
+	return Iterator{this};
+}
+
+
+std::int64_t State::range(std::size_t idx) const
+{
+	return idx < mArgs.size() ? mArgs[idx] : 0;
+}
+
+
+void State::pauseTiming()
+{
+	if (mRunning)
+		stopTimer();
+}
+
+
+void State::resumeTiming()
+{
+	if (!mRunning)
+		startTimer();
+}
+
+
+void State::skipWithError(const std::string& error)
+{
+	mError = error;
+	mRemaining = 0;
+}
+
+
+double State::realSeconds() const
+{
+	return mRealSeconds;
+}
+
+
+double State::cpuSeconds() const
+{
+	return mCpuSeconds;
+}
+
+
+void State::startTimer()
+{
+	mRunning = true;
+	mCpuStart = processCpuSeconds();
+	mRealStart = std::chrono::steady_clock::now();
+}
+
+
+void State::stopTimer()
+{
+	const std::chrono::duration<double> real = std::chrono::steady_clock::now() - mRealStart;
+	mRealSeconds += real.count();
+	mCpuSeconds += processCpuSeconds() - mCpuStart;
+	mRunning = false;
+}
+
+
+Benchmark::Benchmark(const std::string& name_, const Function& function_)
+ : mName(name_)
+ , mFunction(function_)
+ , mIterations(0)
+ , mRepetitions(0)
+ , mMinTime(-1)
+{
+}
+
+
+Benchmark* Benchmark::arg(std::int64_t value)
+{
+	mArgs.push_back({value});
+	return this;
+}
+
+
+Benchmark* Benchmark::args(std::initializer_list<std::int64_t> values)
+{
+	mArgs.push_back(values);
+	return this;
+}
+
+
+Benchmark* Benchmark::range(std::int64_t lo, std::int64_t hi, std::int64_t multiplier)
+{
+	if (lo <= 0 || multiplier < 2)
+		throw std::invalid_argument("benchmark range needs positive start and multiplier above 1");
+	for (std::int64_t value = lo; value < hi; value *= multiplier)
+		arg(value);
+	return arg(hi);
+}
+
+
+Benchmark* Benchmark::iterations(std::uint64_t count)
+{
+	mIterations = count;
+	return this;
+}
+
+
+Benchmark* Benchmark::repetitions(unsigned count)
+{
+	mRepetitions = count;
+	return this;
+}
+
+
+Benchmark* Benchmark::minTime(double seconds)
+{
+	mMinTime = seconds;
+	return this;
+}
+
+
+std::vector<std::vector<std::int64_t>> Benchmark::instances() const
+{
+	if (mArgs.empty())
+		return {{}};
+	return mArgs;
+}
+
+
+Benchmark* registerBenchmark(const std::string& name, const Function& function)
+{
+	registry().emplace_back(new Benchmark(name, function));
+	return registry().back().get();
+}
+
+
+const std::vector<std::unique_ptr<Benchmark>>& registeredBenchmarks()
+{
+	return registry();
+}
+
+
+Statistics summarize(std::vector<double> samples)
+{
+	if (samples.empty())
+		throw std::invalid_argument("no samples to summarize");
+
+	std::sort(samples.begin(), samples.end());
+	const std::size_t count = samples.size();
+
+	Statistics stats;
+	stats.min = samples.front();
+	stats.max = samples.back();
+	stats.median = (count % 2) ? samples[count / 2] : (samples[count / 2 - 1] + samples[count / 2]) / 2;
+	for (const double sample : samples)
+		stats.mean += sample;
+	stats.mean /= count;
+	if (count > 1) {
+		double squares = 0;
+		for (const double sample : samples)
+			squares += (sample - stats.mean) * (sample - stats.mean);
+		stats.stddev = std::sqrt(squares / (count - 1));
+	}
+	return stats;
+}
+
+
+int pinToCpu(int cpu)
+{
+	cpu_set_t allowed;
+	if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+		throw systemError("sched_getaffinity");
+	if (cpu < 0) {
+		for (cpu = 0; cpu < CPU_SETSIZE && !CPU_ISSET(cpu, &allowed); ++cpu)
+			;
+	}
+	if (cpu >= CPU_SETSIZE || !CPU_ISSET(cpu, &allowed)) {
+		errno = EINVAL;
+		throw systemError("CPU " + std::to_string(cpu) + " is not allowed");
+	}
+
+	cpu_set_t pinned;
+	CPU_ZERO(&pinned);
+	CPU_SET(cpu, &pinned);
+	if (sched_setaffinity(0, sizeof(pinned), &pinned) != 0)
+		throw systemError("sched_setaffinity");
+	return cpu;
+}
+
+
+int runBenchmarks(const RunConfig& config, std::ostream& json)
+{
+	const std::regex filter(config.filter.empty() ? std::string(".*") : config.filter);
+	const int cpu = (config.cpu == -1) ? -1 : pinToCpu(config.cpu);
+	const std::string governor = readLine(cpu >= 0
+			? ("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/scaling_governor").c_str()
+			: "/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor");
+
+	char line[512];
+	std::snprintf(line, sizeof(line), "{\n  \"benchmark\": %s,\n  \"context\": {\"cpu\": %d,"
+			" \"num_cpus\": %u, \"scaling_governor\": %s, \"repetitions\": %u,"
+			" \"min_time\": %.3f, \"warmup\": %.3f},\n  \"results\": [",
+			jsonString(config.suite).c_str(), cpu, std::thread::hardware_concurrency(),
+			jsonString(governor).c_str(), config.repetitions, config.minTime, config.warmup);
+	json << line;
+
+	int failed = 0;
+	bool first = true;
+	for (const std::unique_ptr<Benchmark>& benchmark : registry()) {
+		for (const std::vector<std::int64_t>& args : benchmark->instances()) {
+			const std::string name = instanceName(*benchmark, args);
+			if (!std::regex_search(name, filter))
+				continue;
+
+			const double minTime = benchmark->fixedMinTime() >= 0 ? benchmark->fixedMinTime() : config.minTime;
+			const unsigned repetitions = std::max(1u, benchmark->fixedRepetitions()
+					? benchmark->fixedRepetitions() : config.repetitions);
+
+			// calibration runs warm caches and branch predictors too
+			std::uint64_t iterations = benchmark->fixedIterations() ? benchmark->fixedIterations() : 1;
+			double warmed = 0;
+			Run run = runOnce(*benchmark, args, iterations);
+			warmed += run.realSeconds;
+			while (run.error.empty() && !benchmark->fixedIterations() && run.realSeconds < minTime) {
+				const double factor = run.realSeconds > 0 ? 1.4 * minTime / run.realSeconds : 10;
+				iterations = std::max<std::uint64_t>(iterations + 1,
+						iterations * std::min(10.0, std::max(2.0, factor)));
+				run = runOnce(*benchmark, args, iterations);
+				warmed += run.realSeconds;
+			}
+			while (run.error.empty() && warmed < config.warmup && run.realSeconds > 0) {
+				run = runOnce(*benchmark, args, iterations);
+				warmed += run.realSeconds;
+			}
+
+			std::vector<double> realNs, cpuNs;
+			double bytesPerSecond = 0, itemsPerSecond = 0;
+			for (unsigned rep = 0; rep < repetitions && run.error.empty(); ++rep) {
+				run = runOnce(*benchmark, args, iterations);
+				realNs.push_back(run.realSeconds * 1e9 / iterations);
+				cpuNs.push_back(run.cpuSeconds * 1e9 / iterations);
+				if (run.realSeconds > 0) {
+					bytesPerSecond += run.bytes / run.realSeconds / repetitions;
+					itemsPerSecond += run.items / run.realSeconds / repetitions;
+				}
+			}
+
+			json << (first ? "" : ",") << "\n    {\"name\": " << jsonString(name);
+			first = false;
+			if (!run.error.empty()) {
+				++failed;
+				json << ", \"error\": " << jsonString(run.error) << "}";
+				if (config.progress)
+					*config.progress << name << ": " << run.error << "\n";
+				continue;
+			}
+
+			const Statistics real = summarize(realNs);
+			std::snprintf(line, sizeof(line), ", \"iterations\": %llu, \"repetitions\": %u,"
+					" \"mean_ns\": %.3f, \"median_ns\": %.3f, \"stddev_ns\": %.3f, \"min_ns\": %.3f,"
+					" \"max_ns\": %.3f, \"cv\": %.4f, \"cpu_mean_ns\": %.3f",
+					(unsigned long long)iterations, repetitions, real.mean, real.median,
+					real.stddev, real.min, real.max, real.cv(), summarize(cpuNs).mean);
+			json << line;
+			if (run.bytes) {
+				std::snprintf(line, sizeof(line), ", \"bytes_per_second\": %.1f", bytesPerSecond);
+				json << line;
+			}
+			if (run.items) {
+				std::snprintf(line, sizeof(line), ", \"items_per_second\": %.1f", itemsPerSecond);
+				json << line;
+			}
+			if (!run.label.empty())
+				json << ", \"label\": " << jsonString(run.label);
+			json << "}";
+
+			if (config.progress) {
+				std::snprintf(line, sizeof(line), "%-40s %14.1f ns  +-%5.1f%%  %12llu iterations\n",
+						name.c_str(), real.mean, real.cv() * 100, (unsigned long long)iterations);
+				*config.progress << line;
+			}
+		}
+	}
+	json << "\n  ]\n}\n";
+	return failed;
+}
+
+} // namespace microbench
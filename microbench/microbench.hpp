@@ -0,0 +1,270 @@
+/**
+ * @file microbench.hpp
+ * @brief Micro-benchmark harness shared by misc/ projects
+ *
+ * Benchmarks are registered by MICROBENCH() or MICROBENCH_F() and timed by
+ * runner in microbench_main.cpp, which pins process to one CPU, warms up
+ * every benchmark, repeats it and prints statistics as JSON.
+ *
+ * @code
+ * void BM_Sort(microbench::State& state)
+ * {
+ *     std::vector<int> data(state.range());
+ *     for (auto _ : state) {
+ *         state.pauseTiming();
+ *         fill(data);
+ *         state.resumeTiming();
+ *         std::sort(data.begin(), data.end());
+ *         microbench::doNotOptimize(data);
+ *     }
+ *     state.setItemsProcessed(state.iterations() * data.size());
+ * }
+ * MICROBENCH(BM_Sort)->arg(1 << 10)->arg(1 << 20);
+ * @endcode
+ *
+ * @author Krzysztof Lasota
+ */
+
+#ifndef MICROBENCH_HPP_
+#define MICROBENCH_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace microbench {
+
+/**
+ * @brief Timer and parameters of single run of benchmark.
+ *
+ * Benchmark body loops "for (auto _ : state)" or "while (state.keepRunning())",
+ * time outside of loop and between pauseTiming() and resumeTiming() is
+ * not measured.
+ */
+class State
+{
+public:
+	struct Iterator;
+
+	State(std::uint64_t iterations_, const std::vector<std::int64_t>& args_);
+
+	/// True while iterations remain, first call starts timer, last stops it.
+	bool keepRunning();
+
+	Iterator begin();
+	Iterator end();
+
+	/// Argument of benchmark instance.
+	std::int64_t range(std::size_t idx = 0) const;
+	std::uint64_t iterations() const { return mIterations; }
+
+	void pauseTiming();
+	void resumeTiming();
+
+	/// Totals of whole run, reported per second.
+	void setBytesProcessed(std::uint64_t bytes) { mBytes = bytes; }
+	void setItemsProcessed(std::uint64_t items) { mItems = items; }
+	void setLabel(const std::string& label) { mLabel = label; }
+	/// Marks run failed, loop ends at next check.
+	void skipWithError(const std::string& error);
+
+	double realSeconds() const;
+	double cpuSeconds() const;
+	std::uint64_t bytesProcessed() const { return mBytes; }
+	std::uint64_t itemsProcessed() const { return mItems; }
+	const std::string& label() const { return mLabel; }
+	const std::string& error() const { return mError; }
+
+private:
+	void startTimer();
+	void stopTimer();
+
+	const std::uint64_t mIterations;
+	const std::vector<std::int64_t> mArgs;
+	std::uint64_t mRemaining;
+	bool mStarted;
+	bool mRunning;
+	std::chrono::steady_clock::time_point mRealStart;
+	double mCpuStart;
+	double mRealSeconds;
+	double mCpuSeconds;
+	std::uint64_t mBytes;
+	std::uint64_t mItems;
+	std::string mLabel;
+	std::string mError;
+};
+
+/// Range-for support, counts iterations and ends timing.
+struct State::Iterator
+{
+	/// User-provided destructor keeps unused loop variable from warnings.
+	struct Value
+	{
+		~Value() {}
+	};
+
+	State* state;
+
+	Value operator*() const { return Value(); }
+	Iterator& operator++() { return *this; }
+	bool operator!=(const Iterator&) { return state->keepRunning(); }
+};
+
+
+/// Base of fixtures, new instance is created for every run.
+class Fixture
+{
+public:
+	virtual ~Fixture() {}
+
+	virtual void setUp(State& state) { (void)state; }
+	virtual void tearDown(State& state) { (void)state; }
+	virtual void run(State& state) = 0;
+};
+
+
+typedef std::function<void(State&)> Function;
+
+/// Registered benchmark, setters return this for chaining.
+class Benchmark
+{
+public:
+	Benchmark(const std::string& name_, const Function& function_);
+
+	/// Adds instance with single argument, see State::range().
+	Benchmark* arg(std::int64_t value);
+	Benchmark* args(std::initializer_list<std::int64_t> values);
+	/// Adds instances lo, lo*multiplier, ... up to and including hi.
+	Benchmark* range(std::int64_t lo, std::int64_t hi, std::int64_t multiplier = 8);
+
+	/// Fixed iterations per run instead of calibration.
+	Benchmark* iterations(std::uint64_t count);
+	/// Overrides runner's number of repetitions.
+	Benchmark* repetitions(unsigned count);
+	/// Overrides runner's minimal time of run.
+	Benchmark* minTime(double seconds);
+
+	const std::string& name() const { return mName; }
+	const Function& function() const { return mFunction; }
+	/// Argument lists, single empty one without arguments.
+	std::vector<std::vector<std::int64_t>> instances() const;
+	std::uint64_t fixedIterations() const { return mIterations; }
+	unsigned fixedRepetitions() const { return mRepetitions; }
+	double fixedMinTime() const { return mMinTime; }
+
+private:
+	std::string mName;
+	Function mFunction;
+	std::vector<std::vector<std::int64_t>> mArgs;
+	std::uint64_t mIterations;
+	unsigned mRepetitions;
+	double mMinTime;
+};
+
+/// Registers benchmark, registry owns it.
+Benchmark* registerBenchmark(const std::string& name, const Function& function);
+
+template<typename FixtureType>
+Benchmark* registerFixture(const std::string& name)
+{
+	return registerBenchmark(name, [](State& state) {
+		FixtureType fixture;
+		fixture.setUp(state);
+		fixture.run(state);
+		fixture.tearDown(state);
+	});
+}
+
+/// All registered benchmarks in order of registration.
+const std::vector<std::unique_ptr<Benchmark>>& registeredBenchmarks();
+
+
+/// Keeps value, as if read by unknown code, without extra instructions.
+template<typename T>
+inline void doNotOptimize(const T& value)
+{
+	asm volatile("" : : "g"(&value) : "memory");
+}
+
+/// Forces pending stores to memory.
+inline void clobberMemory()
+{
+	asm volatile("" : : : "memory");
+}
+
+
+struct Statistics
+{
+	double mean = 0;
+	double median = 0;
+	double stddev = 0;    ///< sample standard deviation
+	double min = 0;
+	double max = 0;
+
+	/// Coefficient of variation, stddev / mean.
+	double cv() const { return mean > 0 ? stddev / mean : 0; }
+};
+
+/// @throw std::invalid_argument for empty samples
+Statistics summarize(std::vector<double> samples);
+
+
+struct RunConfig
+{
+	std::string suite = "microbench";    ///< name of JSON report
+	std::string filter;                  ///< regular expression of instance names, empty for all
+	unsigned repetitions = 5;
+	double minTime = 0.1;                ///< seconds of single run after calibration
+	double warmup = 0.1;                 ///< seconds of discarded runs before repetitions
+	int cpu = -2;                        ///< CPU to pin to, -1 for none, -2 for first allowed
+	std::ostream* progress = nullptr;    ///< one line per instance
+};
+
+/**
+ * @brief Runs registered benchmarks matching filter, writes JSON report.
+ *
+ * Every instance is calibrated to at least minTime per run, run until
+ * warmup passes, then repeated; statistics are per iteration.
+ *
+ * @return number of failed instances
+ * @throw std::system_error when CPU can not be pinned
+ * @throw std::regex_error for invalid filter
+ */
+int runBenchmarks(const RunConfig& config, std::ostream& json);
+
+/// Pins calling thread (and threads created later) to CPU, -2 for first allowed.
+/// @return pinned CPU
+/// @throw std::system_error on failure
+int pinToCpu(int cpu);
+
+} // namespace microbench
+
+
+#define MICROBENCH_CONCAT_(a, b) a##b
+#define MICROBENCH_CONCAT(a, b) MICROBENCH_CONCAT_(a, b)
+
+/// Registers function void(microbench::State&) as benchmark.
+#define MICROBENCH(function) \
+	static ::microbench::Benchmark* const MICROBENCH_CONCAT(microbench_registered_, __LINE__) \
+		__attribute__((unused)) = ::microbench::registerBenchmark(#function, function)
+
+/// Defines and registers benchmark run on new instance of fixture class.
+#define MICROBENCH_F(FixtureType, Name) \
+	class FixtureType##_##Name##_Benchmark : public FixtureType \
+	{ \
+	public: \
+		void run(::microbench::State& state) override; \
+	}; \
+	static ::microbench::Benchmark* const MICROBENCH_CONCAT(microbench_registered_, __LINE__) \
+		__attribute__((unused)) = ::microbench::registerFixture<FixtureType##_##Name##_Benchmark>( \
+				#FixtureType "/" #Name); \
+	void FixtureType##_##Name##_Benchmark::run(::microbench::State& state)
+
+#endif /* MICROBENCH_HPP_ */
@@ -0,0 +1,48 @@
+# Shared rules of benchmark targets, see README.md.
+#
+# Set before including:
+#   BENCH_SRCS      benchmark sources, using microbench.hpp
+#   BENCH_DEPS      benchmarked project sources, .c and .cpp
+#   BENCH_OBJS      prebuilt objects linked in (optional)
+#   BENCH_LIBS      libraries linked in (optional)
+#   BENCH_MAIN      runner, empty for benchmark with own main() (default microbench_main.cpp)
+#   BENCH_TRGT      executable (default SUITE_bench, never bench itself)
+#   BENCH_SUITE     name in JSON report (default name of directory)
+#   BENCH_ARGS      arguments of bench-run
+# Provides targets bench, bench-run and bench-clean; benchmark is always
+# built with optimizations, from sources.
+
+MICROBENCH_DIR := $(patsubst %/,%,$(dir $(lastword $(MAKEFILE_LIST))))
+MICROBENCH_GOAL := $(.DEFAULT_GOAL)
+
+BENCH_SUITE ?= $(notdir $(CURDIR))
+BENCH_TRGT ?= $(BENCH_SUITE)_bench
+BENCH_MAIN ?= $(MICROBENCH_DIR)/microbench_main.cpp
+BENCH_CXXFLAGS ?= -O2 -DNDEBUG
+BENCH_CFLAGS ?= -O2 -DNDEBUG
+
+BENCH_C_DEPS := $(filter %.c,$(BENCH_DEPS))
+BENCH_C_OBJS := $(addprefix bench_,$(notdir $(BENCH_C_DEPS:%.c=%.o)))
+BENCH_CXX_SRCS := $(BENCH_SRCS) $(filter %.cpp,$(BENCH_DEPS)) \
+		$(MICROBENCH_DIR)/microbench.cpp $(BENCH_MAIN)
+
+vpath %.c $(sort $(dir $(BENCH_C_DEPS)))
+
+bench_%.o :  %.c
+	$(CC) $(CPPFLAGS) $(CFLAGS) $(BENCH_CFLAGS) -o $@ -c $<
+
+$(BENCH_TRGT) :  $(BENCH_CXX_SRCS) $(BENCH_C_OBJS) $(BENCH_OBJS) $(MICROBENCH_DIR)/microbench.hpp
+	$(CXX) $(CPPFLAGS) -I$(MICROBENCH_DIR) -DMICROBENCH_SUITE='"$(BENCH_SUITE)"' \
+		$(CXXFLAGS) $(BENCH_CXXFLAGS) -pthread -o $@ \
+		$(BENCH_CXX_SRCS) $(BENCH_C_OBJS) $(BENCH_OBJS) $(BENCH_LIBS)
+
+.PHONY :  bench bench-run bench-clean
+
+bench :  $(BENCH_TRGT)
+bench-run :  bench
+	./$(BENCH_TRGT) $(BENCH_ARGS)
+bench-clean :
+	$(RM)  $(BENCH_TRGT)  $(BENCH_C_OBJS)
+
+# included rules do not change default goal of including makefile
+.DEFAULT_GOAL := $(MICROBENCH_GOAL)
@@ -0,0 +1,46 @@
+/**
+ * @file microbench_bench.cpp
+ * @brief Overhead of harness itself, subtract from timings of tiny bodies
+ *
+ * @author Krzysztof Lasota
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "microbench.hpp"
+
+
+namespace {
+
+void BM_EmptyLoop(microbench::State& state)
+{
+	for (auto _ : state)
+		microbench::clobberMemory();
+}
+MICROBENCH(BM_EmptyLoop);
+
+void BM_PauseResume(microbench::State& state)
+{
+	for (auto _ : state) {
+		state.pauseTiming();
+		state.resumeTiming();
+	}
+}
+MICROBENCH(BM_PauseResume);
+
+/// Reference memory bandwidth.
+void BM_Memcpy(microbench::State& state)
+{
+	const std::size_t size = state.range();
+	std::vector<std::uint8_t> source(size, 1), target(size);
+	for (auto _ : state) {
+		std::memcpy(target.data(), source.data(), size);
+		microbench::doNotOptimize(target);
+	}
+	state.setBytesProcessed(state.iterations() * size);
+}
+MICROBENCH(BM_Memcpy)->range(1 << 10, 1 << 24, 32);
+
+} // namespace
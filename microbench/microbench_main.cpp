@@ -0,0 +1,105 @@
+/**
+ * @file microbench_main.cpp
+ * @brief Command line runner of registered micro-benchmarks
+ *
+ * @author Krzysztof Lasota
+ */
+
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+
+#include <unistd.h>
+
+#include "microbench.hpp"
+
+#ifndef MICROBENCH_SUITE
+#define MICROBENCH_SUITE "microbench"
+#endif
+
+
+namespace {
+
+void printUsage(const char* appl)
+{
+	std::cerr << "Usage: " << appl << " [-f REGEX] [-r REPETITIONS] [-t SECONDS] [-w SECONDS]"
+			" [-c CPU] [-o FILE] [-l]\n"
+			"  -f REGEX        run only benchmarks matching REGEX\n"
+			"  -r REPETITIONS  measured runs of every benchmark (default 5)\n"
+			"  -t SECONDS      minimal time of single run (default 0.1)\n"
+			"  -w SECONDS      warm-up time before measured runs (default 0.1)\n"
+			"  -c CPU          pin to CPU, -1 for no pinning (default first allowed)\n"
+			"  -o FILE         write JSON report to FILE instead of standard output\n"
+			"  -l              list benchmarks\n";
+}
+
+} // namespace
+
+
+int main(int argc, char** argv)
+{
+	microbench::RunConfig config;
+	config.suite = MICROBENCH_SUITE;
+	config.progress = &std::cerr;
+	const char* reportPath = nullptr;
+	bool list = false;
+
+	int opt;
+	while ((opt = getopt(argc, argv, "f:r:t:w:c:o:lh")) != -1) {
+		switch (opt) {
+		case 'f':
+			config.filter = optarg;
+			break;
+		case 'r':
+			config.repetitions = atoi(optarg);
+			break;
+		case 't':
+			config.minTime = atof(optarg);
+			break;
+		case 'w':
+			config.warmup = atof(optarg);
+			break;
+		case 'c':
+			config.cpu = atoi(optarg);
+			break;
+		case 'o':
+			reportPath = optarg;
+			break;
+		case 'l':
+			list = true;
+			break;
+		default:
+			printUsage(argv[0]);
+			return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	if (list) {
+		for (const auto& benchmark : microbench::registeredBenchmarks())
+			for (const auto& args : benchmark->instances()) {
+				std::cout << benchmark->name();
+				for (const auto arg : args)
+					std::cout << "/" << arg;
+				std::cout << "\n";
+			}
+		return EXIT_SUCCESS;
+	}
+
+	try {
+		std::ofstream file;
+		if (reportPath) {
+			file.open(reportPath);
+			if (!file) {
+				std::cerr << argv[0] << ": can not open " << reportPath << "\n";
+				return EXIT_FAILURE;
+			}
+		}
+		const int failed = microbench::runBenchmarks(config, reportPath ? file : std::cout);
+		return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
+	catch (const std::exception& e) {
+		std::cerr << argv[0] << ": " << e.what() << "\n";
+		return EXIT_FAILURE;
+	}
+}
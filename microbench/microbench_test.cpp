@@ -0,0 +1,173 @@
+/**
+ * @file microbench_test.cpp
+ * @brief Test for micro-benchmark harness
+ *
+ * @author Krzysztof Lasota
+ */
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "microbench.hpp"
+
+
+namespace {
+
+unsigned sFixtureSetUps = 0;
+
+class CountingFixture : public microbench::Fixture
+{
+public:
+	void setUp(microbench::State& state) override
+	{
+		++sFixtureSetUps;
+		mValue = state.range();
+	}
+
+protected:
+	std::int64_t mValue = 0;
+};
+
+MICROBENCH_F(CountingFixture, Sum)
+{
+	std::int64_t sum = 0;
+	for (auto _ : state)
+		microbench::doNotOptimize(sum += mValue);
+	state.setItemsProcessed(state.iterations());
+}
+
+void BM_Failing(microbench::State& state)
+{
+	state.skipWithError("no \"input\"");
+	for (auto _ : state)
+		;
+}
+MICROBENCH(BM_Failing);
+
+void BM_NoLoop(microbench::State& state)
+{
+	(void)state;
+}
+MICROBENCH(BM_NoLoop);
+
+microbench::RunConfig quickConfig(const std::string& filter)
+{
+	microbench::RunConfig config;
+	config.filter = filter;
+	config.repetitions = 3;
+	config.minTime = 0.001;
+	config.warmup = 0;
+	config.cpu = -1;
+	return config;
+}
+
+} // namespace
+
+
+TEST(State_Test, T01_IterationsAndTiming)
+{
+	microbench::State state(3, {7, 9});
+	EXPECT_EQ(7, state.range());
+	EXPECT_EQ(9, state.range(1));
+	EXPECT_EQ(0, state.range(2));
+
+	unsigned loops = 0;
+	for (auto _ : state) {
+		++loops;
+		state.pauseTiming();
+		state.resumeTiming();
+	}
+	EXPECT_EQ(3u, loops);
+	EXPECT_FALSE(state.keepRunning());
+	EXPECT_GT(state.realSeconds(), 0);
+
+	microbench::State empty(0, {});
+	EXPECT_FALSE(empty.keepRunning());
+}
+
+TEST(Statistics_Test, T01_Summarize)
+{
+	const microbench::Statistics stats = microbench::summarize({4, 1, 3, 2});
+	EXPECT_DOUBLE_EQ(2.5, stats.mean);
+	EXPECT_DOUBLE_EQ(2.5, stats.median);
+	EXPECT_DOUBLE_EQ(1, stats.min);
+	EXPECT_DOUBLE_EQ(4, stats.max);
+	EXPECT_NEAR(1.290994, stats.stddev, 1e-6);
+	EXPECT_NEAR(0.516398, stats.cv(), 1e-6);
+
+	EXPECT_DOUBLE_EQ(0, microbench::summarize({5}).stddev);
+	EXPECT_THROW(microbench::summarize({}), std::invalid_argument);
+}
+
+TEST(Benchmark_Test, T01_Instances)
+{
+	microbench::Benchmark benchmark("BM", [](microbench::State&) {});
+	ASSERT_EQ(1u, benchmark.instances().size());
+	EXPECT_TRUE(benchmark.instances()[0].empty());
+
+	benchmark.range(8, 100)->args({1, 2});
+	const auto instances = benchmark.instances();
+	ASSERT_EQ(4u, instances.size());
+	EXPECT_EQ(8, instances[0][0]);
+	EXPECT_EQ(64, instances[1][0]);
+	EXPECT_EQ(100, instances[2][0]);
+	EXPECT_EQ(2u, instances[3].size());
+	EXPECT_THROW(benchmark.range(0, 10), std::invalid_argument);
+}
+
+TEST(Runner_Test, T01_FixtureReport)
+{
+	microbench::registerFixture<CountingFixture_Sum_Benchmark>("CountingFixture/Args")->arg(5)->arg(6);
+	sFixtureSetUps = 0;
+
+	std::ostringstream json;
+	EXPECT_EQ(0, microbench::runBenchmarks(quickConfig("^CountingFixture/"), json));
+	const std::string report = json.str();
+	EXPECT_NE(std::string::npos, report.find("\"name\": \"CountingFixture/Sum\", \"iterations\": "));
+	EXPECT_NE(std::string::npos, report.find("\"name\": \"CountingFixture/Args/5\""));
+	EXPECT_NE(std::string::npos, report.find("\"name\": \"CountingFixture/Args/6\""));
+	EXPECT_NE(std::string::npos, report.find("\"repetitions\": 3, \"mean_ns\": "));
+	EXPECT_NE(std::string::npos, report.find("\"items_per_second\": "));
+	EXPECT_EQ(std::string::npos, report.find("BM_Failing"));
+	// calibration runs and three repetitions of every instance
+	EXPECT_GE(sFixtureSetUps, 3u * 4);
+}
+
+TEST(Runner_Test, T02_Errors)
+{
+	std::ostringstream json;
+	EXPECT_EQ(2, microbench::runBenchmarks(quickConfig("^BM_"), json));
+	EXPECT_NE(std::string::npos, json.str().find(
+			"{\"name\": \"BM_Failing\", \"error\": \"no \\\"input\\\"\"}"));
+	EXPECT_NE(std::string::npos, json.str().find(
+			"{\"name\": \"BM_NoLoop\", \"error\": \"benchmark did not loop over state\"}"));
+}
+
+TEST(Runner_Test, T03_FixedIterations)
+{
+	unsigned runs = 0;
+	std::uint64_t iterations = 0;
+	microbench::registerBenchmark("Fixed", [&](microbench::State& state) {
+		++runs;
+		iterations = state.iterations();
+		for (auto _ : state)
+			;
+	})->iterations(17)->repetitions(2);
+
+	std::ostringstream json;
+	EXPECT_EQ(0, microbench::runBenchmarks(quickConfig("^Fixed$"), json));
+	EXPECT_EQ(3u, runs);
+	EXPECT_EQ(17u, iterations);
+	EXPECT_NE(std::string::npos, json.str().find("\"iterations\": 17, \"repetitions\": 2,"));
+}
+
+TEST(Runner_Test, T04_PinToCpu)
+{
+	const int cpu = microbench::pinToCpu(-2);
+	EXPECT_GE(cpu, 0);
+	EXPECT_EQ(cpu, microbench::pinToCpu(cpu));
+	EXPECT_THROW(microbench::pinToCpu(100000), std::system_error);
+}
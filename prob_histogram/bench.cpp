@@ -0,0 +1,144 @@
+/*
+ * bench.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: Krzysztof Lasota
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "histogram.hpp"
+
+
+namespace {
+
+/// Size and timing of single generated row.
+struct Result
+{
+	std::string engine;
+	unsigned n;
+	double seconds;
+	std::size_t windowSize;
+};
+
+/// Generates histogram row with n bins, returns number of stored bins.
+typedef std::function<std::size_t(unsigned n)> Engine;
+
+struct EngineEntry
+{
+	const char* name;
+	Engine generate;
+	double complexity;    ///< time grows as n^complexity
+};
+
+/// Existing operator path: count bins, every bin stored.
+std::size_t operatorEngine(unsigned n)
+{
+	Histogram h(1, 1.0);
+	for (unsigned i = 1; i < n; ++i)
+		h += h << 1;
+	return h.windowSize();
+}
+
+/// Windowed probability row, only significant bins stored.
+std::size_t windowedEngine(unsigned n)
+{
+	Histogram h(1, 1.0);
+	h.setEpsilon(1e-12);
+	for (unsigned i = 1; i < n; ++i) {
+		h += h << 1;
+		h *= 0.5;
+	}
+	return h.windowSize();
+}
+
+/// Exact integer bins.
+std::size_t exactEngine(unsigned n)
+{
+	ExactHistogram h(1, BigUnsigned(1));
+	for (unsigned i = 1; i < n; ++i)
+		h += h << 1;
+	return h.windowSize();
+}
+
+void printUsage(const char* appl)
+{
+	std::cerr << "Usage: " << appl << " [-t SECONDS]\n"
+			"  -t SECONDS  skip row, which is expected to take longer (default 20)\n";
+}
+
+void printJson(const std::vector<Result>& results)
+{
+	std::printf("{\n  \"benchmark\": \"prob_histogram\",\n  \"results\": [");
+	for (std::size_t idx = 0; idx < results.size(); ++idx) {
+		const Result& r = results[idx];
+		std::printf("%s\n    {\"engine\": \"%s\", \"n\": %u, \"seconds\": %.6f,"
+				" \"window_size\": %zu, \"rows_per_second\": %.1f}",
+				(idx ? "," : ""), r.engine.c_str(), r.n, r.seconds,
+				r.windowSize, r.n / r.seconds);
+	}
+	std::printf("\n  ]\n}\n");
+}
+
+} // namespace
+
+
+int main(int argc, char** argv)
+{
+	double budget = 20.0;
+
+	int opt;
+	while ((opt = getopt(argc, argv, "t:h")) != -1) {
+		switch (opt) {
+		case 't':
+			budget = atof(optarg);
+			break;
+		default:
+			printUsage(argv[0]);
+			return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	const unsigned sizes[] = {1000, 10000, 100000, 1000000};
+	const EngineEntry engines[] = {
+		{"operator", operatorEngine, 2.0},
+		{"windowed", windowedEngine, 1.5},
+		{"exact", exactEngine, 3.0},
+	};
+
+	std::vector<Result> results;
+	for (const EngineEntry& engine : engines) {
+		double lastSeconds = 0.0;
+		unsigned lastN = 0;
+
+		for (const unsigned n : sizes) {
+			// extrapolate from previous row
+			const double scale = lastN ? std::pow(double(n) / lastN, engine.complexity) : 0.0;
+			if (lastSeconds * scale > budget) {
+				std::cerr << engine.name << ": skipping n=" << n << "\n";
+				break;
+			}
+
+			const auto start = std::chrono::steady_clock::now();
+			const std::size_t windowSize = engine.generate(n);
+			const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+			results.push_back({engine.name, n, elapsed.count(), windowSize});
+			lastSeconds = elapsed.count();
+			lastN = n;
+		}
+	}
+
+	printJson(results);
+
+	return 0;
+}
@@ -0,0 +1,165 @@
+/*
+ * big_unsigned.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: Krzysztof Lasota
+ */
+
+#include "big_unsigned.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace {
+
+/// Maximal number of additions, which may be accumulated in single limb.
+const unsigned MaxSlack = 32;
+
+/// Largest power of 10 fitting in 32-bit digit.
+const std::uint32_t DecimalChunk = 1000000000u;
+const unsigned DecimalChunkDigits = 9;
+
+} // namespace
+
+
+BigUnsigned::BigUnsigned(std::uint64_t value)
+ : mLimbs(), mSlack(0)
+{
+	while (value != 0) {
+		mLimbs.push_back(value & DigitMask);
+		value >>= DigitBits;
+	}
+}
+
+
+BigUnsigned& BigUnsigned::operator+=(const BigUnsigned& rhs)
+{
+	if (rhs.mSlack >= MaxSlack)
+		return *this += rhs.normalized();
+	if (mSlack >= MaxSlack)
+		normalize();
+
+	if (mLimbs.size() < rhs.mLimbs.size())
+		mLimbs.resize(rhs.mLimbs.size(), limb_type());
+
+	limb_type* dst = mLimbs.data();
+	const limb_type* src = rhs.mLimbs.data();
+	for (std::size_t idx = 0; idx < rhs.mLimbs.size(); ++idx)
+		dst[idx] += src[idx];
+
+	mSlack = std::max(mSlack, rhs.mSlack) + 1;
+
+	return *this;
+}
+
+
+bool BigUnsigned::operator==(const BigUnsigned& rhs) const
+{
+	return normalized().mLimbs == rhs.normalized().mLimbs;
+}
+
+
+std::size_t BigUnsigned::bitWidth() const
+{
+	const BigUnsigned n = normalized();
+	if (n.mLimbs.empty())
+		return 0;
+
+	std::size_t width = (n.mLimbs.size() - 1) * DigitBits;
+	for (limb_type top = n.mLimbs.back(); top != 0; top >>= 1)
+		++width;
+
+	return width;
+}
+
+
+double BigUnsigned::toDouble(std::size_t shift) const
+{
+	const BigUnsigned n = normalized();
+
+	// three most significant digits exceed double precision
+	const std::size_t first = (n.mLimbs.size() > 3) ? n.mLimbs.size() - 3 : 0;
+	double value = 0.0;
+	for (std::size_t idx = first; idx < n.mLimbs.size(); ++idx)
+		value += std::ldexp(static_cast<double>(n.mLimbs[idx]),
+				static_cast<int>(idx * DigitBits) - static_cast<int>(shift));
+
+	return value;
+}
+
+
+double BigUnsigned::ratio(const BigUnsigned& num, const BigUnsigned& den)
+{
+	const std::size_t width = std::max(num.bitWidth(), den.bitWidth());
+	const std::size_t shift = (width > 64) ? width - 64 : 0;
+
+	return num.toDouble(shift) / den.toDouble(shift);
+}
+
+
+std::string BigUnsigned::toString() const
+{
+	Container digits = normalized().mLimbs;
+	if (digits.empty())
+		return "0";
+
+	// Repeated long division by 10^9, chunks are collected least significant first.
+	std::vector<std::uint32_t> chunks;
+	while (!digits.empty()) {
+		limb_type rem = 0;
+		for (std::size_t idx = digits.size(); idx-- > 0; ) {
+			const limb_type cur = (rem << DigitBits) | digits[idx];
+			digits[idx] = cur / DecimalChunk;
+			rem = cur % DecimalChunk;
+		}
+		chunks.push_back(static_cast<std::uint32_t>(rem));
+
+		while (!digits.empty() && digits.back() == 0)
+			digits.pop_back();
+	}
+
+	std::string str = std::to_string(chunks.back());
+	for (std::size_t idx = chunks.size() - 1; idx-- > 0; ) {
+		const std::string chunk = std::to_string(chunks[idx]);
+		str.append(DecimalChunkDigits - chunk.size(), '0');
+		str += chunk;
+	}
+
+	return str;
+}
+
+
+std::ostream& operator<<(std::ostream& ostr, const BigUnsigned& v)
+{
+	return ostr << v.toString();
+}
+
+
+void BigUnsigned::normalize()
+{
+	if (mSlack == 0)
+		return;
+
+	limb_type carry = 0;
+	for (limb_type& limb : mLimbs) {
+		const limb_type sum = (limb & DigitMask) + carry;
+		carry = (limb >> DigitBits) + (sum >> DigitBits);
+		limb = sum & DigitMask;
+	}
+	for (; carry != 0; carry >>= DigitBits)
+		mLimbs.push_back(carry & DigitMask);
+
+	while (!mLimbs.empty() && mLimbs.back() == 0)
+		mLimbs.pop_back();
+
+	mSlack = 0;
+}
+
+
+BigUnsigned BigUnsigned::normalized() const
+{
+	BigUnsigned n(*this);
+	n.normalize();
+	return n;
+}
@@ -0,0 +1,71 @@
+/*
+ * big_unsigned.hpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: Krzysztof Lasota
+ */
+
+#ifndef BIG_UNSIGNED_HPP_
+#define BIG_UNSIGNED_HPP_
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+/**
+ * @brief Exact unsigned integer of arbitrary size.
+ *
+ * Value is kept as vector of 64-bit limbs (least significant first), every
+ * limb carrying one 32-bit digit. Upper half of limb is headroom for
+ * carry-save addition: operator+= adds limbs independently, without carry
+ * propagation, so loop has no dependency chain and vectorizes. Carries are
+ * propagated by normalize(), at most once per 32 consecutive additions.
+ */
+class BigUnsigned
+{
+	typedef  std::uint64_t  limb_type;
+	typedef  std::vector<limb_type>  Container;
+
+public:
+	BigUnsigned()
+	 : mLimbs(), mSlack(0)
+	{
+	}
+
+	BigUnsigned(std::uint64_t value);
+
+	BigUnsigned& operator+=(const BigUnsigned& rhs);
+
+	bool operator==(const BigUnsigned& rhs) const;
+	bool operator!=(const BigUnsigned& rhs) const { return !(*this == rhs); }
+
+	/// Number of significant bits (0 for zero).
+	std::size_t bitWidth() const;
+
+	/// Approximation of value * 2^-shift.
+	double toDouble(std::size_t shift = 0) const;
+
+	/// Approximation of num / den, valid also when both exceed double range.
+	static double ratio(const BigUnsigned& num, const BigUnsigned& den);
+
+	/// Decimal representation.
+	std::string toString() const;
+
+	friend std::ostream& operator<<(std::ostream& ostr, const BigUnsigned& v);
+
+private:
+	static const unsigned DigitBits = 32;
+	static const limb_type DigitMask = (limb_type(1) << DigitBits) - 1;
+
+	/// Propagate carries, so every limb holds value below 2^DigitBits.
+	void normalize();
+	BigUnsigned normalized() const;
+
+	Container mLimbs;
+	/// Every limb is below 2^(DigitBits + mSlack).
+	unsigned mSlack;
+};
+
+#endif /* BIG_UNSIGNED_HPP_ */
@@ -0,0 +1,78 @@
+/*
+ * big_unsigned_test.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: Krzysztof Lasota
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <sstream>
+
+#include "big_unsigned.hpp"
+
+
+TEST(BigUnsigned_Test, T01_Zero)
+{
+	EXPECT_EQ("0", BigUnsigned().toString());
+	EXPECT_EQ(BigUnsigned(), BigUnsigned(0));
+	EXPECT_EQ(0u, BigUnsigned().bitWidth());
+}
+
+TEST(BigUnsigned_Test, T02_ToString)
+{
+	EXPECT_EQ("18446744073709551615", BigUnsigned(UINT64_MAX).toString());
+	EXPECT_EQ("1000000000", BigUnsigned(1000000000u).toString());
+	EXPECT_EQ("4294967296", BigUnsigned(std::uint64_t(1) << 32).toString());
+}
+
+TEST(BigUnsigned_Test, T03_AddCarriesBetweenDigits)
+{
+	BigUnsigned v(0xFFFFFFFFu);
+	v += BigUnsigned(1);
+
+	EXPECT_EQ(BigUnsigned(std::uint64_t(1) << 32), v);
+	EXPECT_EQ(33u, v.bitWidth());
+}
+
+TEST(BigUnsigned_Test, T04_DoublingPastSlackLimit)
+{
+	// 200 doublings exceed carry-save headroom several times
+	BigUnsigned v(1);
+	for (unsigned i = 0; i < 200; ++i)
+		v += BigUnsigned(v);
+
+	EXPECT_EQ(201u, v.bitWidth());
+	EXPECT_EQ("1606938044258990275541962092341162602522202993782792835301376", v.toString());
+}
+
+TEST(BigUnsigned_Test, T05_EqualityIgnoresRepresentation)
+{
+	BigUnsigned carrySaved(0xFFFFFFFFu);
+	carrySaved += BigUnsigned(0xFFFFFFFFu);
+
+	EXPECT_EQ(BigUnsigned(std::uint64_t(0xFFFFFFFFu) * 2), carrySaved);
+	EXPECT_NE(BigUnsigned(7), carrySaved);
+}
+
+TEST(BigUnsigned_Test, T06_RatioOutOfDoubleRange)
+{
+	BigUnsigned num(3);
+	BigUnsigned den(4);
+	for (unsigned i = 0; i < 2000; ++i) {
+		num += BigUnsigned(num);
+		den += BigUnsigned(den);
+	}
+
+	EXPECT_DOUBLE_EQ(0.75, BigUnsigned::ratio(num, den));
+	EXPECT_DOUBLE_EQ(0.75, BigUnsigned(3).toDouble(2));
+}
+
+TEST(BigUnsigned_Test, T07_StreamOutput)
+{
+	std::ostringstream sout;
+	sout << BigUnsigned(12345);
+
+	EXPECT_EQ("12345", sout.str());
+}
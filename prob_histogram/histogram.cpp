@@ -10,47 +10,289 @@
 #include <algorithm>
 #include <iterator>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
-Histogram::size_type Histogram::size() const
+
+namespace {
+
+double binRatio(double bin, double total)
+{
+	return bin / total;
+}
+
+double binRatio(const BigUnsigned& bin, const BigUnsigned& total)
+{
+	return BigUnsigned::ratio(bin, total);
+}
+
+template <typename T>
+void inclusiveScan(T* bins, std::size_t count)
+{
+	for (std::size_t idx = 1; idx < count; ++idx)
+		bins[idx] += bins[idx - 1];
+}
+
+#if defined(__SSE2__)
+/**
+ * Scan of 4 bins per iteration: bins are scanned locally within both
+ * registers, then carry of preceding bins is added. Loop carried dependency
+ * is one add and one shuffle per 4 bins instead of 4 adds.
+ */
+void inclusiveScan(double* bins, std::size_t count)
+{
+	__m128d carry = _mm_setzero_pd();
+
+	std::size_t idx = 0;
+	for (; idx + 4 <= count; idx += 4) {
+		__m128d lo = _mm_loadu_pd(bins + idx);       // a, b
+		__m128d hi = _mm_loadu_pd(bins + idx + 2);   // c, d
+
+		lo = _mm_add_pd(lo, _mm_unpacklo_pd(_mm_setzero_pd(), lo));   // a, a+b
+		hi = _mm_add_pd(hi, _mm_unpacklo_pd(_mm_setzero_pd(), hi));   // c, c+d
+		hi = _mm_add_pd(hi, _mm_unpackhi_pd(lo, lo));                 // a+b+c, a+b+c+d
+
+		lo = _mm_add_pd(lo, carry);
+		hi = _mm_add_pd(hi, carry);
+		carry = _mm_unpackhi_pd(hi, hi);
+
+		_mm_storeu_pd(bins + idx, lo);
+		_mm_storeu_pd(bins + idx + 2, hi);
+	}
+
+	double sum = _mm_cvtsd_f64(carry);
+	for (; idx < count; ++idx) {
+		sum += bins[idx];
+		bins[idx] = sum;
+	}
+}
+#else
+void inclusiveScan(double* bins, std::size_t count)
+{
+	inclusiveScan<double>(bins, count);
+}
+#endif
+
+} // namespace
+
+
+template <typename T>
+typename BasicHistogram<T>::size_type BasicHistogram<T>::size() const
+{
+	return mSize;
+}
+
+
+template <typename T>
+typename BasicHistogram<T>::size_type BasicHistogram<T>::windowOffset() const
+{
+	return mOffset;
+}
+
+
+template <typename T>
+typename BasicHistogram<T>::size_type BasicHistogram<T>::windowSize() const
 {
 	return mContainer.size();
 }
 
 
-Histogram& Histogram::operator+=(const Histogram& rhs)
+template <typename T>
+bool BasicHistogram<T>::isWindowed() const
+{
+	return mOffset != 0 || mContainer.size() != mSize;
+}
+
+
+template <typename T>
+const typename BasicHistogram<T>::value_type* BasicHistogram<T>::data() const
+{
+	return mContainer.data();
+}
+
+
+template <typename T>
+typename BasicHistogram<T>::const_iterator BasicHistogram<T>::begin() const
+{
+	return mContainer.begin();
+}
+
+
+template <typename T>
+typename BasicHistogram<T>::const_iterator BasicHistogram<T>::end() const
+{
+	return mContainer.end();
+}
+
+
+template <typename T>
+double BasicHistogram<T>::epsilon() const
+{
+	return mEpsilon;
+}
+
+
+template <typename T>
+void BasicHistogram<T>::setEpsilon(double epsilon_)
+{
+	mEpsilon = epsilon_;
+	trim();
+}
+
+
+template <typename T>
+BasicHistogram<T> BasicHistogram<T>::prefixSum() const
 {
-	if (mContainer.size() < rhs.mContainer.size())
-		mContainer.resize(rhs.mContainer.size(), value_type());
+	BasicHistogram ret(*this);
+	ret.mSize = mOffset + mContainer.size();
+	ret.mEpsilon = 0.0;
+	inclusiveScan(ret.mContainer.data(), ret.mContainer.size());
 
+	return ret;
+}
+
+
+template <typename T>
+typename BasicHistogram<T>::size_type BasicHistogram<T>::quantile(double p) const
+{
+	return quantiles(std::vector<double>(1, p)).front();
+}
+
+
+template <typename T>
+std::vector<typename BasicHistogram<T>::size_type>
+BasicHistogram<T>::quantiles(const std::vector<double>& ps) const
+{
+	std::vector<size_type> ret;
+	ret.reserve(ps.size());
+
+	if (mContainer.empty()) {
+		ret.assign(ps.size(), mOffset);
+		return ret;
+	}
+
+	const BasicHistogram cdf = prefixSum();
+	const value_type& total = cdf.mContainer.back();
+
+	for (const double p : ps) {
+		auto it = std::lower_bound(cdf.mContainer.begin(), cdf.mContainer.end(), p,
+				[&total](const value_type& bin, double p_) { return binRatio(bin, total) < p_; });
+		if (it == cdf.mContainer.end())
+			--it;
+		ret.push_back(mOffset + (it - cdf.mContainer.begin()));
+	}
+
+	return ret;
+}
+
+
+template <typename T>
+BasicHistogram<T>& BasicHistogram<T>::operator+=(const BasicHistogram& rhs)
+{
+	mSize = std::max(mSize, rhs.mSize);
+
+	if (rhs.mContainer.empty())
+		return *this;
+
+	if (mContainer.empty()) {
+		mContainer = rhs.mContainer;
+		mOffset = rhs.mOffset;
+		trim();
+		return *this;
+	}
+
+	// extend window to cover both windows
+	const size_type first = std::min(mOffset, rhs.mOffset);
+	const size_type last = std::max(mOffset + mContainer.size(),
+			rhs.mOffset + rhs.mContainer.size());
+
+	if (first < mOffset)
+		mContainer.insert(mContainer.begin(), mOffset - first, value_type());
+	if (mContainer.size() < last - first)
+		mContainer.resize(last - first, value_type());
+	mOffset = first;
+
+	const size_type shift = rhs.mOffset - mOffset;
 	for (size_type idx = 0; idx < rhs.mContainer.size(); ++idx)
-			mContainer[idx] += rhs.mContainer[idx];
+			mContainer[shift + idx] += rhs.mContainer[idx];
+
+	trim();
 
 	return *this;
 }
 
 
-Histogram Histogram::operator<<(const size_type offset) const
+template <typename T>
+BasicHistogram<T> BasicHistogram<T>::operator<<(const size_type offset) const
 {
-	Histogram ret(0);
-	auto& container = ret.mContainer;
-
-	container.resize(mContainer.size() + offset, value_type());
-	std::copy(mContainer.rbegin(), mContainer.rend(), container.rbegin());
+	// shifting keeps proportions of bins, so no trimming is needed
+	BasicHistogram ret(*this);
+	ret.mSize += offset;
+	ret.mOffset += offset;
 
 	return ret;
 }
 
 
-std::ostream& operator<<(std::ostream& ostr, const Histogram& h)
+template <typename T>
+template <typename U>
+BasicHistogram<T>& BasicHistogram<T>::operator*=(const U& factor)
+{
+	for (value_type& bin : mContainer)
+		bin *= factor;
+
+	return *this;
+}
+
+
+template <typename T>
+void BasicHistogram<T>::trim()
+{
+	if (!(mEpsilon > 0.0) || mContainer.empty())
+		return;
+
+	value_type total = value_type();
+	for (const value_type& bin : mContainer)
+		total += bin;
+
+	size_type first = 0;
+	size_type last = mContainer.size();
+	while (last - first > 1 && binRatio(mContainer[first], total) < mEpsilon)
+		++first;
+	while (last - first > 1 && binRatio(mContainer[last - 1], total) < mEpsilon)
+		--last;
+
+	mContainer.erase(mContainer.begin() + last, mContainer.end());
+	mContainer.erase(mContainer.begin(), mContainer.begin() + first);
+	mOffset += first;
+}
+
+
+template <typename T>
+std::ostream& operator<<(std::ostream& ostr, const BasicHistogram<T>& h)
 {
 	const char* tagOpen = "";
 	const char* tagClose = "";
 	const char* tagSeparator = "\n";
 
+	typedef typename BasicHistogram<T>::value_type value_type;
+	std::ostream_iterator<value_type> out(ostr, tagSeparator);
+
+	// bins outside of window are printed as zeros
 	ostr << tagOpen;
-	std::copy(h.mContainer.begin(), h.mContainer.end(),
-			std::ostream_iterator<Histogram::value_type>(ostr, tagSeparator));
+	out = std::fill_n(out, h.mOffset, value_type());
+	out = std::copy(h.mContainer.begin(), h.mContainer.end(), out);
+	std::fill_n(out, h.mSize - h.mOffset - h.mContainer.size(), value_type());
 	ostr << tagClose;
 
 	return ostr;
 }
+
+
+template class BasicHistogram<double>;
+template Histogram& Histogram::operator*=(const double&);
+template std::ostream& operator<<(std::ostream&, const BasicHistogram<double>&);
+
+template class BasicHistogram<BigUnsigned>;
+template std::ostream& operator<<(std::ostream&, const BasicHistogram<BigUnsigned>&);
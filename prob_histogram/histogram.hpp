@@ -11,29 +11,98 @@
 #include <ostream>
 #include <vector>
 
+#include "big_unsigned.hpp"
 
-class Histogram
+
+/**
+ * @brief Histogram with bins of type T.
+ *
+ * Only contiguous window of bins is stored, all bins outside of it are zero.
+ * With epsilon set (windowed mode) bins on both ends of window, which hold
+ * less than epsilon of total mass, are trimmed after every operation,
+ * so memory and time scale with significant mass instead of size().
+ *
+ * Implementation is instantiated explicitly (see histogram.cpp)
+ * for `double` and BigUnsigned.
+ */
+template <typename T>
+class BasicHistogram
 {
-	typedef  std::vector<double>  Container;
+	typedef  std::vector<T>  Container;
 
 public:
-	typedef  double  value_type;
+	typedef  T  value_type;
 	typedef  typename Container::size_type  size_type;
+	typedef  typename Container::const_iterator  const_iterator;
 
 	explicit
-	Histogram(size_type size_ = size_type(1), const value_type& seed_ = value_type())
-	 : mContainer(size_, seed_)
+	BasicHistogram(size_type size_ = size_type(1), const value_type& seed_ = value_type())
+	 : mContainer(size_, seed_), mSize(size_), mOffset(0), mEpsilon(0.0)
 	{
 	}
 
+	/// Number of bins, including not stored zero bins.
 	size_type size() const;
 
-	Histogram& operator+=(const Histogram& rhs);
-	Histogram operator<<(const size_type offset) const;
-	friend std::ostream& operator<<(std::ostream& ostr, const Histogram& h);
+	/// Index of first stored bin.
+	size_type windowOffset() const;
+	/// Number of stored bins.
+	size_type windowSize() const;
+	/// True when some bins are not stored.
+	bool isWindowed() const;
+
+	/// Stored bins, starting with bin windowOffset().
+	const value_type* data() const;
+	const_iterator begin() const;
+	const_iterator end() const;
+
+	/// Fraction of total mass below which bins are trimmed (0 disables trimming).
+	double epsilon() const;
+	void setEpsilon(double epsilon_);
+
+	/**
+	 * @brief Cumulative histogram (inclusive prefix sums of bins).
+	 *
+	 * Result ends with last stored bin, as all further sums are equal to it,
+	 * and has trimming disabled.
+	 */
+	BasicHistogram prefixSum() const;
+
+	/**
+	 * @brief Index of first bin, where cumulative mass reaches p of total mass.
+	 * @param p  probability from range [0, 1]
+	 */
+	size_type quantile(double p) const;
+
+	/// Quantiles for all ps, computed with single prefixSum() pass.
+	std::vector<size_type> quantiles(const std::vector<double>& ps) const;
+
+	BasicHistogram& operator+=(const BasicHistogram& rhs);
+	BasicHistogram operator<<(const size_type offset) const;
+
+	/// Scale every bin (instantiated only for types supporting it).
+	template <typename U>
+	BasicHistogram& operator*=(const U& factor);
+
+	template <typename U>
+	friend std::ostream& operator<<(std::ostream& ostr, const BasicHistogram<U>& h);
 
 private:
+	void trim();
+
 	Container mContainer;
+	size_type mSize;
+	size_type mOffset;
+	double mEpsilon;
 };
 
+template <typename T>
+std::ostream& operator<<(std::ostream& ostr, const BasicHistogram<T>& h);
+
+
+typedef  BasicHistogram<double>  Histogram;
+
+/// Histogram with exact integer bins, free from double overflow and rounding.
+typedef  BasicHistogram<BigUnsigned>  ExactHistogram;
+
 #endif /* HISTOGRAM_HPP_ */
@@ -0,0 +1,225 @@
+/*
+ * histogram_test.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: Krzysztof Lasota
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <sstream>
+#include <vector>
+
+#include "histogram.hpp"
+
+
+namespace {
+
+template <typename H>
+H binomialRow(unsigned n, double epsilon = 0.0)
+{
+	H h(1, typename H::value_type(1));
+	h.setEpsilon(epsilon);
+	for (unsigned i = 1; i < n; ++i)
+		h += h << 1;
+	return h;
+}
+
+template <typename H>
+std::vector<typename H::value_type> bins(const H& h)
+{
+	return std::vector<typename H::value_type>(h.begin(), h.end());
+}
+
+std::uint64_t binomial(unsigned n, unsigned k)
+{
+	std::uint64_t ret = 1;
+	for (unsigned i = 1; i <= k; ++i)
+		ret = ret * (n - k + i) / i;
+	return ret;
+}
+
+} // namespace
+
+
+TEST(Histogram_Test, T01_Construction)
+{
+	Histogram h(3, 2.0);
+
+	EXPECT_EQ(3u, h.size());
+	EXPECT_EQ(0u, h.windowOffset());
+	EXPECT_EQ(3u, h.windowSize());
+	EXPECT_FALSE(h.isWindowed());
+	EXPECT_EQ(std::vector<double>({2.0, 2.0, 2.0}), bins(h));
+}
+
+TEST(Histogram_Test, T02_ShiftKeepsBinsAndMovesWindow)
+{
+	Histogram h(2, 1.0);
+	const Histogram shifted = h << 3;
+
+	EXPECT_EQ(5u, shifted.size());
+	EXPECT_EQ(3u, shifted.windowOffset());
+	EXPECT_TRUE(shifted.isWindowed());
+	EXPECT_EQ(std::vector<double>({1.0, 1.0}), bins(shifted));
+}
+
+TEST(Histogram_Test, T03_AddExtendsToLongerOperand)
+{
+	Histogram h(2, 1.0);
+	h += Histogram(4, 2.0);
+
+	EXPECT_EQ(4u, h.size());
+	EXPECT_EQ(std::vector<double>({3.0, 3.0, 2.0, 2.0}), bins(h));
+}
+
+TEST(Histogram_Test, T04_AddShiftedFillsGap)
+{
+	Histogram h(1, 1.0);
+	h += h << 2;
+
+	EXPECT_EQ(3u, h.size());
+	EXPECT_FALSE(h.isWindowed());
+	EXPECT_EQ(std::vector<double>({1.0, 0.0, 1.0}), bins(h));
+}
+
+TEST(Histogram_Test, T05_PascalRow)
+{
+	const Histogram h = binomialRow<Histogram>(11);
+
+	ASSERT_EQ(11u, h.size());
+	for (unsigned k = 0; k < h.size(); ++k)
+		EXPECT_EQ(double(binomial(10, k)), h.data()[k]) << "  k is: " << k;
+}
+
+TEST(Histogram_Test, T06_StreamPrintsZerosOutsideWindow)
+{
+	std::ostringstream sout;
+	sout << (Histogram(2, 1.0) << 1);
+
+	EXPECT_EQ("0\n1\n1\n", sout.str());
+}
+
+TEST(Histogram_Test, T07_ScaleBins)
+{
+	Histogram h(2, 3.0);
+	h *= 0.5;
+
+	EXPECT_EQ(std::vector<double>({1.5, 1.5}), bins(h));
+}
+
+
+TEST(WindowedHistogram_Test, T01_TrimsNegligibleTails)
+{
+	const Histogram full = binomialRow<Histogram>(41);
+	const Histogram windowed = binomialRow<Histogram>(41, 1e-3);
+
+	EXPECT_EQ(full.size(), windowed.size());
+	EXPECT_TRUE(windowed.isWindowed());
+	EXPECT_LT(windowed.windowSize(), full.windowSize());
+
+	double fullTotal = 0.0;
+	for (const double bin : full)
+		fullTotal += bin;
+	double total = 0.0;
+	for (const double bin : windowed)
+		total += bin;
+
+	// trimmed mass is lost, so stored bins may only be underestimated
+	EXPECT_GT(total / fullTotal, 0.95);
+	for (unsigned k = 0; k < windowed.windowSize(); ++k) {
+		const unsigned idx = windowed.windowOffset() + k;
+		EXPECT_LE(windowed.data()[k], full.data()[idx]) << "  idx is: " << idx;
+		EXPECT_GE(windowed.data()[k] / total, 1e-3) << "  idx is: " << idx;
+	}
+}
+
+TEST(WindowedHistogram_Test, T02_WindowIsSymmetric)
+{
+	const Histogram h = binomialRow<Histogram>(101, 1e-6);
+
+	EXPECT_EQ(h.size() - h.windowOffset() - h.windowSize(), h.windowOffset());
+}
+
+TEST(WindowedHistogram_Test, T03_ZeroEpsilonKeepsAllBins)
+{
+	const Histogram h = binomialRow<Histogram>(101, 0.0);
+
+	EXPECT_FALSE(h.isWindowed());
+}
+
+
+TEST(HistogramPrefixSum_Test, T01_CumulativeSums)
+{
+	const Histogram cdf = binomialRow<Histogram>(5).prefixSum();
+
+	EXPECT_EQ(std::vector<double>({1.0, 5.0, 11.0, 15.0, 16.0}), bins(cdf));
+}
+
+TEST(HistogramPrefixSum_Test, T02_LongScanMatchesSequentialSum)
+{
+	std::vector<double> expected;
+	Histogram h(1, 1.0);
+	for (unsigned i = 0; i < 37; ++i)
+		h += Histogram(i + 2, 0.5 + i);
+
+	double sum = 0.0;
+	for (const double bin : h)
+		expected.push_back(sum += bin);
+
+	EXPECT_EQ(expected, bins(h.prefixSum()));
+}
+
+TEST(HistogramPrefixSum_Test, T03_WindowedEndsWithLastStoredBin)
+{
+	const Histogram h = binomialRow<Histogram>(41, 1e-3);
+	const Histogram cdf = h.prefixSum();
+
+	EXPECT_EQ(h.windowOffset(), cdf.windowOffset());
+	EXPECT_EQ(h.windowOffset() + h.windowSize(), cdf.size());
+	EXPECT_EQ(0.0, cdf.epsilon());
+}
+
+TEST(HistogramQuantile_Test, T01_Median)
+{
+	EXPECT_EQ(50u, binomialRow<Histogram>(101).quantile(0.5));
+	EXPECT_EQ(50u, binomialRow<ExactHistogram>(101).quantile(0.5));
+}
+
+TEST(HistogramQuantile_Test, T02_Bounds)
+{
+	const Histogram h = binomialRow<Histogram>(5);
+
+	EXPECT_EQ(0u, h.quantile(0.0));
+	EXPECT_EQ(4u, h.quantile(1.0));
+}
+
+TEST(HistogramQuantile_Test, T03_ManyQuantilesInOnePass)
+{
+	// cdf: 1/16, 5/16, 11/16, 15/16, 16/16
+	const Histogram h = binomialRow<Histogram>(5);
+	const std::vector<Histogram::size_type> expected({0u, 1u, 2u, 3u, 4u});
+
+	EXPECT_EQ(expected, h.quantiles({0.05, 0.3, 0.5, 0.9, 0.99}));
+}
+
+
+TEST(ExactHistogram_Test, T01_PascalRowMatchesDouble)
+{
+	const ExactHistogram exact = binomialRow<ExactHistogram>(60);
+
+	ASSERT_EQ(60u, exact.size());
+	for (unsigned k = 0; k < exact.size(); ++k)
+		EXPECT_EQ(BigUnsigned(binomial(59, k)), exact.data()[k]) << "  k is: " << k;
+}
+
+TEST(ExactHistogram_Test, T02_ExactPastDoubleRange)
+{
+	// C(1100, 1) and C(1100, 2) are exact, middle bins exceed double range
+	const ExactHistogram exact = binomialRow<ExactHistogram>(1101);
+
+	EXPECT_EQ("1100", exact.data()[1].toString());
+	EXPECT_EQ("604450", exact.data()[2].toString());
+	EXPECT_GT(exact.data()[550].bitWidth(), 1024u);
+}
@@ -0,0 +1,222 @@
+/*
+ * histogram_writer.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: Krzysztof Lasota
+ */
+
+#include "histogram_writer.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+
+namespace {
+
+/// Longest "%.6g" representation of double, including separator.
+const std::size_t MaxTextValueSize = 32;
+
+/// Precision used by std::ostream by default.
+const int TextPrecision = 6;
+
+/// Longest bin index, including separator.
+const std::size_t MaxTextIndexSize = 24;
+
+const char TextSeparator = '\n';
+const char TextIndexSeparator = ' ';
+
+bool isLittleEndianHost()
+{
+	return __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+}
+
+} // namespace
+
+
+constexpr char HistogramFileHeader::Magic[8];
+
+
+HistogramWriter::HistogramWriter(std::FILE* file_, Format format_,
+		std::size_t bufferSize_)
+ : mFile(file_)
+ , mFormat(format_)
+ , mBuffer(std::max(bufferSize_, sizeof(HistogramFileHeader) + MaxTextIndexSize + MaxTextValueSize))
+ , mUsed(0)
+{
+}
+
+
+HistogramWriter::~HistogramWriter()
+{
+	try {
+		flush();
+	}
+	catch (const std::exception&) {
+		// destructor must not throw, call flush() explicitly to handle errors
+	}
+}
+
+
+HistogramWriter& HistogramWriter::write(const Histogram& h)
+{
+	if (mFormat == Format::Binary)
+		writeBinary(h);
+	else
+		writeText(h);
+
+	return *this;
+}
+
+
+HistogramWriter& HistogramWriter::write(const ExactHistogram& h)
+{
+	if (mFormat == Format::Binary)
+		throw std::logic_error("HistogramWriter: binary format supports only double bins");
+
+	const bool indexed = (mFormat == Format::IndexedText);
+	if (!indexed)
+		writeTextZeros(h.windowOffset());
+
+	std::size_t idx = h.windowOffset();
+	for (const ExactHistogram::value_type& value : h) {
+		if (indexed)
+			putIndex(idx++);
+
+		const std::string str = value.toString();
+		write(str.data(), str.size());
+		write(&TextSeparator, 1);
+	}
+
+	if (!indexed)
+		writeTextZeros(h.size() - h.windowOffset() - h.windowSize());
+
+	return *this;
+}
+
+
+HistogramWriter& HistogramWriter::write(const char* str, std::size_t len)
+{
+	while (len > 0) {
+		reserve(1);
+		const std::size_t chunk = std::min(len, mBuffer.size() - mUsed);
+		std::memcpy(mBuffer.data() + mUsed, str, chunk);
+		mUsed += chunk;
+		str += chunk;
+		len -= chunk;
+	}
+
+	return *this;
+}
+
+
+void HistogramWriter::flush()
+{
+	if (mUsed > 0 && std::fwrite(mBuffer.data(), 1, mUsed, mFile) != mUsed)
+		throw std::runtime_error("HistogramWriter: write failed");
+	mUsed = 0;
+
+	if (std::fflush(mFile) != 0)
+		throw std::runtime_error("HistogramWriter: flush failed");
+}
+
+
+void HistogramWriter::writeText(const Histogram& h)
+{
+	char* const bufferEnd = mBuffer.data() + mBuffer.size();
+	const bool indexed = (mFormat == Format::IndexedText);
+	if (!indexed)
+		writeTextZeros(h.windowOffset());
+
+	std::size_t idx = h.windowOffset();
+	for (const Histogram::value_type value : h) {
+		reserve(MaxTextIndexSize + MaxTextValueSize);
+		if (indexed)
+			putIndex(idx++);
+
+		char* pos = mBuffer.data() + mUsed;
+		pos = std::to_chars(pos, bufferEnd, value,
+				std::chars_format::general, TextPrecision).ptr;
+		*pos++ = TextSeparator;
+		mUsed = pos - mBuffer.data();
+	}
+
+	if (!indexed)
+		writeTextZeros(h.size() - h.windowOffset() - h.windowSize());
+}
+
+
+void HistogramWriter::writeTextZeros(std::size_t count)
+{
+	const char zero[] = {'0', TextSeparator};
+	for (std::size_t i = 0; i < count; ++i)
+		write(zero, sizeof(zero));
+}
+
+
+void HistogramWriter::writeBinary(const Histogram& h)
+{
+	static_assert(sizeof(Histogram::value_type) == sizeof(std::uint64_t),
+			"binary format stores 64-bit IEEE-754 bins");
+
+	reserve(sizeof(HistogramFileHeader));
+	write(HistogramFileHeader::Magic, sizeof(HistogramFileHeader::Magic));
+	putLE32(sizeof(Histogram::value_type));
+	putLE32(0);
+	putLE64(h.size());
+	putLE64(h.windowOffset());
+	putLE64(h.windowSize());
+
+	if (isLittleEndianHost()) {
+		// bins are already in file layout, skip copying through buffer
+		flush();
+		if (std::fwrite(h.data(), sizeof(Histogram::value_type), h.windowSize(), mFile) != h.windowSize())
+			throw std::runtime_error("HistogramWriter: write failed");
+		return;
+	}
+
+	for (const Histogram::value_type value : h) {
+		std::uint64_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		putLE64(bits);
+	}
+}
+
+
+void HistogramWriter::reserve(std::size_t len)
+{
+	if (mBuffer.size() - mUsed < len) {
+		if (mUsed > 0 && std::fwrite(mBuffer.data(), 1, mUsed, mFile) != mUsed)
+			throw std::runtime_error("HistogramWriter: write failed");
+		mUsed = 0;
+	}
+}
+
+
+void HistogramWriter::putIndex(std::size_t idx)
+{
+	reserve(MaxTextIndexSize);
+
+	char* pos = mBuffer.data() + mUsed;
+	pos = std::to_chars(pos, mBuffer.data() + mBuffer.size(), idx).ptr;
+	*pos++ = TextIndexSeparator;
+	mUsed = pos - mBuffer.data();
+}
+
+
+void HistogramWriter::putLE32(std::uint32_t value)
+{
+	reserve(sizeof(value));
+	for (std::size_t byte = 0; byte < sizeof(value); ++byte)
+		mBuffer[mUsed++] = static_cast<char>(value >> (8 * byte));
+}
+
+
+void HistogramWriter::putLE64(std::uint64_t value)
+{
+	reserve(sizeof(value));
+	for (std::size_t byte = 0; byte < sizeof(value); ++byte)
+		mBuffer[mUsed++] = static_cast<char>(value >> (8 * byte));
+}
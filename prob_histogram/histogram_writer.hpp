@@ -0,0 +1,111 @@
+/*
+ * histogram_writer.hpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: Krzysztof Lasota
+ */
+
+#ifndef HISTOGRAM_WRITER_HPP_
+#define HISTOGRAM_WRITER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "histogram.hpp"
+
+
+/**
+ * @brief Header of binary histogram file.
+ *
+ * File layout: header followed by `count` raw little-endian IEEE-754 doubles.
+ * Bins outside of stored window (offset ... offset + count - 1) of `size`
+ * bins are zero. Header size is a multiple of 8, so mapped bins are
+ * naturally aligned. All header fields are stored little-endian.
+ */
+struct HistogramFileHeader
+{
+	static constexpr char Magic[8] = {'P','H','I','S','T','\0','\0','2'};
+
+	char          magic[8];     ///< HistogramFileHeader::Magic
+	std::uint32_t valueSize;    ///< size of single bin in bytes
+	std::uint32_t reserved;     ///< always 0
+	std::uint64_t size;         ///< number of all bins of histogram (see BasicHistogram::size())
+	std::uint64_t offset;       ///< index of first bin stored in file (see BasicHistogram::windowOffset())
+	std::uint64_t count;        ///< number of bins stored in file (see BasicHistogram::windowSize())
+};
+static_assert(sizeof(HistogramFileHeader) == 40, "unexpected header padding");
+
+
+/**
+ * @brief Buffered writer of histogram bins.
+ *
+ * Formats bins with std::to_chars into large reusable buffer and passes
+ * whole buffer to fwrite, omitting std::ostream formatting machinery.
+ * Text format is identical to `operator<<(std::ostream&, const Histogram&)`,
+ * bins outside of window are written as zeros. Indexed text format writes
+ * "index value" lines of stored bins only, whether histogram is windowed
+ * (see BasicHistogram::isWindowed()) or not.
+ */
+class HistogramWriter
+{
+public:
+	enum class Format
+	{
+		Text,           ///< one bin per line, "%g" notation
+		IndexedText,    ///< "index value" per stored bin
+		Binary          ///< HistogramFileHeader followed by raw bins
+	};
+
+	static constexpr std::size_t DefaultBufferSize = std::size_t(1) << 20;
+
+	explicit
+	HistogramWriter(std::FILE* file_, Format format_ = Format::Text,
+			std::size_t bufferSize_ = DefaultBufferSize);
+	~HistogramWriter();
+
+	HistogramWriter(const HistogramWriter&) = delete;
+	HistogramWriter& operator=(const HistogramWriter&) = delete;
+
+	/**
+	 * @brief Write all bins of histogram.
+	 * @throw std::runtime_error when underlying file write fails
+	 */
+	HistogramWriter& write(const Histogram& h);
+
+	/**
+	 * @brief Write all bins of exact histogram as decimal numbers.
+	 * @throw std::logic_error when writer uses binary format
+	 * @throw std::runtime_error when underlying file write fails
+	 */
+	HistogramWriter& write(const ExactHistogram& h);
+
+	/**
+	 * @brief Write raw characters (only meaningful in text format).
+	 */
+	HistogramWriter& write(const char* str, std::size_t len);
+
+	/**
+	 * @brief Pass buffered data to underlying file.
+	 * @throw std::runtime_error when underlying file write fails
+	 */
+	void flush();
+
+private:
+	void writeText(const Histogram& h);
+	void writeTextZeros(std::size_t count);
+	void writeBinary(const Histogram& h);
+
+	void reserve(std::size_t len);
+	void putIndex(std::size_t idx);
+	void putLE32(std::uint32_t value);
+	void putLE64(std::uint64_t value);
+
+	std::FILE* mFile;
+	Format mFormat;
+	std::vector<char> mBuffer;
+	std::size_t mUsed;
+};
+
+#endif /* HISTOGRAM_WRITER_HPP_ */
@@ -0,0 +1,120 @@
+/*
+ * histogram_writer_test.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: Krzysztof Lasota
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+
+#include "histogram_writer.hpp"
+
+
+namespace {
+
+/// Everything written to file by writer with given format.
+template <typename H>
+std::string written(const H& h, HistogramWriter::Format format)
+{
+	std::FILE* file = std::tmpfile();
+	{
+		HistogramWriter writer(file, format);
+		writer.write(h);
+		writer.flush();
+	}
+
+	std::string content;
+	std::rewind(file);
+	char chunk[256];
+	std::size_t len;
+	while ((len = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+		content.append(chunk, len);
+	std::fclose(file);
+	return content;
+}
+
+/// Histogram {0, 0, 1, 2, 1}, stored window is 2 ... 4.
+Histogram windowed()
+{
+	Histogram h(1, 1.0);
+	h += h << 1;
+	h += h << 1;
+	return h << 2;
+}
+
+std::uint64_t readLE64(const std::string& data, std::size_t pos)
+{
+	std::uint64_t value = 0;
+	for (std::size_t byte = 0; byte < sizeof(value); ++byte)
+		value |= std::uint64_t(static_cast<unsigned char>(data[pos + byte])) << (8 * byte);
+	return value;
+}
+
+} // namespace
+
+
+TEST(HistogramWriter_Test, T01_TextMatchesStreamWithZerosOutsideWindow)
+{
+	const Histogram h = windowed();
+	ASSERT_TRUE(h.isWindowed());
+
+	std::ostringstream ostr;
+	ostr << h;
+	EXPECT_EQ(ostr.str(), written(h, HistogramWriter::Format::Text));
+	EXPECT_EQ("0\n0\n1\n2\n1\n", written(h, HistogramWriter::Format::Text));
+
+	// trimmed by epsilon on both ends
+	Histogram trimmed(1, 1.0);
+	trimmed.setEpsilon(0.01);
+	for (unsigned i = 0; i < 20; ++i)
+		trimmed += trimmed << 1;
+	ASSERT_LT(trimmed.windowSize(), trimmed.size());
+	ASSERT_GT(trimmed.size(), trimmed.windowOffset() + trimmed.windowSize());
+	const std::string text = written(trimmed, HistogramWriter::Format::Text);
+	EXPECT_EQ(trimmed.size(), std::size_t(std::count(text.begin(), text.end(), '\n')));
+	EXPECT_EQ("0\n", text.substr(text.size() - 2));
+}
+
+TEST(HistogramWriter_Test, T02_IndexedTextDoesNotDependOnWindow)
+{
+	EXPECT_EQ("2 1\n3 2\n4 1\n", written(windowed(), HistogramWriter::Format::IndexedText));
+
+	Histogram full(1, 1.0);
+	full += full << 1;
+	ASSERT_FALSE(full.isWindowed());
+	EXPECT_EQ("0 1\n1 1\n", written(full, HistogramWriter::Format::IndexedText));
+}
+
+TEST(HistogramWriter_Test, T03_BinaryHeaderCarriesAllBinsAndWindow)
+{
+	const Histogram h = windowed();
+	const std::string data = written(h, HistogramWriter::Format::Binary);
+
+	ASSERT_EQ(sizeof(HistogramFileHeader) + 3 * sizeof(double), data.size());
+	EXPECT_EQ(0, std::memcmp(data.data(), HistogramFileHeader::Magic, sizeof(HistogramFileHeader::Magic)));
+	EXPECT_EQ(5u, readLE64(data, offsetof(HistogramFileHeader, size)));
+	EXPECT_EQ(2u, readLE64(data, offsetof(HistogramFileHeader, offset)));
+	EXPECT_EQ(3u, readLE64(data, offsetof(HistogramFileHeader, count)));
+
+	double second;
+	std::memcpy(&second, data.data() + sizeof(HistogramFileHeader) + sizeof(double), sizeof(second));
+	EXPECT_EQ(2.0, second);
+}
+
+TEST(HistogramWriter_Test, T04_ExactTextFormats)
+{
+	ExactHistogram h(1, ExactHistogram::value_type(1));
+	h += h << 1;
+	h = h << 1;
+
+	EXPECT_EQ("0\n1\n1\n", written(h, HistogramWriter::Format::Text));
+	EXPECT_EQ("1 1\n2 1\n", written(h, HistogramWriter::Format::IndexedText));
+}
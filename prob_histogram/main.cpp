@@ -5,21 +5,148 @@
  *      Author: Krzysztof Lasota
  */
 
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
+#include <vector>
+
+#include <unistd.h>
 
 #include "histogram.hpp"
+#include "histogram_writer.hpp"
 
-int main(int argc, char** argv)
+static void printUsage(const char* appl)
+{
+	std::cerr << "Usage: " << appl << " [-b|-x] [-p] [-e EPS] [-c|-q P[,P...]] [N]\n"
+			"  N       number of histogram bins (default 1)\n"
+			"  -b      binary output (see HistogramFileHeader)\n"
+			"  -x      exact integer bins (text output only, not with -e)\n"
+			"  -p      probabilities instead of counts (not with -x)\n"
+			"  -e EPS  keep only bins holding at least EPS of total mass,\n"
+			"          printed as \"index value\" lines\n"
+			"  -c      cumulative distribution instead of bins\n"
+			"  -q P    print \"P index\" of quantile for every listed P\n";
+}
+
+struct Options
+{
+	HistogramWriter::Format format = HistogramWriter::Format::Text;
+	bool exact = false;
+	bool probability = false;
+	double epsilon = 0.0;
+	bool cumulative = false;
+	std::vector<double> quantiles;
+};
+
+static bool parseQuantiles(const char* arg, std::vector<double>& quantiles)
+{
+	char* end = nullptr;
+	do {
+		const double p = strtod(arg, &end);
+		if (end == arg || p < 0.0 || 1.0 < p)
+			return false;
+		quantiles.push_back(p);
+		arg = end + 1;
+	} while (*end == ',');
+
+	return *end == '\0';
+}
+
+template <typename H>
+static void printQuantiles(const H& h, const std::vector<double>& ps)
+{
+	const std::vector<typename H::size_type> idxs = h.quantiles(ps);
+
+	for (std::size_t i = 0; i < ps.size(); ++i)
+		std::printf("%g %zu\n", ps[i], static_cast<std::size_t>(idxs[i]));
+}
+
+template <typename H>
+static void normalizeRow(H&, const Options&)
+{
+}
+
+static void normalizeRow(Histogram& h, const Options& opts)
+{
+	if (opts.probability)
+		h *= 0.5;
+}
+
+template <typename H>
+static void printRow(unsigned n, const Options& opts)
 {
-	unsigned n = ((1<argc)?atoi(argv[1])-1:0);
-	double seed = 1;
-	Histogram h(1,seed);
+	const HistogramWriter::Format format =
+			(opts.format == HistogramWriter::Format::Text && opts.epsilon > 0.0)
+			? HistogramWriter::Format::IndexedText : opts.format;
+	typename H::value_type seed = 1;
+	H h(1,seed);
+	h.setEpsilon(opts.epsilon);
 
 	for (unsigned i = 0; i < n; ++i) {
 		h += h << 1;
+		normalizeRow(h, opts);
+	}
+
+	if (!opts.quantiles.empty()) {
+		printQuantiles(h, opts.quantiles);
+		return;
+	}
+	if (opts.cumulative)
+		h = h.prefixSum();
+
+	HistogramWriter writer(stdout, format);
+	writer.write(h);
+	if (format != HistogramWriter::Format::Binary)
+		writer.write("\n", 1);
+	writer.flush();
+}
+
+int main(int argc, char** argv)
+{
+	Options opts;
+
+	int opt;
+	while ((opt = getopt(argc, argv, "bxpe:cq:h")) != -1) {
+		switch (opt) {
+		case 'b':
+			opts.format = HistogramWriter::Format::Binary;
+			break;
+		case 'x':
+			opts.exact = true;
+			break;
+		case 'p':
+			opts.probability = true;
+			break;
+		case 'e':
+			opts.epsilon = atof(optarg);
+			break;
+		case 'c':
+			opts.cumulative = true;
+			break;
+		case 'q':
+			if (!parseQuantiles(optarg, opts.quantiles)) {
+				printUsage(argv[0]);
+				return EXIT_FAILURE;
+			}
+			break;
+		default:
+			printUsage(argv[0]);
+			return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
 	}
+	// trimming compounds on every row, exact bins would not be exact anymore
+	if (opts.exact && (opts.format == HistogramWriter::Format::Binary || opts.probability
+			|| opts.epsilon > 0.0)) {
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	unsigned n = ((optind<argc)?atoi(argv[optind])-1:0);
 
-	std::cout << h << std::endl;
+	if (opts.exact)
+		printRow<ExactHistogram>(n, opts);
+	else
+		printRow<Histogram>(n, opts);
 
 	return 0;
 }